@@ -125,6 +125,7 @@
 %catches(storage::DeviceHasWrongType, storage::NullPointerException) storage::to_xfs(const Device *device);
 
 %catches(storage::Exception) storage::Actiongraph::Actiongraph(const Storage &storage, const Devicegraph *lhs, Devicegraph *rhs);
+%catches(storage::Exception) storage::Actiongraph::Actiongraph(const Storage &storage, const Devicegraph *lhs, Devicegraph *rhs, const Actiongraph &previous);
 %catches(storage::Exception) storage::Actiongraph::write_graphviz(const std::string &filename, GraphvizFlags flags=GraphvizFlags::NONE) const;
 %catches(storage::AlignError) storage::Alignment::align(const Region &region, AlignPolicy align_policy=AlignPolicy::ALIGN_END) const;
 %catches(storage::WrongNumberOfChildren, storage::UnsupportedException) storage::BlkDevice::create_blk_filesystem(FsType fs_type);
@@ -156,6 +157,12 @@
 %catches(storage::DeviceNotFoundBySid) storage::Devicegraph::remove_device(sid_t sid);
 %catches(storage::Exception) storage::Devicegraph::save(const std::string &filename) const;
 %catches(storage::Exception) storage::Devicegraph::write_graphviz(const std::string &filename, GraphvizFlags graphviz_flags=GraphvizFlags::NONE) const;
+%catches(storage::DeviceNotFoundBySid) storage::DevicegraphDiff::get_changed_attributes(sid_t sid) const;
+%catches(storage::HolderNotFoundBySids) storage::DevicegraphDiff::get_changed_attributes(sid_t source_sid, sid_t target_sid) const;
+%catches(storage::Exception) storage::DevicegraphImage::DevicegraphImage(const std::string &filename);
+%catches(storage::DeviceNotFoundByName) storage::DevicegraphImage::find_by_name(const std::string &name) const;
+%catches(storage::DeviceNotFoundBySid) storage::DevicegraphImage::find_by_sid(sid_t sid) const;
+%catches(storage::Exception) storage::DevicegraphImage::write(const Devicegraph *devicegraph, const std::string &filename);
 %catches(storage::DeviceNotFound, storage::DeviceHasWrongType) storage::Disk::find_by_name(Devicegraph *devicegraph, const std::string &name);
 %catches(storage::DeviceNotFound, storage::DeviceHasWrongType) storage::Disk::find_by_name(const Devicegraph *devicegraph, const std::string &name);
 %catches(storage::DeviceNotFound, storage::DeviceHasWrongType) storage::DmRaid::find_by_name(Devicegraph *devicegraph, const std::string &name);
@@ -218,9 +225,11 @@
 %catches(storage::Exception) storage::Storage::Storage(const Environment &environment);
 %catches(storage::Exception) storage::Storage::activate(const ActivateCallbacks *activate_callbacks) const;
 %catches(storage::Exception) storage::Storage::calculate_actiongraph();
+%catches(storage::Exception) storage::Storage::calculate_actiongraph(bool incremental);
 %catches(storage::Exception) storage::Storage::check(const CheckCallbacks *check_callbacks=nullptr) const;
 %catches(storage::Exception) storage::Storage::commit(const CommitOptions &commit_options, const CommitCallbacks *commit_callbacks=nullptr);
 %catches(storage::Exception) storage::Storage::commit(const CommitCallbacks *commit_callbacks=nullptr);
+%catches(storage::Exception) storage::Storage::commit_parallel(const CommitOptions &commit_options, unsigned int parallelism, const CommitCallbacks *commit_callbacks=nullptr);
 %catches(storage::Exception) storage::Storage::copy_devicegraph(const std::string &source_name, const std::string &dest_name);
 %catches(storage::Exception) storage::Storage::create_devicegraph(const std::string &name);
 %catches(storage::Exception) storage::Storage::deactivate() const;
@@ -1,7 +1,11 @@
 
 %template(VectorString) std::vector<std::string>;
 %template(MapStringString) std::map<std::string, std::string>;
+%template(MapStringUnsignedLongLong) std::map<std::string, unsigned long long>;
 %template(PairBoolString) std::pair<bool, std::string>;
+%template(VectorUnsignedInt) std::vector<unsigned int>;
+%template(PairUnsignedIntUnsignedInt) std::pair<unsigned int, unsigned int>;
+%template(VectorPairUnsignedIntUnsignedInt) std::vector<std::pair<unsigned int, unsigned int>>;
 
 %template(VectorCompoundActionPtr) std::vector<CompoundAction*>;
 %template(VectorConstCompoundActionPtr) std::vector<const CompoundAction*>;
@@ -9,6 +13,8 @@
 %template(VectorDevicePtr) std::vector<Device*>;
 %template(VectorConstDevicePtr) std::vector<const Device*>;
 
+%template(VectorConstDevicegraphImageVertexPtr) std::vector<const DevicegraphImage::Vertex*>;
+
 %template(VectorBlkDevicePtr) std::vector<BlkDevice*>;
 %template(VectorConstBlkDevicePtr) std::vector<const BlkDevice*>;
 
@@ -8,6 +8,11 @@
 %ignore "clone";
 %ignore "operator <<";
 %ignore "get_all_if";
+%ignore "add_predicate";
+%ignore storage::DevicegraphView::DevicegraphView(const Devicegraph*, const std::vector<sid_t>&, DeviceFilter, HolderFilter);
+%ignore storage::DevicegraphImage::get_vertices;
+%ignore storage::DevicegraphImage::get_edges;
+%ignore storage::DevicegraphImage::get_out_edges;
 
 %rename("==") "operator==";
 %rename("!=") "operator!=";
@@ -20,6 +25,7 @@ use_ostream(storage::ResizeInfo);
 use_ostream(storage::ContentInfo);
 use_ostream(storage::SpaceInfo);
 use_ostream(storage::PartitionSlot);
+use_ostream(storage::MemoryUsage);
 
 // Since dynamic exception specifications are deprecated in C++11 we use the
 // SWIG %catches feature instead.
@@ -48,6 +54,8 @@ use_ostream(storage::PartitionSlot);
 #include "storage/Utils/Alignment.h"
 #include "storage/Utils/Remote.h"
 #include "storage/FreeInfo.h"
+#include "storage/MemoryUsage.h"
+#include "storage/DeviceQuery.h"
 #include "storage/UsedFeatures.h"
 
 #include "storage/Devices/Device.h"
@@ -104,6 +112,9 @@ use_ostream(storage::PartitionSlot);
 #include "storage/Graphviz.h"
 #include "storage/Devicegraph.h"
 #include "storage/Actiongraph.h"
+#include "storage/DevicegraphView.h"
+#include "storage/DevicegraphDiff.h"
+#include "storage/DevicegraphImage.h"
 #include "storage/Environment.h"
 #include "storage/CommitOptions.h"
 #include "storage/Storage.h"
@@ -127,6 +138,8 @@ use_ostream(storage::PartitionSlot);
 %include "../../storage/Utils/Alignment.h"
 %include "../../storage/Utils/Remote.h"
 %include "../../storage/FreeInfo.h"
+%include "../../storage/MemoryUsage.h"
+%include "../../storage/DeviceQuery.h"
 %include "../../storage/UsedFeatures.h"
 
 %include "../../storage/Devices/Device.h"
@@ -183,6 +196,9 @@ use_ostream(storage::PartitionSlot);
 %include "../../storage/Graphviz.h"
 %include "../../storage/Devicegraph.h"
 %include "../../storage/Actiongraph.h"
+%include "../../storage/DevicegraphView.h"
+%include "../../storage/DevicegraphDiff.h"
+%include "../../storage/DevicegraphImage.h"
 %include "../../storage/Environment.h"
 %include "../../storage/CommitOptions.h"
 %include "../../storage/Storage.h"
@@ -53,6 +53,49 @@ namespace storage
 	}
 
 
+	const Device*
+	Base::find_device(const Actiongraph::Impl& actiongraph, Side side) const
+	{
+	    if (side == RHS)
+		return find_rhs_device(actiongraph);
+
+	    const Devicegraph* devicegraph = actiongraph.get_devicegraph(LHS);
+
+	    if (resolved && devicegraph->get_impl().get_generation() == lhs_generation)
+		return lhs_device;
+
+	    return devicegraph->device_exists(sid) ? devicegraph->find_device(sid) : nullptr;
+	}
+
+
+	Device*
+	Base::find_rhs_device(const Actiongraph::Impl& actiongraph) const
+	{
+	    Devicegraph* devicegraph = actiongraph.get_devicegraph_rhs();
+
+	    if (resolved && devicegraph->get_impl().get_generation() == rhs_generation)
+		return rhs_device;
+
+	    return devicegraph->device_exists(sid) ? devicegraph->find_device(sid) : nullptr;
+	}
+
+
+	void
+	Base::resolve_devices(const Actiongraph::Impl& actiongraph)
+	{
+	    const Devicegraph* lhs = actiongraph.get_devicegraph(LHS);
+	    Devicegraph* rhs = actiongraph.get_devicegraph_rhs();
+
+	    lhs_device = lhs->device_exists(sid) ? lhs->find_device(sid) : nullptr;
+	    rhs_device = rhs->device_exists(sid) ? rhs->find_device(sid) : nullptr;
+
+	    lhs_generation = lhs->get_impl().get_generation();
+	    rhs_generation = rhs->get_impl().get_generation();
+
+	    resolved = true;
+	}
+
+
 	Text
 	Create::text(const CommitData& commit_data) const
 	{
@@ -132,6 +175,16 @@ namespace storage
 	}
 
 
+	double
+	Create::estimated_cost(const Actiongraph::Impl& actiongraph, const CommitCosts& commit_costs) const
+	{
+	    if (nop)
+		return 0.0;
+
+	    return get_device(actiongraph)->get_impl().do_create_cost(commit_costs);
+	}
+
+
 	void
 	Delete::add_dependencies(Actiongraph::Impl::vertex_descriptor vertex,
 				 Actiongraph::Impl& actiongraph) const
@@ -155,6 +208,23 @@ namespace storage
 	    }
 	}
 
+
+	double
+	Delete::estimated_cost(const Actiongraph::Impl& actiongraph, const CommitCosts& commit_costs) const
+	{
+	    if (nop)
+		return 0.0;
+
+	    return get_device(actiongraph)->get_impl().do_delete_cost(commit_costs);
+	}
+
+
+	Text
+	Barrier::text(const CommitData& commit_data) const
+	{
+	    return UntranslatedText("barrier");
+	}
+
     }
 
 }
@@ -46,7 +46,9 @@ namespace storage
 	public:
 
 	    Base(sid_t sid, bool only_sync, bool nop = false)
-		: sid(sid), first(false), last(false), only_sync(only_sync), nop(nop) {}
+		: sid(sid), first(false), last(false), only_sync(only_sync), nop(nop),
+		  lhs_device(nullptr), rhs_device(nullptr), lhs_generation(0), rhs_generation(0),
+		  resolved(false) {}
 
 	    virtual ~Base() {}
 
@@ -57,6 +59,15 @@ namespace storage
 	    virtual void add_dependencies(Actiongraph::Impl::vertex_descriptor vertex,
 					  Actiongraph::Impl& actiongraph) const {}
 
+	    /**
+	     * Estimated duration of the commit of the action in seconds, see
+	     * Actiongraph::estimate_commit(). Zero for actions doing no
+	     * operation.
+	     */
+	    virtual double estimated_cost(const Actiongraph::Impl& actiongraph,
+					  const CommitCosts& commit_costs) const
+		{ return nop ? 0.0 : commit_costs.other; }
+
 	    /**
 	     * Returns a string representing some information, sid and some
 	     * flags, of the action.
@@ -74,6 +85,37 @@ namespace storage
 	    // Action is only used to inform user but does no operation.
 	    bool nop;
 
+	    /**
+	     * Returns the device of the action on the LHS or RHS devicegraph
+	     * or null if it does not exist there. Uses the devices resolved
+	     * by resolve_devices() as long as the devicegraph has the same
+	     * generation, otherwise the device is looked up again.
+	     */
+	    const Device* find_device(const Actiongraph::Impl& actiongraph, Side side) const;
+	    Device* find_rhs_device(const Actiongraph::Impl& actiongraph) const;
+
+	    /**
+	     * Resolves the devices of the action on the LHS and RHS
+	     * devicegraph, done by Actiongraph::Impl::add_vertex(), so that
+	     * the get_device() functions need no lookup.
+	     */
+	    void resolve_devices(const Actiongraph::Impl& actiongraph);
+
+	private:
+
+	    // Removing devices from the devicegraphs, e.g. from staging while
+	    // the actiongraph is still used, destroys the devices. So the
+	    // devices are only valid for the generations of the devicegraphs
+	    // they were resolved for.
+
+	    const Device* lhs_device;
+	    Device* rhs_device;
+
+	    unsigned long long lhs_generation;
+	    unsigned long long rhs_generation;
+
+	    bool resolved;
+
 	};
 
 
@@ -90,11 +132,17 @@ namespace storage
 	    virtual void add_dependencies(Actiongraph::Impl::vertex_descriptor vertex,
 					  Actiongraph::Impl& actiongraph) const override;
 
+	    virtual double estimated_cost(const Actiongraph::Impl& actiongraph,
+					  const CommitCosts& commit_costs) const override;
+
 	    /**
 	     * Returns the device of the action on the RHS devicegraph.
 	     */
 	    Device* get_device(const Actiongraph::Impl& actiongraph) const
-		{ return actiongraph.get_devicegraph_rhs()->find_device(sid); }
+	    {
+		Device* device = find_rhs_device(actiongraph);
+		return device ? device : actiongraph.get_devicegraph_rhs()->find_device(sid);
+	    }
 
 	};
 
@@ -109,7 +157,10 @@ namespace storage
 	     * Returns the device of the action on the Lhs or RHS devicegraph. May not exist.
 	     */
 	    const Device* get_device(const Actiongraph::Impl& actiongraph, Side side) const
-		{ return actiongraph.get_devicegraph(side)->find_device(sid); }
+	    {
+		const Device* device = find_device(actiongraph, side);
+		return device ? device : actiongraph.get_devicegraph(side)->find_device(sid);
+	    }
 
 	};
 
@@ -143,11 +194,36 @@ namespace storage
 	    virtual void add_dependencies(Actiongraph::Impl::vertex_descriptor vertex,
 					  Actiongraph::Impl& actiongraph) const override;
 
+	    virtual double estimated_cost(const Actiongraph::Impl& actiongraph,
+					  const CommitCosts& commit_costs) const override;
+
 	    /**
 	     * Returns the device of the action on the LHS devicegraph.
 	     */
 	    const Device* get_device(const Actiongraph::Impl& actiongraph) const
-		{ return actiongraph.get_devicegraph(LHS)->find_device(sid); }
+	    {
+		const Device* device = find_device(actiongraph, LHS);
+		return device ? device : actiongraph.get_devicegraph(LHS)->find_device(sid);
+	    }
+
+	};
+
+
+	/**
+	 * Synchronization point between two groups of actions added by
+	 * Actiongraph::Impl::add_chain() instead of an edge from every
+	 * action of the first group to every action of the second group.
+	 * Unlike actions with only_sync it stays in the actiongraph but is
+	 * neither committed nor reported as a commit action.
+	 */
+	class Barrier : public Base
+	{
+	public:
+
+	    Barrier(sid_t sid) : Base(sid, false, true) {}
+
+	    virtual Text text(const CommitData& commit_data) const override;
+	    virtual void commit(CommitData& commit_data, const CommitOptions& commit_options) const override {}
 
 	};
 
@@ -186,6 +262,13 @@ namespace storage
 	return is_action_of_type<const Action::Delete>(action);
     }
 
+
+    inline bool
+    is_barrier(const Action::Base* action)
+    {
+	return is_action_of_type<const Action::Barrier>(action);
+    }
+
 }
 
 #endif
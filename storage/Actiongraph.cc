@@ -34,6 +34,13 @@ namespace storage
     }
 
 
+    Actiongraph::Actiongraph(const Storage& storage, const Devicegraph* lhs, Devicegraph* rhs,
+			     const Actiongraph& previous)
+	: impl(new Impl(storage, lhs, rhs, previous.get_impl()))
+    {
+    }
+
+
     Actiongraph::~Actiongraph()
     {
     }
@@ -87,6 +94,13 @@ namespace storage
     }
 
 
+    CommitEstimate
+    Actiongraph::estimate_commit(const CommitCosts& commit_costs) const
+    {
+	return get_impl().estimate_commit(commit_costs);
+    }
+
+
     void
     Actiongraph::generate_compound_actions()
     {
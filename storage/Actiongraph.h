@@ -52,6 +52,86 @@ namespace storage
     };
 
 
+    /**
+     * Estimated durations in seconds of the operations done during
+     * commit, used by Actiongraph::estimate_commit(). The defaults are
+     * rough values for local disks. They can be calibrated from the
+     * durations of the actions of earlier commits found in the log.
+     */
+    class CommitCosts
+    {
+    public:
+
+	CommitCosts()
+	    : parted(0.5), udevadm_settle(0.5), mkfs(1.0), mkfs_per_gib(0.05), lvm(0.5),
+	      cryptsetup(2.0), mount(0.2), other(0.1) {}
+
+	/**
+	 * One call of parted.
+	 */
+	double parted;
+
+	/**
+	 * Waiting for udev after the kernel picked up a change.
+	 */
+	double udevadm_settle;
+
+	/**
+	 * Creating a filesystem, fixed part and part per GiB of size.
+	 */
+	double mkfs;
+	double mkfs_per_gib;
+
+	/**
+	 * One call of an LVM command.
+	 */
+	double lvm;
+
+	/**
+	 * One call of cryptsetup, dominated by the key derivation.
+	 */
+	double cryptsetup;
+
+	/**
+	 * Mounting or unmounting.
+	 */
+	double mount;
+
+	/**
+	 * Everything else, e.g. updating /etc/fstab.
+	 */
+	double other;
+
+    };
+
+
+    /**
+     * Estimate of the duration of a commit, see
+     * Actiongraph::estimate_commit().
+     */
+    struct CommitEstimate
+    {
+	/**
+	 * Sum of the costs of all actions.
+	 */
+	double total_work = 0.0;
+
+	/**
+	 * Sum of the costs along the most expensive chain of dependent
+	 * actions. No commit can be faster, however many actions run in
+	 * parallel.
+	 */
+	double critical_path = 0.0;
+
+	/**
+	 * Ratio of total work and critical path, so the average number of
+	 * actions running at the same time if the commit takes as long as
+	 * the critical path. One for an empty actiongraph.
+	 */
+	double parallelism = 1.0;
+    };
+
+
     class Actiongraph : private boost::noncopyable
     {
     public:
@@ -61,6 +141,19 @@ namespace storage
 	 */
 	Actiongraph(const Storage& storage, const Devicegraph* lhs, Devicegraph* rhs);
 
+	/**
+	 * Calculates the actiongraph reusing the actions of previous for
+	 * the devices not affected by the changes of rhs since previous
+	 * was calculated. The result is the same as calculated from
+	 * scratch, apart from the order of independent actions. Falls back
+	 * to a calculation from scratch if previous was calculated for
+	 * other devicegraphs or lhs changed.
+	 *
+	 * @throw Exception
+	 */
+	Actiongraph(const Storage& storage, const Devicegraph* lhs, Devicegraph* rhs,
+		    const Actiongraph& previous);
+
 	~Actiongraph();
 
 	const Storage& get_storage() const;
@@ -89,6 +182,12 @@ namespace storage
 	// TODO add Action to the public interface and use get_commit_actions instead
 	std::vector<std::string> get_commit_actions_as_strings() const;
 
+	/**
+	 * Estimates the duration of the commit from the costs of the
+	 * actions.
+	 */
+	CommitEstimate estimate_commit(const CommitCosts& commit_costs = CommitCosts()) const;
+
 	void generate_compound_actions();
 	std::vector<const CompoundAction*> get_compound_actions() const;
 
@@ -21,6 +21,7 @@
  */
 
 
+#include <unordered_map>
 #include <boost/graph/copy.hpp>
 #include <boost/graph/topological_sort.hpp>
 #include <boost/graph/transitive_reduction.hpp>
@@ -28,12 +29,16 @@
 #include <boost/graph/graphviz.hpp>
 
 #include "storage/Utils/Stopwatch.h"
+#include "storage/Utils/Parallel.h"
 #include "storage/Devices/DeviceImpl.h"
 #include "storage/Devices/BlkDevice.h"
 #include "storage/Devices/PartitionTableImpl.h"
+#include "storage/Devices/Partitionable.h"
+#include "storage/Devices/Partition.h"
 #include "storage/Filesystems/BlkFilesystemImpl.h"
 #include "storage/Filesystems/MountPointImpl.h"
 #include "storage/Devicegraph.h"
+#include "storage/DevicegraphDiffImpl.h"
 #include "storage/Utils/GraphUtils.h"
 #include "storage/Action.h"
 #include "storage/Actiongraph.h"
@@ -126,10 +131,52 @@ namespace storage
     {
 	CheckCallbacksLogger check_callbacks_logger;
 
-	storage.check(&check_callbacks_logger);
+	// Only check what changed since the last check, e.g. by the last
+	// actiongraph. Storage::check() still does a full check.
+
+	storage.get_impl().check_incremental(&check_callbacks_logger);
 
 	Stopwatch stopwatch;
 
+	calculate();
+
+	y2mil("stopwatch " << stopwatch << " for actiongraph generation");
+    }
+
+
+    Actiongraph::Impl::Impl(const Storage& storage, const Devicegraph* lhs, Devicegraph* rhs,
+			    const Impl& previous)
+	: storage(storage), lhs(lhs), rhs(rhs)
+    {
+	CheckCallbacksLogger check_callbacks_logger;
+
+	storage.get_impl().check_incremental(&check_callbacks_logger);
+
+	Stopwatch stopwatch;
+
+	if (!calculate_incremental(previous))
+	{
+	    y2mil("incremental actiongraph generation not possible");
+
+	    graph.clear();
+	    reused_vertices.clear();
+	    num_barriers = 0;
+
+	    calculate();
+	}
+
+	y2mil("stopwatch " << stopwatch << " for actiongraph generation");
+    }
+
+
+    void
+    Actiongraph::Impl::calculate()
+    {
+	const size_t num_sid_indexes = rhs->get_impl().num_devices() + lhs->get_impl().num_devices();
+
+	cache_for_actions_with_sid.assign(num_sid_indexes, vector<vertex_descriptor>());
+	last_action_on_partition_table.assign(num_sid_indexes, graph_t::null_vertex());
+
 	get_actions();
 	set_special_actions();
 	add_dependencies();
@@ -137,7 +184,170 @@ namespace storage
 
 	calculate_order();
 
-	y2mil("stopwatch " << stopwatch << " for actiongraph generation");
+	clear_changes();
+    }
+
+
+    bool
+    Actiongraph::Impl::calculate_incremental(const Impl& previous)
+    {
+	const Devicegraph::Impl& lhs_impl = lhs->get_impl();
+	const Devicegraph::Impl& rhs_impl = rhs->get_impl();
+
+	if (previous.lhs != lhs || previous.rhs != rhs)
+	    return false;
+
+	if (lhs_impl.is_changed_all() || lhs_impl.get_changes_epoch() != previous.lhs_changes_epoch ||
+	    !lhs_impl.get_changed_sids().empty())
+	    return false;
+
+	if (rhs_impl.is_changed_all() || rhs_impl.get_changes_epoch() != previous.rhs_changes_epoch)
+	    return false;
+
+	const std::unordered_set<sid_t> affected_sids = get_affected_sids(rhs_impl.get_changed_sids());
+
+	// The actions of other devices only get a dependency on the action
+	// mounting the root filesystem when they are calculated.
+
+	if (previous.mount_root_filesystem != previous.vertices().end() &&
+	    affected_sids.count(previous[*previous.mount_root_filesystem]->sid) != 0)
+	    return false;
+
+	const size_t num_sid_indexes = rhs_impl.num_devices() + lhs_impl.num_devices();
+
+	cache_for_actions_with_sid.assign(num_sid_indexes, vector<vertex_descriptor>());
+	last_action_on_partition_table.assign(num_sid_indexes, graph_t::null_vertex());
+
+	// Take over the actions of unaffected devices together with their
+	// dependencies. The actions are shared with the previous actiongraph
+	// since they are not modified after the calculation.
+
+	std::unordered_map<vertex_descriptor, vertex_descriptor> reused;
+
+	// The side tables of previous are indexed by the sid indexes of the
+	// devicegraphs when previous was calculated. Adding or removing
+	// devices since then changed the sid indexes, so the last actions on
+	// the partition tables are only identified by their vertices.
+
+	const std::unordered_set<vertex_descriptor> last_actions_on_partition_tables(
+	    previous.last_action_on_partition_table.begin(), previous.last_action_on_partition_table.end());
+
+	for (vertex_descriptor old_vertex : previous.vertices())
+	{
+	    const shared_ptr<Action::Base>& action = previous.graph[old_vertex];
+	    if (affected_sids.count(action->sid) != 0)
+		continue;
+
+	    // The devices of the action were resolved for the devicegraphs
+	    // when previous was calculated. Resolving them again only
+	    // updates the cache, the actions of previous resolve their
+	    // devices the same way.
+
+	    action->resolve_devices(*this);
+
+	    vertex_descriptor vertex = boost::add_vertex(action, graph);
+
+	    reused[old_vertex] = vertex;
+	    reused_vertices.insert(vertex);
+
+	    if (is_barrier(action.get()))
+		++num_barriers;
+
+	    if (last_actions_on_partition_tables.count(old_vertex) != 0)
+	    {
+		const Device* device = action->find_rhs_device(*this);
+		if (!device)
+		    device = action->find_device(*this, LHS);
+
+		sid_t sid = to_partition(device)->get_partition_table()->get_sid();
+		set_last_action_on_partition_table(sid, vertex);
+	    }
+	}
+
+	for (vertex_descriptor old_vertex : previous.vertices())
+	{
+	    std::unordered_map<vertex_descriptor, vertex_descriptor>::const_iterator it1 = reused.find(old_vertex);
+	    if (it1 == reused.end())
+		continue;
+
+	    for (vertex_descriptor old_child : previous.children(old_vertex))
+	    {
+		std::unordered_map<vertex_descriptor, vertex_descriptor>::const_iterator it2 = reused.find(old_child);
+		if (it2 != reused.end())
+		    add_edge(it1->second, it2->second);
+	    }
+	}
+
+	vector<sid_t> sids(affected_sids.begin(), affected_sids.end());
+	sort(sids.begin(), sids.end());
+
+	get_actions(sids);
+	set_special_actions();
+
+	if (mount_root_filesystem != vertices().end() && !is_reused(*mount_root_filesystem))
+	    return false;
+
+	add_dependencies(sids);
+	remove_only_syncs();
+
+	calculate_order();
+
+	clear_changes();
+
+	y2mil("reused " << reused.size() << " of " << previous.num_actions() << " actions");
+
+	return true;
+    }
+
+
+    void
+    Actiongraph::Impl::clear_changes()
+    {
+	const Devicegraph::Impl& lhs_impl = lhs->get_impl();
+	const Devicegraph::Impl& rhs_impl = rhs->get_impl();
+
+	lhs_impl.clear_changes();
+	rhs_impl.clear_changes();
+
+	lhs_changes_epoch = lhs_impl.get_changes_epoch();
+	rhs_changes_epoch = rhs_impl.get_changes_epoch();
+    }
+
+
+    std::unordered_set<sid_t>
+    Actiongraph::Impl::get_affected_sids(const std::unordered_set<sid_t>& changed_sids) const
+    {
+	std::unordered_set<sid_t> ret(changed_sids.begin(), changed_sids.end());
+
+	vector<sid_t> todo(changed_sids.begin(), changed_sids.end());
+
+	const Devicegraph* devicegraphs[] = { lhs, rhs };
+
+	while (!todo.empty())
+	{
+	    const sid_t sid = todo.back();
+	    todo.pop_back();
+
+	    for (const Devicegraph* devicegraph : devicegraphs)
+	    {
+		const Devicegraph::Impl& devicegraph_impl = devicegraph->get_impl();
+
+		if (!devicegraph_impl.device_exists(sid))
+		    continue;
+
+		Devicegraph::Impl::vertex_descriptor vertex = devicegraph_impl.find_vertex(sid);
+
+		for (Devicegraph::Impl::vertex_descriptor tmp : devicegraph_impl.children(vertex))
+		    if (ret.insert(devicegraph_impl[tmp]->get_sid()).second)
+			todo.push_back(devicegraph_impl[tmp]->get_sid());
+
+		for (Devicegraph::Impl::vertex_descriptor tmp : devicegraph_impl.parents(vertex))
+		    if (ret.insert(devicegraph_impl[tmp]->get_sid()).second)
+			todo.push_back(devicegraph_impl[tmp]->get_sid());
+	    }
+	}
+
+	return ret;
     }
 
 
@@ -158,13 +368,15 @@ namespace storage
     size_t
     Actiongraph::Impl::num_actions() const
     {
-	return boost::num_vertices(graph);
+	return boost::num_vertices(graph) - num_barriers;
     }
 
 
     Actiongraph::Impl::vertex_descriptor
     Actiongraph::Impl::add_vertex(Action::Base* action)
     {
+	action->resolve_devices(*this);
+
 	return boost::add_vertex(shared_ptr<Action::Base>(action), graph);
     }
 
@@ -222,22 +434,55 @@ namespace storage
 	    if (!vector.empty())
 		non_empty_vectors.push_back(vector);
 
-	if (non_empty_vectors.size() > 1)
-	    for (size_t i = 1; i < non_empty_vectors.size(); ++i)
-		// As an alternative implementation, we could add sync actions
-		// here instead of creating all the edges right away
-		for (vertex_descriptor left : non_empty_vectors[i - 1])
-		    for (vertex_descriptor right : non_empty_vectors[i])
+	for (size_t i = 1; i < non_empty_vectors.size(); ++i)
+	{
+	    const vector<vertex_descriptor>& lefts = non_empty_vectors[i - 1];
+	    const vector<vertex_descriptor>& rights = non_empty_vectors[i];
+
+	    if (lefts.size() * rights.size() <= lefts.size() + rights.size())
+	    {
+		for (vertex_descriptor left : lefts)
+		    for (vertex_descriptor right : rights)
 			add_edge(left, right);
+	    }
+	    else
+	    {
+		vertex_descriptor barrier = add_vertex(new Action::Barrier(graph[lefts.front()]->sid));
+		++num_barriers;
+
+		for (vertex_descriptor left : lefts)
+		    add_edge(left, barrier);
+
+		for (vertex_descriptor right : rights)
+		    add_edge(barrier, right);
+	    }
+	}
+    }
+
+
+    size_t
+    Actiongraph::Impl::get_sid_index(sid_t sid) const
+    {
+	const Devicegraph::Impl& rhs_impl = rhs->get_impl();
+
+	size_t local_index = rhs_impl.get_local_index(sid);
+	if (local_index != Devicegraph::Impl::npos)
+	    return local_index;
+
+	local_index = lhs->get_impl().get_local_index(sid);
+	if (local_index != Devicegraph::Impl::npos)
+	    return rhs_impl.num_devices() + local_index;
+
+	return Devicegraph::Impl::npos;
     }
 
 
     const vector<Actiongraph::Impl::vertex_descriptor>&
     Actiongraph::Impl::actions_with_sid(sid_t sid) const
     {
-	map<sid_t, vector<vertex_descriptor>>::const_iterator it = cache_for_actions_with_sid.find(sid);
-	if (it != cache_for_actions_with_sid.end())
-	    return it->second;
+	size_t sid_index = get_sid_index(sid);
+	if (sid_index != Devicegraph::Impl::npos)
+	    return cache_for_actions_with_sid[sid_index];
 
 	const static vector<vertex_descriptor> empty;
 	return empty;
@@ -290,50 +535,68 @@ namespace storage
     void
     Actiongraph::Impl::get_actions()
     {
-	const set<sid_t> lhs_sids = lhs->get_impl().get_device_sids();
-	const set<sid_t> rhs_sids = rhs->get_impl().get_device_sids();
-
-	vector<sid_t> created_sids;
-	set_difference(rhs_sids.begin(), rhs_sids.end(), lhs_sids.begin(), lhs_sids.end(),
-		       back_inserter(created_sids));
+	const Devicegraph::Impl& lhs_impl = lhs->get_impl();
+	const Devicegraph::Impl& rhs_impl = rhs->get_impl();
 
-	vector<sid_t> common_sids;
-	set_intersection(lhs_sids.begin(), lhs_sids.end(), rhs_sids.begin(), rhs_sids.end(),
-			 back_inserter(common_sids));
+	const DevicegraphDiff::Impl devicegraph_diff(lhs_impl, rhs_impl);
 
-	vector<sid_t> deleted_sids;
-	set_difference(lhs_sids.begin(), lhs_sids.end(), rhs_sids.begin(), rhs_sids.end(),
-		       back_inserter(deleted_sids));
-
-	for (sid_t sid : created_sids)
+	for (const DevicegraphDiff::Impl::DeviceEntry& device_entry : devicegraph_diff.get_created_devices())
 	{
-	    Devicegraph::Impl::vertex_descriptor v_rhs = rhs->get_impl().find_vertex(sid);
-	    const Device* d_rhs = rhs->get_impl()[v_rhs];
+	    const Device* d_rhs = rhs_impl[device_entry.rhs_vertex];
 
 	    d_rhs->get_impl().add_create_actions(*this);
 	}
 
-	for (sid_t sid : common_sids)
+	for (const DevicegraphDiff::Impl::DeviceEntry& device_entry : devicegraph_diff.get_common_devices())
 	{
-	    Devicegraph::Impl::vertex_descriptor v_lhs = lhs->get_impl().find_vertex(sid);
-	    const Device* d_lhs = lhs->get_impl()[v_lhs];
-
-	    Devicegraph::Impl::vertex_descriptor v_rhs = rhs->get_impl().find_vertex(sid);
-	    const Device* d_rhs = rhs->get_impl()[v_rhs];
+	    const Device* d_lhs = lhs_impl[device_entry.lhs_vertex];
+	    const Device* d_rhs = rhs_impl[device_entry.rhs_vertex];
 
 	    d_rhs->get_impl().add_modify_actions(*this, d_lhs);
 	}
 
-	for (sid_t sid : deleted_sids)
+	for (const DevicegraphDiff::Impl::DeviceEntry& device_entry : devicegraph_diff.get_deleted_devices())
 	{
-	    Devicegraph::Impl::vertex_descriptor v_lhs = lhs->get_impl().find_vertex(sid);
-	    const Device* d_lhs = lhs->get_impl()[v_lhs];
+	    const Device* d_lhs = lhs_impl[device_entry.lhs_vertex];
 
 	    d_lhs->get_impl().add_delete_actions(*this);
 	}
     }
 
 
+    void
+    Actiongraph::Impl::get_actions(const vector<sid_t>& sids)
+    {
+	const Devicegraph::Impl& lhs_impl = lhs->get_impl();
+	const Devicegraph::Impl& rhs_impl = rhs->get_impl();
+
+	// same order as get_actions() for all devices
+
+	for (sid_t sid : sids)
+	{
+	    if (!lhs_impl.device_exists(sid) && rhs_impl.device_exists(sid))
+		rhs_impl[rhs_impl.find_vertex(sid)]->get_impl().add_create_actions(*this);
+	}
+
+	for (sid_t sid : sids)
+	{
+	    if (lhs_impl.device_exists(sid) && rhs_impl.device_exists(sid))
+	    {
+		const Device* d_lhs = lhs_impl[lhs_impl.find_vertex(sid)];
+		const Device* d_rhs = rhs_impl[rhs_impl.find_vertex(sid)];
+
+		d_rhs->get_impl().add_modify_actions(*this, d_lhs);
+	    }
+	}
+
+	for (sid_t sid : sids)
+	{
+	    if (lhs_impl.device_exists(sid) && !rhs_impl.device_exists(sid))
+		lhs_impl[lhs_impl.find_vertex(sid)]->get_impl().add_delete_actions(*this);
+	}
+    }
+
+
     void
     Actiongraph::Impl::set_special_actions()
     {
@@ -345,20 +608,49 @@ namespace storage
 	{
 	    const Action::Base* action = graph[*it].get();
 
+	    // barriers of reused actions, see calculate_incremental()
+
+	    if (is_barrier(action))
+		continue;
+
 	    const Action::Mount* mount = dynamic_cast<const Action::Mount*>(action);
 	    if (mount && mount->get_path(*this) == "/")
 		mount_root_filesystem = it;
 
-	    cache_for_actions_with_sid[action->sid].push_back(*it);
+	    size_t sid_index = get_sid_index(action->sid);
+	    if (sid_index == Devicegraph::Impl::npos)
+		ST_THROW(LogicException(sformat("action with unknown sid %d", action->sid)));
+
+	    cache_for_actions_with_sid[sid_index].push_back(*it);
 	}
     }
 
 
+    Actiongraph::Impl::vertex_descriptor
+    Actiongraph::Impl::get_last_action_on_partition_table(sid_t sid) const
+    {
+	size_t sid_index = get_sid_index(sid);
+	if (sid_index == Devicegraph::Impl::npos)
+	    return graph_t::null_vertex();
+
+	return last_action_on_partition_table[sid_index];
+    }
+
+
     void
-    Actiongraph::Impl::add_dependencies()
+    Actiongraph::Impl::set_last_action_on_partition_table(sid_t sid, vertex_descriptor vertex)
     {
-	vector<vertex_descriptor> mounts;
+	size_t sid_index = get_sid_index(sid);
+	if (sid_index == Devicegraph::Impl::npos)
+	    ST_THROW(LogicException(sformat("partition table with unknown sid %d", sid)));
+
+	last_action_on_partition_table[sid_index] = vertex;
+    }
 
+
+    void
+    Actiongraph::Impl::add_dependencies()
+    {
 	// TODO also for Devices only in LHS?
 
 	const Devicegraph* devicegraph = get_devicegraph(RHS);
@@ -370,11 +662,36 @@ namespace storage
 	    device->get_impl().add_dependencies(*this);
 	}
 
+	add_action_dependencies();
+    }
+
+
+    void
+    Actiongraph::Impl::add_dependencies(const vector<sid_t>& sids)
+    {
+	const Devicegraph::Impl& rhs_impl = rhs->get_impl();
+
+	for (sid_t sid : sids)
+	{
+	    if (rhs_impl.device_exists(sid))
+		rhs_impl[rhs_impl.find_vertex(sid)]->get_impl().add_dependencies(*this);
+	}
+
+	add_action_dependencies();
+    }
+
+
+    void
+    Actiongraph::Impl::add_action_dependencies()
+    {
+	vector<vertex_descriptor> mounts;
+
 	PartitionTable::Impl::run_dependency_manager(*this);
 
 	for (vertex_descriptor vertex : vertices())
 	{
-	    graph[vertex]->add_dependencies(vertex, *this);
+	    if (!is_reused(vertex))
+		graph[vertex]->add_dependencies(vertex, *this);
 
 	    const Action::Mount* mount = dynamic_cast<const Action::Mount*>(graph[vertex].get());
 	    if (mount && mount->get_path(*this) != "swap")
@@ -390,7 +707,16 @@ namespace storage
 		return ml->get_path(*this) <= mr->get_path(*this);
 	    });
 
-	    add_chain(mounts);
+	    // Reused mounts are still in the same order so the only edges
+	    // missing are those to new mounts and those bridging removed
+	    // mounts.
+
+	    for (size_t i = 1; i < mounts.size(); ++i)
+	    {
+		if (!is_reused(mounts[i - 1]) || !is_reused(mounts[i]) ||
+		    !boost::edge(mounts[i - 1], mounts[i], graph).second)
+		    add_edge(mounts[i - 1], mounts[i]);
+	    }
 	}
 
 	add_special_dasd_pt_dependencies();
@@ -412,6 +738,9 @@ namespace storage
 
 	for (vertex_descriptor vertex : vertices())
 	{
+	    if (is_reused(vertex))
+		continue;
+
 	    const Action::Mount* mount = dynamic_cast<const Action::Mount*>(graph[vertex].get());
 	    if (!mount)
 		continue;
@@ -440,12 +769,11 @@ namespace storage
 		if (partition_table->get_type() != PtType::DASD)
 		    continue;
 
-		map<sid_t, vertex_descriptor>::const_iterator it1 =
-		    last_action_on_partition_table.find(partition_table->get_sid());
-		if (it1 == last_action_on_partition_table.end())
+		vertex_descriptor last_action = get_last_action_on_partition_table(partition_table->get_sid());
+		if (last_action == graph_t::null_vertex())
 		    continue;
 
-		add_edge(it1->second, vertex);
+		add_edge(last_action, vertex);
 	    }
 	}
     }
@@ -499,7 +827,8 @@ namespace storage
 	for (const vertex_descriptor& vertex : order)
 	{
 	    const Action::Base* action = graph[vertex].get();
-	    cout << action->text(commit_data).native << '\n';
+	    if (!is_barrier(action))
+		cout << action->text(commit_data).native << '\n';
 	}
 
 	cout << '\n';
@@ -515,23 +844,157 @@ namespace storage
 	{
 	    const Action::Base* action = graph[vertex].get();
 
-	    commit_actions.push_back(action);
+	    if (!is_barrier(action))
+		commit_actions.push_back(action);
 	}
 
 	return commit_actions;
     }
 
 
+    CommitEstimate
+    Actiongraph::Impl::estimate_commit(const CommitCosts& commit_costs) const
+    {
+	CommitEstimate commit_estimate;
+
+	// The finish times of the actions if every action starts as soon as
+	// all its parents are done. The order is a topological order so the
+	// parents are always already handled.
+
+	std::unordered_map<vertex_descriptor, double> finish;
+
+	for (vertex_descriptor vertex : order)
+	{
+	    double start = 0.0;
+	    for (vertex_descriptor parent : parents(vertex))
+		start = max(start, finish[parent]);
+
+	    double cost = graph[vertex]->estimated_cost(*this, commit_costs);
+
+	    finish[vertex] = start + cost;
+
+	    commit_estimate.total_work += cost;
+	    commit_estimate.critical_path = max(commit_estimate.critical_path, finish[vertex]);
+	}
+
+	if (commit_estimate.critical_path > 0.0)
+	    commit_estimate.parallelism = commit_estimate.total_work / commit_estimate.critical_path;
+
+	y2mil("commit estimate total-work:" << commit_estimate.total_work << " critical-path:" <<
+	      commit_estimate.critical_path << " parallelism:" << commit_estimate.parallelism);
+
+	return commit_estimate;
+    }
+
+
+    namespace
+    {
+
+	/**
+	 * Sets the keys for the access an action needs during commit.
+	 * Actions on a partitionable, its partition table and its partitions
+	 * get the sid of the partitionable as exclusive key since e.g. parted
+	 * must not run several times for the same disk. Otherwise the sids
+	 * of the partitionables the device is on are shared keys, so e.g.
+	 * mkfs on several partitions of a disk can run at the same time but
+	 * not while parted or BLKRRPART runs for the disk.
+	 */
+	void
+	get_keys(const Actiongraph::Impl& actiongraph, const Action::Base* action,
+		 vector<size_t>& exclusive_keys, vector<size_t>& shared_keys)
+	{
+	    if (is_barrier(action))
+		return;
+
+	    const Device* device = action->find_rhs_device(actiongraph);
+	    if (!device)
+		device = action->find_device(actiongraph, LHS);
+	    if (!device)
+		return;
+
+	    const Device* partitionable = nullptr;
+
+	    if (is_partition(device))
+		partitionable = to_partition(device)->get_partitionable();
+	    else if (is_partition_table(device))
+		partitionable = to_partition_table(device)->get_partitionable();
+	    else if (is_partitionable(device))
+		partitionable = device;
+
+	    if (partitionable)
+		exclusive_keys.push_back(partitionable->get_sid());
+
+	    for (const Device* ancestor : device->get_ancestors(true))
+	    {
+		if (is_partitionable(ancestor) && ancestor != partitionable)
+		    shared_keys.push_back(ancestor->get_sid());
+	    }
+	}
+
+    }
+
+
     void
-    Actiongraph::Impl::commit(const CommitOptions& commit_options, const CommitCallbacks* commit_callbacks) const
+    Actiongraph::Impl::commit(const CommitOptions& commit_options, unsigned int parallelism,
+			      const CommitCallbacks* commit_callbacks) const
     {
-	y2mil("commit begin");
+	y2mil("commit begin parallelism:" << parallelism);
 
 	CommitData commit_data(*this, Tense::PRESENT_CONTINUOUS);
 
-	for (const vertex_descriptor& vertex : order)
+	// The tasks for parallel_for_dag() are the actions in the sorted
+	// order, so with a parallelism of one the actions run in that order.
+
+	const vector<vertex_descriptor> actions(order.begin(), order.end());
+
+	std::unordered_map<vertex_descriptor, size_t> positions;
+	for (size_t position = 0; position < actions.size(); ++position)
+	    positions[actions[position]] = position;
+
+	vector<vector<size_t>> successors(actions.size());
+	vector<vector<size_t>> exclusive_keys(actions.size());
+	vector<vector<size_t>> shared_keys(actions.size());
+
+	for (size_t position = 0; position < actions.size(); ++position)
 	{
-	    const Action::Base* action = graph[vertex].get();
+	    for (vertex_descriptor child : children(actions[position]))
+		successors[position].push_back(positions[child]);
+
+	    get_keys(*this, graph[actions[position]].get(), exclusive_keys[position], shared_keys[position]);
+	}
+
+	// With several threads the actions starting the most expensive
+	// chains of actions run first. The priority of an action is its
+	// estimated cost plus the highest priority of its children. The
+	// children always have a higher position.
+
+	vector<double> priorities;
+
+	if (parallelism > 1)
+	{
+	    const CommitCosts commit_costs;
+
+	    priorities.resize(actions.size());
+
+	    for (size_t position = actions.size(); position-- > 0;)
+	    {
+		double tmp = 0.0;
+		for (size_t successor : successors[position])
+		    tmp = max(tmp, priorities[successor]);
+
+		priorities[position] = graph[actions[position]]->estimated_cost(*this, commit_costs) + tmp;
+	    }
+	}
+
+	// Messages, errors and all other work except waiting for commands
+	// are serialized by parallel_for_dag().
+
+	parallel_for_dag(successors, exclusive_keys, shared_keys, priorities, parallelism, [&](size_t position) {
+
+	    const Action::Base* action = graph[actions[position]].get();
+
+	    if (is_barrier(action))
+		return;
 
 	    Text text = action->text(commit_data);
 
@@ -543,7 +1006,7 @@ namespace storage
 	    }
 
 	    if (action->nop)
-		continue;
+		return;
 
 	    try
 	    {
@@ -558,7 +1021,8 @@ namespace storage
 
 		y2mil("user decides to continue after error");
 	    }
-	}
+
+	});
 
 	y2mil("commit end");
     }
@@ -633,6 +1097,12 @@ namespace storage
 	    {
 		const Action::Base* action = commit_data.actiongraph[vertex];
 
+		if (is_barrier(action))
+		{
+		    out << "[ label=\"\", shape=point ]";
+		    return;
+		}
+
 		string label = action->text(commit_data).translated;
 		string tooltip = action->text(commit_data).translated;
 
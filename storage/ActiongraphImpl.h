@@ -28,6 +28,7 @@
 #include <deque>
 #include <map>
 #include <memory>
+#include <unordered_set>
 #include <boost/noncopyable.hpp>
 #include <boost/graph/adjacency_list.hpp>
 
@@ -114,6 +115,16 @@ namespace storage
 
 	Impl(const Storage& storage, const Devicegraph* lhs, Devicegraph* rhs);
 
+	/**
+	 * Calculates the actiongraph reusing the actions of previous, see
+	 * Actiongraph::Actiongraph(). Actions and dependencies are only
+	 * calculated for the devices connected in lhs or rhs to a device
+	 * changed in rhs since previous was calculated. Falls back to a
+	 * full calculation if the changes since previous are unknown, lhs
+	 * changed or the action mounting the root filesystem is affected.
+	 */
+	Impl(const Storage& storage, const Devicegraph* lhs, Devicegraph* rhs, const Impl& previous);
+
 	const Storage& get_storage() const { return storage; }
 
 	const Devicegraph* get_devicegraph(Side side) const { return side == LHS ? lhs : rhs; }
@@ -147,14 +158,24 @@ namespace storage
 	/**
 	 * Adds several edges (dependencies) to the graph, linking groups of
 	 * actions in the given order. Thus, every action from the first vector
-	 * will have an edge to every action from the second vector and so on.
+	 * must be done before every action from the second vector and so on.
 	 *
-	 * By definition, the cost of this function is O(n^3). Although
-	 * creating edges is not an expensive operation, take that cost into
-	 * account when creating edges massively.
+	 * Between two groups where that needs fewer edges a barrier action
+	 * is added with an edge from every action of the first group and to
+	 * every action of the second group. So the number of edges is linear
+	 * in the number of actions.
 	 */
 	void add_chain(const vector<vector<vertex_descriptor>>& actions);
 
+	/**
+	 * Dense index over the sids of the devices in the rhs and lhs
+	 * devicegraphs: The local index in rhs or, for devices only in lhs,
+	 * the number of devices in rhs plus the local index in lhs. Used to
+	 * index side tables that are plain vectors. Returns
+	 * Devicegraph::Impl::npos for unknown sids.
+	 */
+	size_t get_sid_index(sid_t sid) const;
+
 	const vector<vertex_descriptor>& actions_with_sid(sid_t sid) const;
 	vector<vertex_descriptor> actions_with_sid(sid_t sid, ActionsFilter actions_filter) const;
 
@@ -172,20 +193,56 @@ namespace storage
 	void print_order() const;
 
 	vector<const Action::Base*> get_commit_actions() const;
-	void commit(const CommitOptions& commit_options, const CommitCallbacks* commit_callbacks) const;
+	void commit(const CommitOptions& commit_options, unsigned int parallelism,
+		    const CommitCallbacks* commit_callbacks) const;
+
+	CommitEstimate estimate_commit(const CommitCosts& commit_costs) const;
 
 	void generate_compound_actions(const Actiongraph* actiongraph);
 	vector<const CompoundAction*> get_compound_actions() const;
 
 	// special actions, TODO make private and provide interface
 	vertex_iterator mount_root_filesystem;
-	map<sid_t, vertex_descriptor> last_action_on_partition_table;
+
+	/**
+	 * The last action on the partition table with the sid or
+	 * null_vertex() if there is none, set by
+	 * PartitionTable::Impl::run_dependency_manager().
+	 */
+	vertex_descriptor get_last_action_on_partition_table(sid_t sid) const;
+	void set_last_action_on_partition_table(sid_t sid, vertex_descriptor vertex);
+
+	/**
+	 * Whether the action was taken over from the previous actiongraph
+	 * during an incremental calculation. The dependencies of such
+	 * actions are already known and must not be added again.
+	 */
+	bool is_reused(vertex_descriptor vertex) const { return reused_vertices.count(vertex) != 0; }
 
     private:
 
+	void calculate();
+	bool calculate_incremental(const Impl& previous);
+
+	/**
+	 * Starts new epochs of the changes of lhs and rhs and remembers
+	 * them for the next incremental calculation.
+	 */
+	void clear_changes();
+
+	/**
+	 * The sids of the changed devices and of all devices connected to
+	 * them in lhs or rhs. Actions only have dependencies among the
+	 * actions of connected devices, apart from the mount order.
+	 */
+	std::unordered_set<sid_t> get_affected_sids(const std::unordered_set<sid_t>& changed_sids) const;
+
 	void get_actions();
+	void get_actions(const vector<sid_t>& sids);
 	void set_special_actions();
 	void add_dependencies();
+	void add_dependencies(const vector<sid_t>& sids);
+	void add_action_dependencies();
 	void add_special_dasd_pt_dependencies();
 	void remove_only_syncs();
 	void calculate_order();
@@ -201,10 +258,25 @@ namespace storage
 
 	graph_t graph;
 
-	map<sid_t, vector<vertex_descriptor>> cache_for_actions_with_sid;
+	// side tables indexed by get_sid_index()
+
+	vector<vector<vertex_descriptor>> cache_for_actions_with_sid;
+	vector<vertex_descriptor> last_action_on_partition_table;
 
 	vector<shared_ptr<CompoundAction>> compound_actions;
 
+	std::unordered_set<vertex_descriptor> reused_vertices;
+
+	// number of Action::Barrier vertices, not counted as actions
+
+	size_t num_barriers = 0;
+
+	// the epochs of the changes of the devicegraphs this actiongraph was
+	// calculated for, see Devicegraph::Impl::clear_changes()
+
+	unsigned long long lhs_changes_epoch = 0;
+	unsigned long long rhs_changes_epoch = 0;
+
     };
 
 }
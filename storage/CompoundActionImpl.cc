@@ -239,16 +239,13 @@ namespace storage
     const Device*
     CompoundAction::Impl::device(const Actiongraph* actiongraph, const Action::Modify* action)
     {
-	try
-	{
-	    return action->get_device(actiongraph->get_impl(), RHS);
-	
-	}
-	catch(const DeviceNotFound& e)
-	{
-	
-	    return action->get_device(actiongraph->get_impl(), LHS);
-	}
+	// No exception is needed to detect a device missing on the RHS.
+
+	const Device* device = action->find_rhs_device(actiongraph->get_impl());
+	if (device)
+	    return device;
+
+	return action->get_device(actiongraph->get_impl(), LHS);
     }
 
     
@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#include <map>
+#include <algorithm>
+#include <boost/algorithm/string.hpp>
+
+#include "storage/DeviceQueryImpl.h"
+#include "storage/Devices/DeviceImpl.h"
+#include "storage/Devices/BlkDevice.h"
+#include "storage/Devices/Partitionable.h"
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/Dasd.h"
+#include "storage/Devices/Multipath.h"
+#include "storage/Devices/DmRaid.h"
+#include "storage/Devices/Md.h"
+#include "storage/Devices/MdContainer.h"
+#include "storage/Devices/MdMember.h"
+#include "storage/Devices/PartitionTable.h"
+#include "storage/Devices/Msdos.h"
+#include "storage/Devices/Gpt.h"
+#include "storage/Devices/DasdPt.h"
+#include "storage/Devices/ImplicitPt.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Devices/LvmPv.h"
+#include "storage/Devices/LvmVg.h"
+#include "storage/Devices/LvmLv.h"
+#include "storage/Devices/Encryption.h"
+#include "storage/Devices/Luks.h"
+#include "storage/Devices/Bcache.h"
+#include "storage/Devices/BcacheCset.h"
+#include "storage/Filesystems/Mountable.h"
+#include "storage/Filesystems/Filesystem.h"
+#include "storage/Filesystems/BlkFilesystem.h"
+#include "storage/Filesystems/Ext.h"
+#include "storage/Filesystems/Ext2.h"
+#include "storage/Filesystems/Ext3.h"
+#include "storage/Filesystems/Ext4.h"
+#include "storage/Filesystems/Btrfs.h"
+#include "storage/Filesystems/BtrfsSubvolume.h"
+#include "storage/Filesystems/Reiserfs.h"
+#include "storage/Filesystems/Xfs.h"
+#include "storage/Filesystems/Swap.h"
+#include "storage/Filesystems/Ntfs.h"
+#include "storage/Filesystems/Vfat.h"
+#include "storage/Filesystems/Iso9660.h"
+#include "storage/Filesystems/Udf.h"
+#include "storage/Filesystems/Nfs.h"
+#include "storage/Filesystems/MountPoint.h"
+#include "storage/Utils/ExceptionImpl.h"
+
+
+namespace storage
+{
+
+    namespace
+    {
+
+	bool
+	is_device(const Device* device)
+	{
+	    return true;
+	}
+
+
+	const map<string, bool (*)(const Device*)> type_registry = {
+	    { "Device", &is_device },
+	    { "BlkDevice", &is_blk_device },
+	    { "Partitionable", &is_partitionable },
+	    { "Disk", &is_disk },
+	    { "Dasd", &is_dasd },
+	    { "Multipath", &is_multipath },
+	    { "DmRaid", &is_dm_raid },
+	    { "Md", &is_md },
+	    { "MdContainer", &is_md_container },
+	    { "MdMember", &is_md_member },
+	    { "PartitionTable", &is_partition_table },
+	    { "Msdos", &is_msdos },
+	    { "Gpt", &is_gpt },
+	    { "DasdPt", &is_dasd_pt },
+	    { "ImplicitPt", &is_implicit_pt },
+	    { "Partition", &is_partition },
+	    { "LvmPv", &is_lvm_pv },
+	    { "LvmVg", &is_lvm_vg },
+	    { "LvmLv", &is_lvm_lv },
+	    { "Encryption", &is_encryption },
+	    { "Luks", &is_luks },
+	    { "Bcache", &is_bcache },
+	    { "BcacheCset", &is_bcache_cset },
+	    { "Mountable", &is_mountable },
+	    { "Filesystem", &is_filesystem },
+	    { "BlkFilesystem", &is_blk_filesystem },
+	    { "Ext", &is_ext },
+	    { "Ext2", &is_ext2 },
+	    { "Ext3", &is_ext3 },
+	    { "Ext4", &is_ext4 },
+	    { "Btrfs", &is_btrfs },
+	    { "BtrfsSubvolume", &is_btrfs_subvolume },
+	    { "Reiserfs", &is_reiserfs },
+	    { "Xfs", &is_xfs },
+	    { "Swap", &is_swap },
+	    { "Ntfs", &is_ntfs },
+	    { "Vfat", &is_vfat },
+	    { "Iso9660", &is_iso9660 },
+	    { "Udf", &is_udf },
+	    { "Nfs", &is_nfs },
+	    { "MountPoint", &is_mount_point }
+	};
+
+    }
+
+
+    DeviceQuery::DeviceQuery()
+	: impl(new Impl())
+    {
+    }
+
+
+    DeviceQuery::DeviceQuery(const DeviceQuery& query)
+	: impl(new Impl(query.get_impl()))
+    {
+    }
+
+
+    DeviceQuery::~DeviceQuery()
+    {
+    }
+
+
+    DeviceQuery&
+    DeviceQuery::operator=(const DeviceQuery& query)
+    {
+	*impl = query.get_impl();
+
+	return *this;
+    }
+
+
+    DeviceQuery&
+    DeviceQuery::set_type(const std::string& type)
+    {
+	map<string, bool (*)(const Device*)>::const_iterator it = type_registry.find(type);
+	if (it == type_registry.end())
+	    ST_THROW(Exception("unknown device type " + type));
+
+	get_impl().is_of_type = it->second;
+
+	return *this;
+    }
+
+
+    DeviceQuery&
+    DeviceQuery::set_min_size(unsigned long long min_size)
+    {
+	get_impl().check_min_size = true;
+	get_impl().min_size = min_size;
+
+	return *this;
+    }
+
+
+    DeviceQuery&
+    DeviceQuery::set_max_size(unsigned long long max_size)
+    {
+	get_impl().check_max_size = true;
+	get_impl().max_size = max_size;
+
+	return *this;
+    }
+
+
+    DeviceQuery&
+    DeviceQuery::set_name_prefix(const std::string& prefix)
+    {
+	get_impl().check_name_prefix = true;
+	get_impl().name_prefix = prefix;
+
+	return *this;
+    }
+
+
+    DeviceQuery&
+    DeviceQuery::set_uuid(const std::string& uuid)
+    {
+	get_impl().check_uuid = true;
+	get_impl().uuid = uuid;
+
+	return *this;
+    }
+
+
+    DeviceQuery&
+    DeviceQuery::set_has_children(bool has_children)
+    {
+	get_impl().check_has_children = true;
+	get_impl().has_children = has_children;
+
+	return *this;
+    }
+
+
+    DeviceQuery&
+    DeviceQuery::set_in_etc_fstab(bool in_etc_fstab)
+    {
+	get_impl().check_in_etc_fstab = true;
+	get_impl().in_etc_fstab = in_etc_fstab;
+
+	return *this;
+    }
+
+
+    DeviceQuery&
+    DeviceQuery::set_udev_id(const std::string& udev_id)
+    {
+	get_impl().check_udev_id = true;
+	get_impl().udev_id = udev_id;
+
+	return *this;
+    }
+
+
+    DeviceQuery&
+    DeviceQuery::add_predicate(std::function<bool(const Device*)> predicate)
+    {
+	get_impl().predicates.push_back(predicate);
+
+	return *this;
+    }
+
+
+    bool
+    DeviceQuery::Impl::matches(const Device* device) const
+    {
+	if (is_of_type && !is_of_type(device))
+	    return false;
+
+	if (check_min_size || check_max_size || check_udev_id)
+	{
+	    if (!is_blk_device(device))
+		return false;
+
+	    const BlkDevice* blk_device = to_blk_device(device);
+
+	    if (check_min_size && blk_device->get_size() < min_size)
+		return false;
+
+	    if (check_max_size && blk_device->get_size() > max_size)
+		return false;
+
+	    if (check_udev_id)
+	    {
+		const vector<string>& udev_ids = blk_device->get_udev_ids();
+		if (find(udev_ids.begin(), udev_ids.end(), udev_id) == udev_ids.end())
+		    return false;
+	    }
+	}
+
+	if (check_name_prefix && !boost::starts_with(device->get_impl().get_index_name(), name_prefix))
+	    return false;
+
+	if (check_uuid && device->get_impl().get_index_uuid() != uuid)
+	    return false;
+
+	if (check_has_children && device->has_children() != has_children)
+	    return false;
+
+	if (check_in_etc_fstab)
+	{
+	    if (!is_mount_point(device))
+		return false;
+
+	    if (to_mount_point(device)->is_in_etc_fstab() != in_etc_fstab)
+		return false;
+	}
+
+	for (const std::function<bool(const Device*)>& predicate : predicates)
+	{
+	    if (!predicate(device))
+		return false;
+	}
+
+	return true;
+    }
+
+}
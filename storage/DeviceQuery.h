@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#ifndef STORAGE_DEVICE_QUERY_H
+#define STORAGE_DEVICE_QUERY_H
+
+
+#include <string>
+#include <memory>
+#include <functional>
+
+
+namespace storage
+{
+
+    class Device;
+
+
+    /**
+     * A query for devices, used by Devicegraph::query(). A device matches
+     * if it satisfies all criteria set, so criteria are combined with
+     * and. Without criteria all devices match.
+     *
+     * Criteria on the size, the name and the uuid use indexes of the
+     * devicegraph so that the candidates can be found in O(log n + k).
+     * The other criteria are only evaluated for the candidates.
+     *
+     * The setters return the query so that calls can be chained:
+     *
+     *     DeviceQuery().set_type("BlkDevice").set_min_size(10 * GiB).set_has_children(false)
+     */
+    class DeviceQuery
+    {
+    public:
+
+	DeviceQuery();
+	DeviceQuery(const DeviceQuery& query);
+	~DeviceQuery();
+
+	DeviceQuery& operator=(const DeviceQuery& query);
+
+	/**
+	 * Only devices of the type, e.g. "Disk". Base classes, e.g.
+	 * "BlkDevice" or "Filesystem", are also allowed.
+	 *
+	 * @throw Exception
+	 */
+	DeviceQuery& set_type(const std::string& type);
+
+	/**
+	 * Only block devices with a size of at least min_size.
+	 */
+	DeviceQuery& set_min_size(unsigned long long min_size);
+
+	/**
+	 * Only block devices with a size of at most max_size.
+	 */
+	DeviceQuery& set_max_size(unsigned long long max_size);
+
+	/**
+	 * Only devices whose name, as used by find_by_name() functions,
+	 * starts with prefix.
+	 */
+	DeviceQuery& set_name_prefix(const std::string& prefix);
+
+	/**
+	 * Only devices with the uuid, as used by find_by_uuid() functions.
+	 */
+	DeviceQuery& set_uuid(const std::string& uuid);
+
+	/**
+	 * Only devices that have or do not have children.
+	 */
+	DeviceQuery& set_has_children(bool has_children);
+
+	/**
+	 * Only mount points that are or are not in /etc/fstab.
+	 */
+	DeviceQuery& set_in_etc_fstab(bool in_etc_fstab);
+
+	/**
+	 * Only block devices with the udev id.
+	 */
+	DeviceQuery& set_udev_id(const std::string& udev_id);
+
+	/**
+	 * Only devices for which the predicate returns true. Can be called
+	 * several times. Not available in the bindings.
+	 */
+	DeviceQuery& add_predicate(std::function<bool(const Device*)> predicate);
+
+    public:
+
+	class Impl;
+
+	Impl& get_impl() { return *impl; }
+	const Impl& get_impl() const { return *impl; }
+
+    private:
+
+	std::unique_ptr<Impl> impl;
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#ifndef STORAGE_DEVICE_QUERY_IMPL_H
+#define STORAGE_DEVICE_QUERY_IMPL_H
+
+
+#include <vector>
+
+#include "storage/DeviceQuery.h"
+
+
+namespace storage
+{
+
+    using namespace std;
+
+
+    class DeviceQuery::Impl
+    {
+    public:
+
+	/**
+	 * Checks whether the device satisfies all criteria.
+	 */
+	bool matches(const Device* device) const;
+
+	bool (*is_of_type)(const Device*) = nullptr;
+
+	bool check_min_size = false;
+	unsigned long long min_size = 0;
+
+	bool check_max_size = false;
+	unsigned long long max_size = 0;
+
+	bool check_name_prefix = false;
+	string name_prefix;
+
+	bool check_uuid = false;
+	string uuid;
+
+	bool check_has_children = false;
+	bool has_children = false;
+
+	bool check_in_etc_fstab = false;
+	bool in_etc_fstab = false;
+
+	bool check_udev_id = false;
+	string udev_id;
+
+	vector<std::function<bool(const Device*)>> predicates;
+
+    };
+
+}
+
+#endif
@@ -21,13 +21,11 @@
  */
 
 
-#include <boost/graph/copy.hpp>
 #include <boost/graph/reverse_graph.hpp>
 #include <boost/graph/graphviz.hpp>
 #include <boost/graph/graph_utility.hpp>
 
 #include "storage/Devicegraph.h"
-#include "storage/Utils/GraphUtils.h"
 #include "storage/Devices/DeviceImpl.h"
 #include "storage/Devices/BlkDevice.h"
 #include "storage/Devices/Disk.h"
@@ -172,6 +170,13 @@ namespace storage
     }
 
 
+    unsigned long long
+    Devicegraph::get_modification_counter() const
+    {
+	return get_impl().get_modification_counter();
+    }
+
+
     std::vector<Disk*>
     Devicegraph::get_all_disks()
     {
@@ -242,40 +247,6 @@ namespace storage
     }
 
 
-    class CloneCopier
-    {
-
-    public:
-
-	CloneCopier(const Devicegraph& g_in, Devicegraph& g_out)
-	    : g_in(g_in), g_out(g_out) {}
-
-	void operator()(const Devicegraph::Impl::vertex_descriptor& v_in,
-			Devicegraph::Impl::vertex_descriptor& v_out)
-	{
-	    g_out.get_impl().graph[v_out].reset(g_in.get_impl().graph[v_in]->clone());
-
-	    Device* d_out = g_out.get_impl().graph[v_out].get();
-	    d_out->get_impl().set_devicegraph_and_vertex(&g_out, v_out);
-	}
-
-	void operator()(const Devicegraph::Impl::edge_descriptor& e_in,
-			Devicegraph::Impl::edge_descriptor& e_out)
-	{
-	    g_out.get_impl().graph[e_out].reset(g_in.get_impl().graph[e_in]->clone());
-
-	    Holder* h_out = g_out.get_impl().graph[e_out].get();
-	    h_out->get_impl().set_devicegraph_and_edge(&g_out, e_out);
-	}
-
-    private:
-
-	const Devicegraph& g_in;
-	Devicegraph& g_out;
-
-    };
-
-
     Device*
     Devicegraph::find_device(sid_t sid)
     {
@@ -366,18 +337,62 @@ namespace storage
     }
 
 
+    MemoryUsage
+    Devicegraph::memory_usage() const
+    {
+	return get_impl().memory_usage();
+    }
+
+
+    vector<Device*>
+    Devicegraph::query(const DeviceQuery& query)
+    {
+	vector<Device*> ret;
+
+	for (Impl::vertex_descriptor vertex : get_impl().query(query))
+	    ret.push_back(get_impl()[vertex]);
+
+	return ret;
+    }
+
+
+    vector<const Device*>
+    Devicegraph::query(const DeviceQuery& query) const
+    {
+	vector<const Device*> ret;
+
+	for (Impl::vertex_descriptor vertex : get_impl().query(query))
+	    ret.push_back(get_impl()[vertex]);
+
+	return ret;
+    }
+
+
+    unsigned int
+    Devicegraph::begin_savepoint()
+    {
+	return get_impl().begin_savepoint();
+    }
+
+
     void
-    Devicegraph::copy(Devicegraph& dest) const
+    Devicegraph::rollback_to(unsigned int savepoint)
     {
-	dest.get_impl().clear();
+	get_impl().rollback_to(savepoint);
+    }
 
-	VertexIndexMapGenerator<Impl::graph_t> vertex_index_map_generator(get_impl().graph);
 
-	CloneCopier copier(*this, dest);
+    void
+    Devicegraph::release(unsigned int savepoint)
+    {
+	get_impl().release(savepoint);
+    }
+
 
-	boost::copy_graph(get_impl().graph, dest.get_impl().graph,
-			  vertex_index_map(vertex_index_map_generator.get()).
-			  vertex_copy(copier).edge_copy(copier));
+    void
+    Devicegraph::copy(Devicegraph& dest) const
+    {
+	get_impl().copy(dest);
     }
 
 
@@ -30,6 +30,8 @@
 
 #include "storage/Devices/Device.h"
 #include "storage/Graphviz.h"
+#include "storage/MemoryUsage.h"
+#include "storage/DeviceQuery.h"
 
 
 namespace storage
@@ -164,11 +166,19 @@ namespace storage
 	const Storage* get_storage() const;
 
 	/**
+	 * Loads the devicegraph from an xml or binary file. The format is
+	 * detected from the content of the file.
+	 *
 	 * @throw Exception
 	 */
 	void load(const std::string& filename);
 
 	/**
+	 * Saves the devicegraph. If the filename has the extension ".bin" a
+	 * compact binary format is used, otherwise xml. Loading the binary
+	 * format avoids parsing xml text but the attributes are still
+	 * converted from strings. The format is not intended for humans.
+	 *
 	 * @throw Exception
 	 */
 	void save(const std::string& filename) const;
@@ -178,6 +188,15 @@ namespace storage
 	size_t num_devices() const;
 	size_t num_holders() const;
 
+	/**
+	 * Counter that is incremented whenever a device or holder is added,
+	 * removed or possibly modified. Comparing it with an earlier value is
+	 * a cheap way to detect whether the devicegraph changed, e.g. when
+	 * polling. The counter can also change without an actual
+	 * modification.
+	 */
+	unsigned long long get_modification_counter() const;
+
 	/**
 	 * @throw DeviceNotFoundBySid
 	 */
@@ -249,7 +268,64 @@ namespace storage
 	 */
 	uint64_t used_features() const;
 
-	// TODO move to Impl
+	/**
+	 * Estimates the memory used by the devicegraph, split into devices
+	 * and holders per class, the graph structure with its indexes and
+	 * caches, userdata and strings.
+	 *
+	 * The values are approximations since the memory overhead of the
+	 * allocator and the containers is implementation specific.
+	 */
+	MemoryUsage memory_usage() const;
+
+	/**
+	 * Finds the devices matching the query, sorted by sid.
+	 *
+	 * @see DeviceQuery
+	 *
+	 * @throw Exception
+	 */
+	std::vector<Device*> query(const DeviceQuery& query);
+
+	/**
+	 * @copydoc query
+	 */
+	std::vector<const Device*> query(const DeviceQuery& query) const;
+
+	/**
+	 * Begins a savepoint. Until the savepoint is released all changes
+	 * of the devicegraph, e.g. creating and removing devices and holders
+	 * and setting attributes, are recorded in a journal so that they can
+	 * be undone by rollback_to(). Savepoints can be nested. Returns the
+	 * id of the savepoint.
+	 *
+	 * Compared to copying the devicegraph before changes and restoring
+	 * it afterwards the cost is proportional to the number of changes
+	 * and not to the size of the devicegraph.
+	 */
+	unsigned int begin_savepoint();
+
+	/**
+	 * Undoes all changes since the savepoint was begun. The savepoint
+	 * stays active, later savepoints are released.
+	 *
+	 * Devices and holders modified or removed since the savepoint are
+	 * restored as the same objects, so pointers to them stay valid.
+	 * Pointers to devices and holders created since the savepoint become
+	 * invalid.
+	 *
+	 * @throw Exception
+	 */
+	void rollback_to(unsigned int savepoint);
+
+	/**
+	 * Releases the savepoint and all later savepoints keeping the
+	 * changes. Once no savepoint is active the journal is discarded.
+	 *
+	 * @throw Exception
+	 */
+	void release(unsigned int savepoint);
+
 	void copy(Devicegraph& dest) const;
 
 	/**
@@ -0,0 +1,478 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#include <algorithm>
+#include <sstream>
+#include <typeinfo>
+#include <map>
+#include <memory>
+
+#include "storage/DevicegraphDiffImpl.h"
+#include "storage/Utils/ExceptionImpl.h"
+#include "storage/Utils/XmlFile.h"
+#include "storage/Devices/DeviceImpl.h"
+#include "storage/Holders/HolderImpl.h"
+
+
+namespace storage
+{
+
+    DevicegraphDiff::DevicegraphDiff(const Devicegraph* lhs, const Devicegraph* rhs)
+	: impl(new Impl(lhs->get_impl(), rhs->get_impl()))
+    {
+    }
+
+
+    DevicegraphDiff::~DevicegraphDiff()
+    {
+    }
+
+
+    vector<sid_t>
+    DevicegraphDiff::get_created_devices() const
+    {
+	vector<sid_t> ret;
+
+	for (const Impl::DeviceEntry& device_entry : get_impl().get_created_devices())
+	    ret.push_back(device_entry.sid);
+
+	return ret;
+    }
+
+
+    vector<sid_t>
+    DevicegraphDiff::get_deleted_devices() const
+    {
+	vector<sid_t> ret;
+
+	for (const Impl::DeviceEntry& device_entry : get_impl().get_deleted_devices())
+	    ret.push_back(device_entry.sid);
+
+	return ret;
+    }
+
+
+    vector<sid_t>
+    DevicegraphDiff::get_modified_devices() const
+    {
+	vector<sid_t> ret;
+
+	for (const Impl::DeviceEntry& device_entry : get_impl().get_modified_devices())
+	    ret.push_back(device_entry.sid);
+
+	return ret;
+    }
+
+
+    vector<pair<sid_t, sid_t>>
+    DevicegraphDiff::get_created_holders() const
+    {
+	vector<pair<sid_t, sid_t>> ret;
+
+	for (const Impl::HolderEntry& holder_entry : get_impl().get_created_holders())
+	    ret.emplace_back(holder_entry.source_sid, holder_entry.target_sid);
+
+	return ret;
+    }
+
+
+    vector<pair<sid_t, sid_t>>
+    DevicegraphDiff::get_deleted_holders() const
+    {
+	vector<pair<sid_t, sid_t>> ret;
+
+	for (const Impl::HolderEntry& holder_entry : get_impl().get_deleted_holders())
+	    ret.emplace_back(holder_entry.source_sid, holder_entry.target_sid);
+
+	return ret;
+    }
+
+
+    vector<pair<sid_t, sid_t>>
+    DevicegraphDiff::get_modified_holders() const
+    {
+	vector<pair<sid_t, sid_t>> ret;
+
+	for (const Impl::HolderEntry& holder_entry : get_impl().get_modified_holders())
+	    ret.emplace_back(holder_entry.source_sid, holder_entry.target_sid);
+
+	return ret;
+    }
+
+
+    vector<string>
+    DevicegraphDiff::get_changed_attributes(sid_t sid) const
+    {
+	return get_impl().get_changed_attribute_names(get_impl().find_common_device(sid));
+    }
+
+
+    vector<string>
+    DevicegraphDiff::get_changed_attributes(sid_t source_sid, sid_t target_sid) const
+    {
+	return get_impl().get_changed_attribute_names(get_impl().find_common_holder(source_sid, target_sid));
+    }
+
+
+    bool
+    DevicegraphDiff::empty() const
+    {
+	return get_impl().empty();
+    }
+
+
+    DevicegraphDiff::Impl::Impl(const Devicegraph::Impl& lhs, const Devicegraph::Impl& rhs)
+	: lhs(lhs), rhs(rhs)
+    {
+	diff_devices();
+	diff_holders();
+    }
+
+
+    namespace
+    {
+
+	typedef pair<sid_t, Devicegraph::Impl::vertex_descriptor> sid_and_vertex_t;
+
+
+	vector<sid_and_vertex_t>
+	sorted_vertices(const Devicegraph::Impl& devicegraph)
+	{
+	    vector<sid_and_vertex_t> ret;
+	    ret.reserve(devicegraph.num_devices());
+
+	    for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph.vertices())
+		ret.emplace_back(devicegraph[vertex]->get_sid(), vertex);
+
+	    sort(ret.begin(), ret.end(), [](const sid_and_vertex_t& a, const sid_and_vertex_t& b) {
+		return a.first < b.first;
+	    });
+
+	    return ret;
+	}
+
+
+	typedef pair<pair<sid_t, sid_t>, Devicegraph::Impl::edge_descriptor> sids_and_edge_t;
+
+
+	vector<sids_and_edge_t>
+	sorted_edges(const Devicegraph::Impl& devicegraph)
+	{
+	    vector<sids_and_edge_t> ret;
+	    ret.reserve(devicegraph.num_holders());
+
+	    for (Devicegraph::Impl::edge_descriptor edge : devicegraph.edges())
+		ret.emplace_back(make_pair(devicegraph[devicegraph.source(edge)]->get_sid(),
+					   devicegraph[devicegraph.target(edge)]->get_sid()), edge);
+
+	    sort(ret.begin(), ret.end(), [](const sids_and_edge_t& a, const sids_and_edge_t& b) {
+		return a.first < b.first;
+	    });
+
+	    return ret;
+	}
+
+    }
+
+
+    void
+    DevicegraphDiff::Impl::diff_devices()
+    {
+	const vector<sid_and_vertex_t> lhs_vertices = sorted_vertices(lhs);
+	const vector<sid_and_vertex_t> rhs_vertices = sorted_vertices(rhs);
+
+	vector<sid_and_vertex_t>::const_iterator lhs_it = lhs_vertices.begin();
+	vector<sid_and_vertex_t>::const_iterator rhs_it = rhs_vertices.begin();
+
+	while (lhs_it != lhs_vertices.end() || rhs_it != rhs_vertices.end())
+	{
+	    if (rhs_it == rhs_vertices.end() || (lhs_it != lhs_vertices.end() && lhs_it->first < rhs_it->first))
+	    {
+		deleted_devices.push_back({ lhs_it->first, lhs_it->second, nullptr });
+		++lhs_it;
+	    }
+	    else if (lhs_it == lhs_vertices.end() || rhs_it->first < lhs_it->first)
+	    {
+		created_devices.push_back({ rhs_it->first, nullptr, rhs_it->second });
+		++rhs_it;
+	    }
+	    else
+	    {
+		common_devices.push_back({ lhs_it->first, lhs_it->second, rhs_it->second });
+		++lhs_it;
+		++rhs_it;
+	    }
+	}
+    }
+
+
+    void
+    DevicegraphDiff::Impl::diff_holders()
+    {
+	const vector<sids_and_edge_t> lhs_edges = sorted_edges(lhs);
+	const vector<sids_and_edge_t> rhs_edges = sorted_edges(rhs);
+
+	vector<sids_and_edge_t>::const_iterator lhs_it = lhs_edges.begin();
+	vector<sids_and_edge_t>::const_iterator rhs_it = rhs_edges.begin();
+
+	while (lhs_it != lhs_edges.end() || rhs_it != rhs_edges.end())
+	{
+	    if (rhs_it == rhs_edges.end() || (lhs_it != lhs_edges.end() && lhs_it->first < rhs_it->first))
+	    {
+		deleted_holders.push_back({ lhs_it->first.first, lhs_it->first.second, lhs_it->second,
+					    edge_descriptor() });
+		++lhs_it;
+	    }
+	    else if (lhs_it == lhs_edges.end() || rhs_it->first < lhs_it->first)
+	    {
+		created_holders.push_back({ rhs_it->first.first, rhs_it->first.second, edge_descriptor(),
+					    rhs_it->second });
+		++rhs_it;
+	    }
+	    else
+	    {
+		common_holders.push_back({ lhs_it->first.first, lhs_it->first.second, lhs_it->second,
+					   rhs_it->second });
+		++lhs_it;
+		++rhs_it;
+	    }
+	}
+    }
+
+
+    vector<DevicegraphDiff::Impl::DeviceEntry>
+    DevicegraphDiff::Impl::get_modified_devices() const
+    {
+	vector<DeviceEntry> ret;
+
+	for (const DeviceEntry& device_entry : common_devices)
+	{
+	    if (*lhs[device_entry.lhs_vertex] != *rhs[device_entry.rhs_vertex])
+		ret.push_back(device_entry);
+	}
+
+	return ret;
+    }
+
+
+    vector<DevicegraphDiff::Impl::HolderEntry>
+    DevicegraphDiff::Impl::get_modified_holders() const
+    {
+	vector<HolderEntry> ret;
+
+	for (const HolderEntry& holder_entry : common_holders)
+	{
+	    if (*lhs[holder_entry.lhs_edge] != *rhs[holder_entry.rhs_edge])
+		ret.push_back(holder_entry);
+	}
+
+	return ret;
+    }
+
+
+    string
+    DevicegraphDiff::Impl::get_changed_attributes(const DeviceEntry& device_entry) const
+    {
+	const Device::Impl& lhs_impl = lhs[device_entry.lhs_vertex]->get_impl();
+	const Device::Impl& rhs_impl = rhs[device_entry.rhs_vertex]->get_impl();
+
+	if (typeid(lhs_impl) != typeid(rhs_impl))
+	    return " type:" + string(lhs_impl.get_classname()) + "-->" + rhs_impl.get_classname();
+
+	std::ostringstream tmp;
+	lhs_impl.log_diff(tmp, rhs_impl);
+	return tmp.str();
+    }
+
+
+    const DevicegraphDiff::Impl::DeviceEntry&
+    DevicegraphDiff::Impl::find_common_device(sid_t sid) const
+    {
+	vector<DeviceEntry>::const_iterator it =
+	    lower_bound(common_devices.begin(), common_devices.end(), sid,
+			[](const DeviceEntry& device_entry, sid_t sid) { return device_entry.sid < sid; });
+
+	if (it == common_devices.end() || it->sid != sid)
+	    ST_THROW(DeviceNotFoundBySid(sid));
+
+	return *it;
+    }
+
+
+    const DevicegraphDiff::Impl::HolderEntry&
+    DevicegraphDiff::Impl::find_common_holder(sid_t source_sid, sid_t target_sid) const
+    {
+	const pair<sid_t, sid_t> sids(source_sid, target_sid);
+
+	vector<HolderEntry>::const_iterator it =
+	    lower_bound(common_holders.begin(), common_holders.end(), sids,
+			[](const HolderEntry& holder_entry, const pair<sid_t, sid_t>& sids) {
+			    return make_pair(holder_entry.source_sid, holder_entry.target_sid) < sids;
+			});
+
+	if (it == common_holders.end() || it->source_sid != source_sid || it->target_sid != target_sid)
+	    ST_THROW(HolderNotFoundBySids(source_sid, target_sid));
+
+	return *it;
+    }
+
+
+    namespace
+    {
+
+	typedef map<string, vector<string>> saved_attributes_t;
+
+
+	/**
+	 * Saves the device or holder and maps the names of the saved
+	 * attributes to their serialized xml nodes. Attributes saved several
+	 * times, e.g. lists, have several values.
+	 */
+	template <typename Type>
+	saved_attributes_t
+	saved_attributes(const Type* object)
+	{
+	    typedef std::unique_ptr<xmlNode, void(*)(xmlNode*)> node_ptr;
+	    typedef std::unique_ptr<xmlBuffer, void(*)(xmlBuffer*)> buffer_ptr;
+
+	    node_ptr node(xmlNewNode(object->get_impl().get_classname()), &xmlFreeNode);
+	    object->save(node.get());
+
+	    saved_attributes_t ret;
+
+	    for (xmlNode* child = node->children; child; child = child->next)
+	    {
+		if (child->type != XML_ELEMENT_NODE)
+		    continue;
+
+		buffer_ptr buffer(xmlBufferCreate(), &xmlBufferFree);
+		xmlNodeDump(buffer.get(), nullptr, child, 0, 0);
+
+		ret[(const char*) child->name].push_back((const char*) xmlBufferContent(buffer.get()));
+	    }
+
+	    return ret;
+	}
+
+
+	template <typename Type>
+	vector<string>
+	changed_attribute_names(const Type* lhs, const Type* rhs)
+	{
+	    const saved_attributes_t lhs_attributes = saved_attributes(lhs);
+	    const saved_attributes_t rhs_attributes = saved_attributes(rhs);
+
+	    vector<string> ret;
+
+	    for (const saved_attributes_t::value_type& lhs_attribute : lhs_attributes)
+	    {
+		saved_attributes_t::const_iterator it = rhs_attributes.find(lhs_attribute.first);
+		if (it == rhs_attributes.end() || it->second != lhs_attribute.second)
+		    ret.push_back(lhs_attribute.first);
+	    }
+
+	    for (const saved_attributes_t::value_type& rhs_attribute : rhs_attributes)
+	    {
+		if (lhs_attributes.find(rhs_attribute.first) == lhs_attributes.end())
+		    ret.push_back(rhs_attribute.first);
+	    }
+
+	    sort(ret.begin(), ret.end());
+
+	    return ret;
+	}
+
+    }
+
+
+    vector<string>
+    DevicegraphDiff::Impl::get_changed_attribute_names(const DeviceEntry& device_entry) const
+    {
+	const Device* lhs_device = lhs[device_entry.lhs_vertex];
+	const Device* rhs_device = rhs[device_entry.rhs_vertex];
+
+	if (*lhs_device == *rhs_device)
+	    return {};
+
+	return changed_attribute_names(lhs_device, rhs_device);
+    }
+
+
+    vector<string>
+    DevicegraphDiff::Impl::get_changed_attribute_names(const HolderEntry& holder_entry) const
+    {
+	const Holder* lhs_holder = lhs[holder_entry.lhs_edge];
+	const Holder* rhs_holder = rhs[holder_entry.rhs_edge];
+
+	if (*lhs_holder == *rhs_holder)
+	    return {};
+
+	return changed_attribute_names(lhs_holder, rhs_holder);
+    }
+
+
+    bool
+    DevicegraphDiff::Impl::empty() const
+    {
+	return created_devices.empty() && deleted_devices.empty() && created_holders.empty() &&
+	    deleted_holders.empty() && get_modified_devices().empty() && get_modified_holders().empty();
+    }
+
+
+    void
+    DevicegraphDiff::Impl::log(std::ostream& log) const
+    {
+	for (const DeviceEntry& device_entry : deleted_devices)
+	    log << "sid " << device_entry.sid << " device only in lhs\n";
+
+	for (const DeviceEntry& device_entry : created_devices)
+	    log << "sid " << device_entry.sid << " device only in rhs\n";
+
+	for (const DeviceEntry& device_entry : get_modified_devices())
+	    log << "sid " << device_entry.sid << " device differ:" << get_changed_attributes(device_entry)
+		<< '\n';
+
+	for (const HolderEntry& holder_entry : deleted_holders)
+	    log << "sid " << holder_entry.source_sid << " " << holder_entry.target_sid
+		<< " holder only in lhs\n";
+
+	for (const HolderEntry& holder_entry : created_holders)
+	    log << "sid " << holder_entry.source_sid << " " << holder_entry.target_sid
+		<< " holder only in rhs\n";
+
+	for (const HolderEntry& holder_entry : get_modified_holders())
+	{
+	    const Holder::Impl& lhs_impl = lhs[holder_entry.lhs_edge]->get_impl();
+	    const Holder::Impl& rhs_impl = rhs[holder_entry.rhs_edge]->get_impl();
+
+	    log << "sid " << holder_entry.source_sid << " " << holder_entry.target_sid << " holder differ:";
+
+	    if (typeid(lhs_impl) != typeid(rhs_impl))
+		log << " type:" << lhs_impl.get_classname() << "-->" << rhs_impl.get_classname();
+	    else
+		lhs_impl.log_diff(log, rhs_impl);
+
+	    log << '\n';
+	}
+    }
+
+}
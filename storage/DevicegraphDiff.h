@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#ifndef STORAGE_DEVICEGRAPH_DIFF_H
+#define STORAGE_DEVICEGRAPH_DIFF_H
+
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <memory>
+#include <boost/noncopyable.hpp>
+
+#include "storage/Devices/Device.h"
+
+
+namespace storage
+{
+
+    class Devicegraph;
+
+
+    /**
+     * Difference between two devicegraphs, lhs and rhs, e.g. probed and
+     * staging. Devices are identified by their sid, holders by the sids
+     * of their source and target.
+     *
+     * The devicegraphs must not be modified during the lifetime of the
+     * object.
+     */
+    class DevicegraphDiff : private boost::noncopyable
+    {
+    public:
+
+	DevicegraphDiff(const Devicegraph* lhs, const Devicegraph* rhs);
+	~DevicegraphDiff();
+
+	/**
+	 * Sids of the devices only in rhs sorted by sid.
+	 */
+	std::vector<sid_t> get_created_devices() const;
+
+	/**
+	 * Sids of the devices only in lhs sorted by sid.
+	 */
+	std::vector<sid_t> get_deleted_devices() const;
+
+	/**
+	 * Sids of the devices in lhs and rhs that differ sorted by sid.
+	 */
+	std::vector<sid_t> get_modified_devices() const;
+
+	/**
+	 * Sids of source and target of the holders only in rhs sorted by
+	 * the sids.
+	 */
+	std::vector<std::pair<sid_t, sid_t>> get_created_holders() const;
+
+	/**
+	 * Sids of source and target of the holders only in lhs sorted by
+	 * the sids.
+	 */
+	std::vector<std::pair<sid_t, sid_t>> get_deleted_holders() const;
+
+	/**
+	 * Sids of source and target of the holders in lhs and rhs that
+	 * differ sorted by the sids.
+	 */
+	std::vector<std::pair<sid_t, sid_t>> get_modified_holders() const;
+
+	/**
+	 * Names of the attributes of the device that differ in lhs and rhs
+	 * sorted by name. The names are the ones used when saving the
+	 * devicegraph, e.g. "name" or "region". If the type of the device
+	 * changed the attributes of both types are compared. Empty if the
+	 * device is not modified.
+	 *
+	 * @throw DeviceNotFoundBySid
+	 */
+	std::vector<std::string> get_changed_attributes(sid_t sid) const;
+
+	/**
+	 * Names of the attributes of the holder that differ in lhs and rhs,
+	 * see get_changed_attributes(sid_t).
+	 *
+	 * @throw HolderNotFoundBySids
+	 */
+	std::vector<std::string> get_changed_attributes(sid_t source_sid, sid_t target_sid) const;
+
+	/**
+	 * True if lhs and rhs have the same devices and holders and none is
+	 * modified.
+	 */
+	bool empty() const;
+
+    public:
+
+	class Impl;
+
+	Impl& get_impl() { return *impl; }
+	const Impl& get_impl() const { return *impl; }
+
+    private:
+
+	const std::unique_ptr<Impl> impl;
+
+    };
+
+}
+
+#endif
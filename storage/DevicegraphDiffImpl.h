@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#ifndef STORAGE_DEVICEGRAPH_DIFF_IMPL_H
+#define STORAGE_DEVICEGRAPH_DIFF_IMPL_H
+
+
+#include <ostream>
+#include <vector>
+#include <utility>
+
+#include "storage/DevicegraphDiff.h"
+#include "storage/DevicegraphImpl.h"
+
+
+namespace storage
+{
+
+    /**
+     * Devices are matched by sid, holders by the sids of source and
+     * target.
+     *
+     * Created, deleted and common devices and holders are computed in the
+     * constructor by a single merge of the sid sorted devices and holders
+     * of both devicegraphs. Which of the common devices and holders are
+     * modified is only computed when queried.
+     *
+     * The devicegraphs must not be modified during the lifetime of the
+     * object.
+     */
+    class DevicegraphDiff::Impl : private boost::noncopyable
+    {
+    public:
+
+	typedef Devicegraph::Impl::vertex_descriptor vertex_descriptor;
+	typedef Devicegraph::Impl::edge_descriptor edge_descriptor;
+
+	struct DeviceEntry
+	{
+	    sid_t sid;
+	    vertex_descriptor lhs_vertex;
+	    vertex_descriptor rhs_vertex;
+	};
+
+	struct HolderEntry
+	{
+	    sid_t source_sid;
+	    sid_t target_sid;
+	    edge_descriptor lhs_edge;
+	    edge_descriptor rhs_edge;
+	};
+
+	Impl(const Devicegraph::Impl& lhs, const Devicegraph::Impl& rhs);
+
+	/**
+	 * Devices only in rhs. Only rhs_vertex is valid. Sorted by sid.
+	 */
+	const vector<DeviceEntry>& get_created_devices() const { return created_devices; }
+
+	/**
+	 * Devices only in lhs. Only lhs_vertex is valid. Sorted by sid.
+	 */
+	const vector<DeviceEntry>& get_deleted_devices() const { return deleted_devices; }
+
+	/**
+	 * Devices in lhs and rhs. Sorted by sid.
+	 */
+	const vector<DeviceEntry>& get_common_devices() const { return common_devices; }
+
+	const vector<HolderEntry>& get_created_holders() const { return created_holders; }
+	const vector<HolderEntry>& get_deleted_holders() const { return deleted_holders; }
+	const vector<HolderEntry>& get_common_holders() const { return common_holders; }
+
+	/**
+	 * Common devices that differ in lhs and rhs.
+	 */
+	vector<DeviceEntry> get_modified_devices() const;
+
+	/**
+	 * Common holders that differ in lhs and rhs.
+	 */
+	vector<HolderEntry> get_modified_holders() const;
+
+	/**
+	 * Finds the entry of a common device or holder.
+	 *
+	 * @throw DeviceNotFoundBySid, HolderNotFoundBySids
+	 */
+	const DeviceEntry& find_common_device(sid_t sid) const;
+	const HolderEntry& find_common_holder(sid_t source_sid, sid_t target_sid) const;
+
+	/**
+	 * Text describing the changed attributes of a common device, e.g.
+	 * " name:/dev/sda1-->/dev/sda2". Empty if nothing changed.
+	 */
+	string get_changed_attributes(const DeviceEntry& device_entry) const;
+
+	/**
+	 * Names of the changed attributes of a common device or holder, see
+	 * DevicegraphDiff::get_changed_attributes().
+	 */
+	vector<string> get_changed_attribute_names(const DeviceEntry& device_entry) const;
+	vector<string> get_changed_attribute_names(const HolderEntry& holder_entry) const;
+
+	/**
+	 * True if lhs and rhs have the same devices and holders and none is
+	 * modified.
+	 */
+	bool empty() const;
+
+	/**
+	 * Writes the difference to the log stream.
+	 */
+	void log(std::ostream& log) const;
+
+    private:
+
+	const Devicegraph::Impl& lhs;
+	const Devicegraph::Impl& rhs;
+
+	vector<DeviceEntry> created_devices;
+	vector<DeviceEntry> deleted_devices;
+	vector<DeviceEntry> common_devices;
+
+	vector<HolderEntry> created_holders;
+	vector<HolderEntry> deleted_holders;
+	vector<HolderEntry> common_holders;
+
+	void diff_devices();
+	void diff_holders();
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,606 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <fstream>
+#include <map>
+
+#include "storage/DevicegraphImageImpl.h"
+#include "storage/DevicegraphImpl.h"
+#include "storage/Devices/DeviceImpl.h"
+#include "storage/Devices/BlkDevice.h"
+#include "storage/Devices/PartitionTable.h"
+#include "storage/Filesystems/Filesystem.h"
+#include "storage/Filesystems/MountPoint.h"
+#include "storage/Holders/HolderImpl.h"
+#include "storage/Utils/ExceptionImpl.h"
+#include "storage/Utils/AppUtil.h"
+
+
+namespace storage
+{
+
+    using namespace std;
+
+
+    namespace
+    {
+
+	const char magic[8] = { 'L', 'S', 'N', 'G', 'I', 'M', 'G', '\n' };
+
+	const uint32_t version = 1;
+
+	const uint32_t byte_order = 0x01020304;
+
+
+	size_t
+	align(size_t offset)
+	{
+	    return (offset + 7) & ~size_t(7);
+	}
+
+
+	class StringPool
+	{
+	public:
+
+	    StringPool() : data(1, '\0') {}
+
+	    uint32_t add(const string& value)
+	    {
+		if (value.empty())
+		    return 0;
+
+		map<string, uint32_t>::const_iterator it = offsets.find(value);
+		if (it != offsets.end())
+		    return it->second;
+
+		uint32_t offset = data.size();
+		data.append(value);
+		data.push_back('\0');
+		offsets[value] = offset;
+
+		return offset;
+	    }
+
+	    const string& get_data() const { return data; }
+
+	private:
+
+	    string data;
+	    map<string, uint32_t> offsets;
+
+	};
+
+    }
+
+
+    DevicegraphImage::DevicegraphImage(const string& filename)
+	: impl(new Impl(filename))
+    {
+    }
+
+
+    DevicegraphImage::~DevicegraphImage()
+    {
+    }
+
+
+    void
+    DevicegraphImage::write(const Devicegraph* devicegraph, const string& filename)
+    {
+	Impl::write(devicegraph, filename);
+    }
+
+
+    size_t
+    DevicegraphImage::num_vertices() const
+    {
+	return get_impl().num_vertices();
+    }
+
+
+    size_t
+    DevicegraphImage::num_edges() const
+    {
+	return get_impl().num_edges();
+    }
+
+
+    boost::iterator_range<const DevicegraphImage::Vertex*>
+    DevicegraphImage::get_vertices() const
+    {
+	return get_impl().get_vertices();
+    }
+
+
+    boost::iterator_range<const DevicegraphImage::Edge*>
+    DevicegraphImage::get_edges() const
+    {
+	return get_impl().get_edges();
+    }
+
+
+    const DevicegraphImage::Vertex&
+    DevicegraphImage::find_by_sid(sid_t sid) const
+    {
+	return get_impl().find_by_sid(sid);
+    }
+
+
+    const DevicegraphImage::Vertex&
+    DevicegraphImage::find_by_name(const string& name) const
+    {
+	return get_impl().find_by_name(name);
+    }
+
+
+    vector<const DevicegraphImage::Vertex*>
+    DevicegraphImage::get_children(const Vertex& vertex) const
+    {
+	return get_impl().get_children(vertex);
+    }
+
+
+    vector<const DevicegraphImage::Vertex*>
+    DevicegraphImage::get_parents(const Vertex& vertex) const
+    {
+	return get_impl().get_parents(vertex);
+    }
+
+
+    boost::iterator_range<const DevicegraphImage::Edge*>
+    DevicegraphImage::get_out_edges(const Vertex& vertex) const
+    {
+	return get_impl().get_out_edges(vertex);
+    }
+
+
+    vector<const DevicegraphImage::Vertex*>
+    DevicegraphImage::get_vertices_of_class(const string& classname) const
+    {
+	return get_impl().get_vertices_of_class(classname);
+    }
+
+
+    vector<const DevicegraphImage::Vertex*>
+    DevicegraphImage::get_vertices_with_flags(uint32_t flags) const
+    {
+	return get_impl().get_vertices_with_flags(flags);
+    }
+
+
+    const DevicegraphImage::Vertex&
+    DevicegraphImage::get_source(const Edge& edge) const
+    {
+	return get_impl().get_source(edge);
+    }
+
+
+    const DevicegraphImage::Vertex&
+    DevicegraphImage::get_target(const Edge& edge) const
+    {
+	return get_impl().get_target(edge);
+    }
+
+
+    const char*
+    DevicegraphImage::get_string(uint32_t offset) const
+    {
+	return get_impl().get_string(offset);
+    }
+
+
+    void
+    DevicegraphImage::Impl::write(const Devicegraph* devicegraph, const string& filename)
+    {
+	typedef Devicegraph::Impl::vertex_descriptor vertex_descriptor;
+	typedef Devicegraph::Impl::edge_descriptor edge_descriptor;
+
+	const Devicegraph::Impl& impl = devicegraph->get_impl();
+
+	vector<vertex_descriptor> sorted_vertices(impl.vertices().begin(), impl.vertices().end());
+	sort(sorted_vertices.begin(), sorted_vertices.end(),
+	     [&impl](vertex_descriptor lhs, vertex_descriptor rhs) {
+		 return impl[lhs]->get_sid() < impl[rhs]->get_sid();
+	     });
+
+	map<vertex_descriptor, uint32_t> indexes;
+	for (size_t i = 0; i < sorted_vertices.size(); ++i)
+	    indexes[sorted_vertices[i]] = i;
+
+	StringPool string_pool;
+
+	vector<Vertex> vertices(sorted_vertices.size());
+	vector<Edge> edges;
+
+	for (size_t i = 0; i < sorted_vertices.size(); ++i)
+	{
+	    const Device* device = impl[sorted_vertices[i]];
+
+	    Vertex& vertex = vertices[i];
+	    memset(&vertex, 0, sizeof(vertex));
+
+	    vertex.sid = device->get_sid();
+	    vertex.classname = string_pool.add(device->get_impl().get_classname());
+	    vertex.displayname = string_pool.add(device->get_displayname());
+
+	    if (is_blk_device(device))
+	    {
+		const BlkDevice* blk_device = to_blk_device(device);
+		vertex.flags |= BLK_DEVICE;
+		vertex.name = string_pool.add(blk_device->get_name());
+		vertex.size = blk_device->get_size();
+	    }
+
+	    if (is_partition_table(device))
+		vertex.flags |= PARTITION_TABLE;
+
+	    if (is_filesystem(device))
+		vertex.flags |= FILESYSTEM;
+
+	    if (is_mount_point(device))
+		vertex.flags |= MOUNT_POINT;
+
+	    vector<edge_descriptor> out_edges(impl.out_edges(sorted_vertices[i]).begin(),
+					      impl.out_edges(sorted_vertices[i]).end());
+	    sort(out_edges.begin(), out_edges.end(),
+		 [&impl, &indexes](edge_descriptor lhs, edge_descriptor rhs) {
+		     return indexes[impl.target(lhs)] < indexes[impl.target(rhs)];
+		 });
+
+	    vertex.first_out_edge = edges.size();
+	    vertex.num_out_edges = out_edges.size();
+
+	    for (edge_descriptor out_edge : out_edges)
+	    {
+		Edge edge;
+		memset(&edge, 0, sizeof(edge));
+
+		edge.source = i;
+		edge.target = indexes[impl.target(out_edge)];
+		edge.classname = string_pool.add(impl[out_edge]->get_impl().get_classname());
+
+		edges.push_back(edge);
+	    }
+	}
+
+	// edges are sorted by source and target, so a stable sort by target
+	// gives the edges sorted by target and source
+
+	vector<uint32_t> in_edges(edges.size());
+	for (size_t i = 0; i < in_edges.size(); ++i)
+	    in_edges[i] = i;
+
+	stable_sort(in_edges.begin(), in_edges.end(), [&edges](uint32_t lhs, uint32_t rhs) {
+	    return edges[lhs].target < edges[rhs].target;
+	});
+
+	for (size_t i = 0; i < in_edges.size(); ++i)
+	{
+	    Vertex& vertex = vertices[edges[in_edges[i]].target];
+	    if (vertex.num_in_edges++ == 0)
+		vertex.first_in_edge = i;
+	}
+
+	vector<uint32_t> names;
+	for (size_t i = 0; i < vertices.size(); ++i)
+	    if (vertices[i].name != 0)
+		names.push_back(i);
+
+	const string& strings = string_pool.get_data();
+
+	sort(names.begin(), names.end(), [&vertices, &strings](uint32_t lhs, uint32_t rhs) {
+	    return strcmp(strings.c_str() + vertices[lhs].name, strings.c_str() + vertices[rhs].name) < 0;
+	});
+
+	Header header;
+	memset(&header, 0, sizeof(header));
+
+	memcpy(header.magic, magic, sizeof(magic));
+	header.version = version;
+	header.byte_order = byte_order;
+	header.num_vertices = vertices.size();
+	header.num_edges = edges.size();
+	header.num_names = names.size();
+	header.strings_size = strings.size();
+
+	header.vertices_offset = align(sizeof(Header));
+	header.edges_offset = align(header.vertices_offset + vertices.size() * sizeof(Vertex));
+	header.in_edges_offset = align(header.edges_offset + edges.size() * sizeof(Edge));
+	header.names_offset = align(header.in_edges_offset + in_edges.size() * sizeof(uint32_t));
+	header.strings_offset = align(header.names_offset + names.size() * sizeof(uint32_t));
+
+	string data(header.strings_offset + strings.size(), '\0');
+
+	memcpy(&data[0], &header, sizeof(header));
+	memcpy(&data[header.vertices_offset], vertices.data(), vertices.size() * sizeof(Vertex));
+	memcpy(&data[header.edges_offset], edges.data(), edges.size() * sizeof(Edge));
+	memcpy(&data[header.in_edges_offset], in_edges.data(), in_edges.size() * sizeof(uint32_t));
+	memcpy(&data[header.names_offset], names.data(), names.size() * sizeof(uint32_t));
+	memcpy(&data[header.strings_offset], strings.data(), strings.size());
+
+	ofstream file(filename, ios::binary | ios::trunc);
+	file.write(data.data(), data.size());
+	file.close();
+
+	if (!file)
+	    ST_THROW(Exception("failed to write devicegraph image " + filename));
+    }
+
+
+    DevicegraphImage::Impl::Impl(const string& filename)
+	: filename(filename), data(MAP_FAILED), data_size(0)
+    {
+	int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+	    ST_THROW(Exception("failed to open devicegraph image " + filename));
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(Header))
+	{
+	    close(fd);
+	    ST_THROW(Exception("invalid devicegraph image " + filename));
+	}
+
+	data_size = st.st_size;
+	data = mmap(nullptr, data_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	close(fd);
+
+	if (data == MAP_FAILED)
+	    ST_THROW(Exception("failed to map devicegraph image " + filename));
+
+	const char* base = (const char*) data;
+
+	header = (const Header*) base;
+
+	try
+	{
+	    check();
+	}
+	catch (...)
+	{
+	    munmap(data, data_size);
+	    throw;
+	}
+
+	vertices = (const Vertex*)(base + header->vertices_offset);
+	edges = (const Edge*)(base + header->edges_offset);
+	in_edges = (const uint32_t*)(base + header->in_edges_offset);
+	names = (const uint32_t*)(base + header->names_offset);
+	strings = base + header->strings_offset;
+    }
+
+
+    DevicegraphImage::Impl::~Impl()
+    {
+	munmap(data, data_size);
+    }
+
+
+    const char*
+    DevicegraphImage::Impl::get_string(uint32_t offset) const
+    {
+	// The offset is not necessarily taken from the image so check it
+	// and the terminator, even if check() found the string pool to be
+	// terminated.
+
+	if (offset >= header->strings_size ||
+	    !memchr(strings + offset, '\0', header->strings_size - offset))
+	    ST_THROW(Exception(sformat("invalid string offset %u in devicegraph image %s", offset,
+				       filename.c_str())));
+
+	return strings + offset;
+    }
+
+
+    void
+    DevicegraphImage::Impl::check() const
+    {
+	if (memcmp(header->magic, magic, sizeof(magic)) != 0)
+	    ST_THROW(Exception("wrong magic in devicegraph image " + filename));
+
+	if (header->byte_order != byte_order)
+	    ST_THROW(Exception("wrong byte order of devicegraph image " + filename));
+
+	if (header->version != version)
+	    ST_THROW(Exception(sformat("unsupported version %d of devicegraph image %s",
+				       header->version, filename.c_str())));
+
+	auto check_table = [this](uint64_t offset, uint64_t size) {
+	    if (offset % 8 != 0 || offset > data_size || size > data_size - offset)
+		ST_THROW(Exception("invalid table in devicegraph image " + filename));
+	};
+
+	check_table(header->vertices_offset, (uint64_t) header->num_vertices * sizeof(Vertex));
+	check_table(header->edges_offset, (uint64_t) header->num_edges * sizeof(Edge));
+	check_table(header->in_edges_offset, (uint64_t) header->num_edges * sizeof(uint32_t));
+	check_table(header->names_offset, (uint64_t) header->num_names * sizeof(uint32_t));
+	check_table(header->strings_offset, header->strings_size);
+
+	const char* base = (const char*) data;
+
+	// The string pool must start with an empty string and be
+	// terminated. References into the tables are checked so that
+	// queries cannot read outside of the image.
+
+	const char* tmp_strings = base + header->strings_offset;
+	if (header->strings_size == 0 || tmp_strings[0] != '\0' ||
+	    tmp_strings[header->strings_size - 1] != '\0')
+	    ST_THROW(Exception("invalid string pool in devicegraph image " + filename));
+
+	const Vertex* tmp_vertices = (const Vertex*)(base + header->vertices_offset);
+	for (uint32_t i = 0; i < header->num_vertices; ++i)
+	{
+	    const Vertex& vertex = tmp_vertices[i];
+
+	    if (vertex.classname >= header->strings_size || vertex.name >= header->strings_size ||
+		vertex.displayname >= header->strings_size ||
+		vertex.first_out_edge > header->num_edges ||
+		vertex.num_out_edges > header->num_edges - vertex.first_out_edge ||
+		vertex.first_in_edge > header->num_edges ||
+		vertex.num_in_edges > header->num_edges - vertex.first_in_edge)
+		ST_THROW(Exception("invalid vertex in devicegraph image " + filename));
+	}
+
+	const Edge* tmp_edges = (const Edge*)(base + header->edges_offset);
+	for (uint32_t i = 0; i < header->num_edges; ++i)
+	{
+	    const Edge& edge = tmp_edges[i];
+
+	    if (edge.source >= header->num_vertices || edge.target >= header->num_vertices ||
+		edge.classname >= header->strings_size)
+		ST_THROW(Exception("invalid edge in devicegraph image " + filename));
+	}
+
+	const uint32_t* tmp_in_edges = (const uint32_t*)(base + header->in_edges_offset);
+	for (uint32_t i = 0; i < header->num_edges; ++i)
+	{
+	    if (tmp_in_edges[i] >= header->num_edges)
+		ST_THROW(Exception("invalid in-edge in devicegraph image " + filename));
+	}
+
+	const uint32_t* tmp_names = (const uint32_t*)(base + header->names_offset);
+	for (uint32_t i = 0; i < header->num_names; ++i)
+	{
+	    if (tmp_names[i] >= header->num_vertices)
+		ST_THROW(Exception("invalid name in devicegraph image " + filename));
+	}
+    }
+
+
+    boost::iterator_range<const DevicegraphImage::Vertex*>
+    DevicegraphImage::Impl::get_vertices() const
+    {
+	return boost::make_iterator_range(vertices, vertices + header->num_vertices);
+    }
+
+
+    boost::iterator_range<const DevicegraphImage::Edge*>
+    DevicegraphImage::Impl::get_edges() const
+    {
+	return boost::make_iterator_range(edges, edges + header->num_edges);
+    }
+
+
+    const DevicegraphImage::Vertex&
+    DevicegraphImage::Impl::find_by_sid(sid_t sid) const
+    {
+	const Vertex* end = vertices + header->num_vertices;
+
+	const Vertex* it = lower_bound(vertices, end, sid, [](const Vertex& vertex, sid_t value) {
+	    return vertex.sid < value;
+	});
+
+	if (it == end || it->sid != sid)
+	    ST_THROW(DeviceNotFoundBySid(sid));
+
+	return *it;
+    }
+
+
+    const DevicegraphImage::Vertex&
+    DevicegraphImage::Impl::find_by_name(const string& name) const
+    {
+	const uint32_t* end = names + header->num_names;
+
+	const uint32_t* it = lower_bound(names, end, name, [this](uint32_t index, const string& value) {
+	    return strcmp(get_string(vertices[index].name), value.c_str()) < 0;
+	});
+
+	if (it == end || get_string(vertices[*it].name) != name)
+	    ST_THROW(DeviceNotFoundByName(name));
+
+	return vertices[*it];
+    }
+
+
+    vector<const DevicegraphImage::Vertex*>
+    DevicegraphImage::Impl::get_children(const Vertex& vertex) const
+    {
+	vector<const Vertex*> ret;
+	ret.reserve(vertex.num_out_edges);
+
+	for (const Edge& edge : get_out_edges(vertex))
+	    ret.push_back(&vertices[edge.target]);
+
+	return ret;
+    }
+
+
+    vector<const DevicegraphImage::Vertex*>
+    DevicegraphImage::Impl::get_parents(const Vertex& vertex) const
+    {
+	vector<const Vertex*> ret;
+	ret.reserve(vertex.num_in_edges);
+
+	for (uint32_t i = vertex.first_in_edge; i < vertex.first_in_edge + vertex.num_in_edges; ++i)
+	    ret.push_back(&vertices[edges[in_edges[i]].source]);
+
+	return ret;
+    }
+
+
+    boost::iterator_range<const DevicegraphImage::Edge*>
+    DevicegraphImage::Impl::get_out_edges(const Vertex& vertex) const
+    {
+	const Edge* begin = edges + vertex.first_out_edge;
+	return boost::make_iterator_range(begin, begin + vertex.num_out_edges);
+    }
+
+
+    vector<const DevicegraphImage::Vertex*>
+    DevicegraphImage::Impl::get_vertices_of_class(const string& classname) const
+    {
+	vector<const Vertex*> ret;
+
+	for (const Vertex& vertex : get_vertices())
+	{
+	    if (get_string(vertex.classname) == classname)
+		ret.push_back(&vertex);
+	}
+
+	return ret;
+    }
+
+
+    vector<const DevicegraphImage::Vertex*>
+    DevicegraphImage::Impl::get_vertices_with_flags(uint32_t flags) const
+    {
+	vector<const Vertex*> ret;
+
+	for (const Vertex& vertex : get_vertices())
+	{
+	    if ((vertex.flags & flags) == flags)
+		ret.push_back(&vertex);
+	}
+
+	return ret;
+    }
+
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#ifndef STORAGE_DEVICEGRAPH_IMAGE_H
+#define STORAGE_DEVICEGRAPH_IMAGE_H
+
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <boost/noncopyable.hpp>
+#include <boost/range/iterator_range.hpp>
+
+#include "storage/Devicegraph.h"
+
+
+namespace storage
+{
+
+    /**
+     * Read-only image of a devicegraph for tools that only query a saved
+     * devicegraph, e.g. names, sizes and holders of devices.
+     *
+     * The image is a file with fixed-layout tables of vertices and edges
+     * and a string pool. It is memory-mapped and queried in place, so
+     * opening it costs the same for any size of the devicegraph and no
+     * Device objects are created.
+     *
+     * Vertices are sorted by sid, edges by source and target. The in-edge
+     * table lists the edges sorted by target and source. The name table
+     * lists the vertices with a name sorted by name.
+     *
+     * The image uses the byte order of the machine that wrote it. Images
+     * of a different byte order or version are rejected.
+     */
+    class DevicegraphImage : private boost::noncopyable
+    {
+    public:
+
+	enum Flags : uint32_t
+	{
+	    BLK_DEVICE = 1 << 0,
+	    PARTITION_TABLE = 1 << 1,
+	    FILESYSTEM = 1 << 2,
+	    MOUNT_POINT = 1 << 3
+	};
+
+	struct Vertex
+	{
+	    uint32_t sid;
+	    uint32_t classname;
+	    uint32_t name;
+	    uint32_t displayname;
+	    uint32_t flags;
+	    uint32_t first_out_edge;
+	    uint32_t num_out_edges;
+	    uint32_t first_in_edge;
+	    uint32_t num_in_edges;
+	    uint32_t reserved;
+	    uint64_t size;
+	};
+
+	struct Edge
+	{
+	    uint32_t source;
+	    uint32_t target;
+	    uint32_t classname;
+	    uint32_t reserved;
+	};
+
+	/**
+	 * Writes the image of the devicegraph.
+	 *
+	 * @throw Exception
+	 */
+	static void write(const Devicegraph* devicegraph, const std::string& filename);
+
+	/**
+	 * Maps the image read-only.
+	 *
+	 * @throw Exception
+	 */
+	DevicegraphImage(const std::string& filename);
+
+	~DevicegraphImage();
+
+	size_t num_vertices() const;
+	size_t num_edges() const;
+
+	/**
+	 * The vertex and edge tables. Not available in the bindings, there
+	 * get_vertices_with_flags(0) returns all vertices.
+	 */
+	boost::iterator_range<const Vertex*> get_vertices() const;
+	boost::iterator_range<const Edge*> get_edges() const;
+
+	/**
+	 * @throw DeviceNotFoundBySid
+	 */
+	const Vertex& find_by_sid(sid_t sid) const;
+
+	/**
+	 * Find a block device by its name.
+	 *
+	 * @throw DeviceNotFoundByName
+	 */
+	const Vertex& find_by_name(const std::string& name) const;
+
+	std::vector<const Vertex*> get_children(const Vertex& vertex) const;
+	std::vector<const Vertex*> get_parents(const Vertex& vertex) const;
+
+	/**
+	 * Not available in the bindings.
+	 */
+	boost::iterator_range<const Edge*> get_out_edges(const Vertex& vertex) const;
+
+	/**
+	 * Vertices with the classname, e.g. "Disk", sorted by sid.
+	 */
+	std::vector<const Vertex*> get_vertices_of_class(const std::string& classname) const;
+
+	/**
+	 * Vertices with all of the flags, e.g. all block devices, sorted by
+	 * sid.
+	 */
+	std::vector<const Vertex*> get_vertices_with_flags(uint32_t flags) const;
+
+	const Vertex& get_source(const Edge& edge) const;
+	const Vertex& get_target(const Edge& edge) const;
+
+	/**
+	 * Returns a string of the string pool, e.g. the classname or the name
+	 * of a vertex. Throws an exception if the offset is not inside the
+	 * string pool.
+	 */
+	const char* get_string(uint32_t offset) const;
+
+    public:
+
+	class Impl;
+
+	Impl& get_impl() { return *impl; }
+	const Impl& get_impl() const { return *impl; }
+
+    private:
+
+	const std::unique_ptr<Impl> impl;
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#ifndef STORAGE_DEVICEGRAPH_IMAGE_IMPL_H
+#define STORAGE_DEVICEGRAPH_IMAGE_IMPL_H
+
+
+#include "storage/DevicegraphImage.h"
+
+
+namespace storage
+{
+
+    using std::string;
+    using std::vector;
+
+
+    class DevicegraphImage::Impl : private boost::noncopyable
+    {
+    public:
+
+	struct Header
+	{
+	    char magic[8];
+	    uint32_t version;
+	    uint32_t byte_order;
+	    uint32_t num_vertices;
+	    uint32_t num_edges;
+	    uint32_t num_names;
+	    uint32_t strings_size;
+	    uint64_t vertices_offset;
+	    uint64_t edges_offset;
+	    uint64_t in_edges_offset;
+	    uint64_t names_offset;
+	    uint64_t strings_offset;
+	};
+
+	/**
+	 * Writes the image of the devicegraph.
+	 *
+	 * @throw Exception
+	 */
+	static void write(const Devicegraph* devicegraph, const string& filename);
+
+	/**
+	 * Maps the image read-only.
+	 *
+	 * @throw Exception
+	 */
+	Impl(const string& filename);
+
+	~Impl();
+
+	size_t num_vertices() const { return header->num_vertices; }
+	size_t num_edges() const { return header->num_edges; }
+
+	boost::iterator_range<const Vertex*> get_vertices() const;
+	boost::iterator_range<const Edge*> get_edges() const;
+
+	const Vertex& find_by_sid(sid_t sid) const;
+	const Vertex& find_by_name(const string& name) const;
+
+	vector<const Vertex*> get_children(const Vertex& vertex) const;
+	vector<const Vertex*> get_parents(const Vertex& vertex) const;
+
+	boost::iterator_range<const Edge*> get_out_edges(const Vertex& vertex) const;
+
+	vector<const Vertex*> get_vertices_of_class(const string& classname) const;
+	vector<const Vertex*> get_vertices_with_flags(uint32_t flags) const;
+
+	const Vertex& get_source(const Edge& edge) const { return vertices[edge.source]; }
+	const Vertex& get_target(const Edge& edge) const { return vertices[edge.target]; }
+
+	const char* get_string(uint32_t offset) const;
+
+    private:
+
+	const string filename;
+
+	void* data;
+	size_t data_size;
+
+	const Header* header;
+	const Vertex* vertices;
+	const Edge* edges;
+	const uint32_t* in_edges;
+	const uint32_t* names;
+	const char* strings;
+
+	void check() const;
+
+    };
+
+}
+
+#endif
@@ -21,16 +21,24 @@
  */
 
 
-#include <boost/graph/copy.hpp>
+#include <atomic>
+#include <algorithm>
 #include <boost/graph/reverse_graph.hpp>
 #include <boost/graph/graphviz.hpp>
 #include <boost/graph/graph_utility.hpp>
+#include <boost/algorithm/string.hpp>
 
 #include "storage/DevicegraphImpl.h"
+#include "storage/DevicegraphDiffImpl.h"
 #include "storage/Utils/GraphUtils.h"
 #include "storage/Utils/XmlFile.h"
+#include "storage/Utils/BinaryFile.h"
 #include "storage/Utils/StorageTmpl.h"
 #include "storage/Utils/HumanString.h"
+#include "storage/Utils/MemoryPool.h"
+#include "storage/Utils/Parallel.h"
+#include "storage/Utils/HeapSize.h"
+#include "storage/DeviceQueryImpl.h"
 #include "storage/Devices/DeviceImpl.h"
 #include "storage/Devices/BlkDevice.h"
 #include "storage/Devices/Disk.h"
@@ -80,87 +88,176 @@
 namespace storage
 {
 
+    namespace
+    {
+
+	uint64_t
+	mix(uint64_t x)
+	{
+	    // finalizer of splitmix64
+
+	    x ^= x >> 30;
+	    x *= 0xbf58476d1ce4e5b9ULL;
+	    x ^= x >> 27;
+	    x *= 0x94d049bb133111ebULL;
+	    x ^= x >> 31;
+	    return x;
+	}
+
+
+	uint64_t
+	device_topology_hash(sid_t sid, const char* classname)
+	{
+	    return mix(mix(sid) ^ std::hash<string>()(classname));
+	}
+
+
+	uint64_t
+	holder_topology_hash(sid_t source_sid, sid_t target_sid, const char* classname)
+	{
+	    return mix(mix(mix(source_sid) ^ target_sid) ^ std::hash<string>()(classname));
+	}
+
+    }
+
+
+    unsigned long long
+    Devicegraph::Impl::next_instance_id()
+    {
+	static std::atomic<unsigned long long> instance_id(0);
+
+	return ++instance_id;
+    }
+
+
     bool
     Devicegraph::Impl::operator==(const Impl& rhs) const
     {
-	const set<sid_t> lhs_device_sids = get_device_sids();
-	const set<sid_t> rhs_device_sids = rhs.get_device_sids();
+	if (this == &rhs)
+	    return true;
 
-	if (lhs_device_sids != rhs_device_sids)
-	    return false;
+	// The cheap checks first.
 
-	const set<pair<sid_t, sid_t>> lhs_holder_sids = get_holder_sids();
-	const set<pair<sid_t, sid_t>> rhs_holder_sids = rhs.get_holder_sids();
+	if (num_devices() != rhs.num_devices() || num_holders() != rhs.num_holders())
+	    return false;
 
-	if (lhs_holder_sids != rhs_holder_sids)
+	if (topology_hash != rhs.topology_hash)
 	    return false;
 
-	for (sid_t sid : lhs_device_sids)
-	{
-	    vertex_descriptor lhs_vertex = find_vertex(sid);
-	    vertex_descriptor rhs_vertex = rhs.find_vertex(sid);
+	// If both devicegraphs were compared with each other before and the
+	// structure did not change only the devices and holders modified
+	// since then need to be compared. If nothing was modified the old
+	// result holds, e.g. when polling whether staging changed.
 
-	    if (*graph[lhs_vertex].get() != *rhs.graph[rhs_vertex].get())
-		return false;
-	}
+	bool equal;
 
-	for (pair<sid_t, sid_t> sid : lhs_holder_sids)
+	if (matches_equal_cache(rhs))
 	{
-	    edge_descriptor lhs_edge = find_edge(sid.first, sid.second);
-	    edge_descriptor rhs_edge = rhs.find_edge(sid.first, sid.second);
+	    if (uncompared_sids.empty() && uncompared_holders.empty() &&
+		rhs.uncompared_sids.empty() && rhs.uncompared_holders.empty())
+		return equal_cache.equal;
 
-	    if (*graph[lhs_edge].get() != *rhs.graph[rhs_edge].get())
-		return false;
+	    equal = equal_cache.equal ? equal_uncompared_devices_and_holders(rhs) :
+		equal_devices_and_holders(rhs);
+	}
+	else
+	{
+	    equal = equal_devices_and_holders(rhs);
 	}
 
-	return true;
+	equal_cache = { rhs.instance_id, generation, rhs.generation, equal };
+	rhs.equal_cache = { instance_id, rhs.generation, generation, equal };
+
+	uncompared_sids.clear();
+	uncompared_holders.clear();
+	rhs.uncompared_sids.clear();
+	rhs.uncompared_holders.clear();
+
+	return equal;
     }
 
 
-    void
-    Devicegraph::Impl::log_diff(std::ostream& log, const Impl& rhs) const
+    bool
+    Devicegraph::Impl::matches_equal_cache(const Impl& rhs) const
     {
-	// TODO
+	return equal_cache.other_instance_id == rhs.instance_id && equal_cache.generation == generation &&
+	    equal_cache.other_generation == rhs.generation &&
+	    rhs.equal_cache.other_instance_id == instance_id && rhs.equal_cache.generation == rhs.generation &&
+	    rhs.equal_cache.other_generation == generation;
+    }
+
 
-	const set<sid_t> lhs_device_sids = get_device_sids();
-	const set<sid_t> rhs_device_sids = rhs.get_device_sids();
+    bool
+    Devicegraph::Impl::equal_uncompared_devices_and_holders(const Impl& rhs) const
+    {
+	// The structure is unchanged and was equal so the devices and
+	// holders exist in both devicegraphs.
 
-	if (lhs_device_sids != rhs_device_sids)
-	    log << "device sids differ\n";
+	std::unordered_set<sid_t> sids(uncompared_sids);
+	sids.insert(rhs.uncompared_sids.begin(), rhs.uncompared_sids.end());
 
-	for (sid_t sid : lhs_device_sids)
+	for (sid_t sid : sids)
 	{
-	    vertex_descriptor lhs_vertex = find_vertex(sid);
-	    vertex_descriptor rhs_vertex = rhs.find_vertex(sid);
+	    if (*graph[find_vertex(sid)].get() != *rhs.graph[rhs.find_vertex(sid)].get())
+		return false;
+	}
 
-	    if (*graph[lhs_vertex].get() != *rhs.graph[rhs_vertex].get())
-		log << "sid " << sid << " device differ\n";
+	set<pair<sid_t, sid_t>> holders(uncompared_holders);
+	holders.insert(rhs.uncompared_holders.begin(), rhs.uncompared_holders.end());
 
-	    if (graph[lhs_vertex]->get_impl().get_classname() != graph[rhs_vertex]->get_impl().get_classname())
-		log << "devices with sid " << sid << " have different types\n";
-	    else
-		graph[lhs_vertex]->get_impl().log_diff(log, rhs.graph[rhs_vertex]->get_impl());
+	for (const pair<sid_t, sid_t>& holder : holders)
+	{
+	    if (*graph[find_edge(holder.first, holder.second)].get() !=
+		*rhs.graph[rhs.find_edge(holder.first, holder.second)].get())
+		return false;
 	}
 
-	const set<pair<sid_t, sid_t>> lhs_holder_sids = get_holder_sids();
-	const set<pair<sid_t, sid_t>> rhs_holder_sids = rhs.get_holder_sids();
+	return true;
+    }
+
 
-	if (lhs_holder_sids != rhs_holder_sids)
-	    log << "holder sids differ\n";
+    bool
+    Devicegraph::Impl::equal_devices_and_holders(const Impl& rhs) const
+    {
+	// Since the number of devices and holders is equal it is enough to
+	// look for the devices and holders of lhs in rhs.
 
-	for (pair<sid_t, sid_t> sid : lhs_holder_sids)
+	for (vertex_descriptor lhs_vertex : vertices())
 	{
-	    edge_descriptor lhs_edge = find_edge(sid.first, sid.second);
-	    edge_descriptor rhs_edge = rhs.find_edge(sid.first, sid.second);
+	    sid_index_t::const_iterator it = rhs.sid_index.find(graph[lhs_vertex]->get_sid());
+	    if (it == rhs.sid_index.end())
+		return false;
+
+	    if (*graph[lhs_vertex].get() != *rhs.graph[it->second.vertex].get())
+		return false;
+	}
 
-	    if (*graph[lhs_edge].get() != *rhs.graph[rhs_edge].get())
-		log << "sid " << sid.first << " " << sid.second << " holder differ\n";
+	for (edge_descriptor lhs_edge : edges())
+	{
+	    sid_index_t::const_iterator source_it = rhs.sid_index.find(graph[source(lhs_edge)]->get_sid());
+	    sid_index_t::const_iterator target_it = rhs.sid_index.find(graph[target(lhs_edge)]->get_sid());
 
-	    if (graph[lhs_edge]->get_impl().get_classname() != graph[rhs_edge]->get_impl().get_classname())
-		log << "holders with sids " << sid.first << " " << sid.second << " have different types\n";
-	    else
-		graph[lhs_edge]->get_impl().log_diff(log, rhs.graph[rhs_edge]->get_impl());
+	    if (source_it == rhs.sid_index.end() || target_it == rhs.sid_index.end())
+		return false;
+
+	    pair<edge_descriptor, bool> rhs_edge = boost::edge(source_it->second.vertex, target_it->second.vertex,
+							       rhs.graph);
+	    if (!rhs_edge.second)
+		return false;
+
+	    if (*graph[lhs_edge].get() != *rhs.graph[rhs_edge.first].get())
+		return false;
 	}
+
+	return true;
+    }
+
+
+    void
+    Devicegraph::Impl::log_diff(std::ostream& log, const Impl& rhs) const
+    {
+	DevicegraphDiff::Impl devicegraph_diff(*this, rhs);
+	devicegraph_diff.log(log);
     }
 
 
@@ -176,6 +273,8 @@ namespace storage
 	    set<const Holder*> holders;
 	    set<sid_t> sids;
 
+	    uint64_t tmp_topology_hash = 0;
+
 	    for (vertex_descriptor vertex : vertices())
 	    {
 		// check uniqueness of device object
@@ -190,13 +289,9 @@ namespace storage
 		if (!sids.insert(sid).second)
 		    ST_THROW(LogicException(sformat("sid %d not unique within graph", sid)));
 
-		// check device back reference
+		check_back_references(vertex);
 
-		if (&device->get_impl().get_devicegraph()->get_impl() != this)
-		    ST_THROW(LogicException("wrong graph in back references"));
-
-		if (device->get_impl().get_vertex() != vertex)
-		    ST_THROW(LogicException("wrong vertex in back references"));
+		tmp_topology_hash ^= device_topology_hash(sid, device->get_impl().get_classname());
 	    }
 
 	    for (edge_descriptor edge : edges())
@@ -207,253 +302,1473 @@ namespace storage
 		if (!holders.insert(holder).second)
 		    ST_THROW(LogicException("holder object not unique within graph"));
 
-		// check holder back reference
-
-		if (&holder->get_impl().get_devicegraph()->get_impl() != this)
-		    ST_THROW(LogicException("wrong graph in back references"));
+		check_back_references(edge);
 
-		if (holder->get_impl().get_edge() != edge)
-		    ST_THROW(LogicException("wrong edge in back references"));
+		tmp_topology_hash ^= holder_topology_hash(graph[source(edge)]->get_sid(),
+							  graph[target(edge)]->get_sid(),
+							  holder->get_impl().get_classname());
 	    }
+
+	    // check topology hash
+
+	    if (tmp_topology_hash != topology_hash)
+		ST_THROW(LogicException("wrong topology hash"));
 	}
 
 	{
 	    // look for cycles
 
-	    VertexIndexMapGenerator<graph_t> vertex_index_map_generator(graph);
-
 	    bool has_cycle = false;
 
 	    CycleDetector cycle_detector(has_cycle);
-	    boost::depth_first_search(graph, visitor(cycle_detector).
-				      vertex_index_map(vertex_index_map_generator.get()));
+	    boost::depth_first_search(graph, visitor(cycle_detector));
 
 	    if (has_cycle)
 		ST_THROW(Exception("devicegraph has a cycle"));
 	}
 
 	{
-	    for (vertex_descriptor vertex : vertices())
-	    {
-		const Device* device = graph[vertex].get();
-		device->get_impl().check(check_callbacks);
-	    }
+	    // the checks of the devices only read the devicegraph so they can
+	    // run in parallel, they run in vertex index order like in
+	    // check_incremental()
+
+	    check_devices(indexed_vertices, check_callbacks);
 	}
 
 	// TODO check that out-edges are consistent, e.g. of same type, only one per Subdevice
 	// TODO check that in-edges are consistent, e.g. of same type, exactly one for Partition
 	// in general subcheck for each device
+
+	clear_unchecked();
     }
 
 
-    uint64_t
-    Devicegraph::Impl::used_features() const
+    void
+    Devicegraph::Impl::check_incremental(const CheckCallbacks* check_callbacks) const
     {
-	uint64_t ret = 0;
+	if (unchecked_all)
+	{
+	    check(check_callbacks);
+	    return;
+	}
 
-	for (vertex_descriptor vertex : vertices())
+	// collect the touched devices still in the graph and their neighbours
+
+	vector<vertex_descriptor> touched_vertices;
+
+	for (sid_t sid : unchecked_sids)
 	{
-	    const Device* device = graph[vertex].get();
-	    ret |= device->get_impl().used_features();
+	    sid_index_t::const_iterator it = sid_index.find(sid);
+	    if (it == sid_index.end())
+		continue;
+
+	    vertex_descriptor vertex = it->second.vertex;
+
+	    touched_vertices.push_back(vertex);
+	    for (vertex_descriptor tmp : children(vertex))
+		touched_vertices.push_back(tmp);
+	    for (vertex_descriptor tmp : parents(vertex))
+		touched_vertices.push_back(tmp);
 	}
 
-	return ret;
+	// the order of unchecked_sids and of the vertex descriptors depends
+	// on the heap, sort by vertex index to get the order of the full
+	// check
+
+	sort(touched_vertices.begin(), touched_vertices.end(),
+	     [this](vertex_descriptor lhs, vertex_descriptor rhs) {
+		 return get_vertex_index(lhs) < get_vertex_index(rhs);
+	     });
+	touched_vertices.erase(unique(touched_vertices.begin(), touched_vertices.end()), touched_vertices.end());
+
+	{
+	    // check uniqueness of sid and device and holder back references
+
+	    for (vertex_descriptor vertex : touched_vertices)
+	    {
+		sid_t sid = graph[vertex]->get_sid();
+
+		sid_index_t::const_iterator it = sid_index.find(sid);
+		if (it == sid_index.end() || it->second.vertex != vertex)
+		    ST_THROW(LogicException(sformat("sid %d not unique within graph", sid)));
+
+		check_back_references(vertex);
+
+		for (edge_descriptor edge : out_edges(vertex))
+		    check_back_references(edge);
+	    }
+	}
+
+	{
+	    // look for cycles introduced by the new holders: a holder from
+	    // source to target closes a cycle iff the source is reachable from
+	    // the target
+
+	    for (const pair<sid_t, sid_t>& holder : unchecked_holders)
+	    {
+		sid_index_t::const_iterator source_it = sid_index.find(holder.first);
+		sid_index_t::const_iterator target_it = sid_index.find(holder.second);
+
+		if (source_it == sid_index.end() || target_it == sid_index.end())
+		    continue;
+
+		if (!boost::edge(source_it->second.vertex, target_it->second.vertex, graph).second)
+		    continue;
+
+		if (is_descendant(target_it->second.vertex, source_it->second.vertex, true))
+		    ST_THROW(Exception("devicegraph has a cycle"));
+	    }
+	}
+
+	check_devices(touched_vertices, check_callbacks);
+
+	clear_unchecked();
     }
 
 
-    bool
-    Devicegraph::Impl::is_probed() const
+    namespace
     {
-	return &(get_storage()->get_probed()->get_impl()) == this;
+
+	/**
+	 * CheckCallbacks collecting the error messages of one chunk of a
+	 * parallel check so that they can be forwarded in a deterministic
+	 * order afterwards.
+	 */
+	class BufferedCheckCallbacks : public CheckCallbacks
+	{
+	public:
+
+	    virtual void error(const string& message) const override { messages.push_back(message); }
+
+	    mutable vector<string> messages;
+
+	};
+
     }
 
 
-    bool
-    Devicegraph::Impl::is_staging() const
+    void
+    Devicegraph::Impl::check_devices(const vector<vertex_descriptor>& vertices,
+				     const CheckCallbacks* check_callbacks) const
     {
-	return &(get_storage()->get_staging()->get_impl()) == this;
+	const unsigned int num_threads = num_threads_for(vertices.size());
+
+	if (num_threads == 1)
+	{
+	    for (vertex_descriptor vertex : vertices)
+	    {
+		const Device* device = graph[vertex].get();
+		device->get_impl().check(check_callbacks);
+	    }
+
+	    return;
+	}
+
+	// Each chunk stops at its first exception. Forwarding the messages
+	// of all chunks up to the first failed one and rethrowing its
+	// exception gives the same result as the serial check.
+
+	vector<BufferedCheckCallbacks> buffers(num_threads);
+	vector<char> failed(num_threads, false);
+
+	try
+	{
+	    parallel_for_chunks(vertices.size(), num_threads,
+				[this, &vertices, check_callbacks, &buffers, &failed](unsigned int chunk,
+										      size_t begin, size_t end) {
+		try
+		{
+		    for (size_t i = begin; i < end; ++i)
+		    {
+			const Device* device = graph[vertices[i]].get();
+			device->get_impl().check(check_callbacks ? &buffers[chunk] : nullptr);
+		    }
+		}
+		catch (...)
+		{
+		    failed[chunk] = true;
+		    throw;
+		}
+	    });
+	}
+	catch (...)
+	{
+	    for (unsigned int chunk = 0; chunk < num_threads; ++chunk)
+	    {
+		for (const string& message : buffers[chunk].messages)
+		    check_callbacks->error(message);
+
+		if (failed[chunk])
+		    break;
+	    }
+
+	    throw;
+	}
+
+	if (check_callbacks)
+	{
+	    for (const BufferedCheckCallbacks& buffer : buffers)
+		for (const string& message : buffer.messages)
+		    check_callbacks->error(message);
+	}
     }
 
 
-    bool
-    Devicegraph::Impl::empty() const
+    void
+    Devicegraph::Impl::check_back_references(vertex_descriptor vertex) const
     {
-	return boost::num_vertices(graph) == 0;
+	const Device* device = graph[vertex].get();
+
+	// check device back reference
+
+	if (&device->get_impl().get_devicegraph()->get_impl() != this)
+	    ST_THROW(LogicException("wrong graph in back references"));
+
+	if (device->get_impl().get_vertex() != vertex)
+	    ST_THROW(LogicException("wrong vertex in back references"));
+
+	// check vertex index
+
+	size_t index = get_vertex_index(vertex);
+	if (index >= indexed_vertices.size() || indexed_vertices[index] != vertex)
+	    ST_THROW(LogicException("wrong vertex index"));
     }
 
 
-    size_t
-    Devicegraph::Impl::num_devices() const
+    void
+    Devicegraph::Impl::check_back_references(edge_descriptor edge) const
     {
-	return boost::num_vertices(graph);
+	const Holder* holder = graph[edge].get();
+
+	// check holder back reference
+
+	if (&holder->get_impl().get_devicegraph()->get_impl() != this)
+	    ST_THROW(LogicException("wrong graph in back references"));
+
+	if (holder->get_impl().get_edge() != edge)
+	    ST_THROW(LogicException("wrong edge in back references"));
     }
 
 
-    size_t
-    Devicegraph::Impl::num_holders() const
+    void
+    Devicegraph::Impl::add_unchecked(vertex_descriptor vertex)
     {
-	return boost::num_edges(graph);
+	const sid_t sid = graph[vertex]->get_sid();
+
+	unchecked_sids.insert(sid);
+	changed_sids.insert(sid);
     }
 
 
-    boost::iterator_range<Devicegraph::Impl::vertex_iterator>
-    Devicegraph::Impl::vertices() const
+    void
+    Devicegraph::Impl::clear_unchecked() const
     {
-	return boost::make_iterator_range(boost::vertices(graph));
+	unchecked_sids.clear();
+	unchecked_holders.clear();
+	unchecked_all = false;
     }
 
 
-    boost::iterator_range<Devicegraph::Impl::edge_iterator>
-    Devicegraph::Impl::edges() const
+    void
+    Devicegraph::Impl::clear_changes() const
     {
-	return boost::make_iterator_range(boost::edges(graph));
+	changed_sids.clear();
+	changed_all = false;
+	++changes_epoch;
     }
 
 
-    Devicegraph::Impl::vertex_descriptor
-    Devicegraph::Impl::add_vertex(Device* device)
+    uint64_t
+    Devicegraph::Impl::used_features() const
     {
-	return boost::add_vertex(shared_ptr<Device>(device), graph);
+	const vector<vertex_descriptor> tmp(vertices().begin(), vertices().end());
+
+	const unsigned int num_threads = num_threads_for(tmp.size());
+
+	vector<uint64_t> features(num_threads, 0);
+
+	parallel_for_chunks(tmp.size(), num_threads, [this, &tmp, &features](unsigned int chunk,
+									   size_t begin, size_t end) {
+	    for (size_t i = begin; i < end; ++i)
+	    {
+		const Device* device = graph[tmp[i]].get();
+		features[chunk] |= device->get_impl().used_features();
+	    }
+	});
+
+	uint64_t ret = 0;
+
+	for (uint64_t tmp_features : features)
+	    ret |= tmp_features;
+
+	return ret;
     }
 
 
-    Devicegraph::Impl::edge_descriptor
-    Devicegraph::Impl::add_edge(vertex_descriptor source_vertex, vertex_descriptor target_vertex,
-				Holder* holder)
+    namespace
     {
-	pair<Devicegraph::Impl::edge_descriptor, bool> tmp =
-	    boost::add_edge(source_vertex, target_vertex, shared_ptr<Holder>(holder), graph);
 
-	if (!tmp.second)
-	    ST_THROW(HolderAlreadyExists(graph[source_vertex]->get_sid(),
-					 graph[target_vertex]->get_sid()));
+	// Estimates of the memory used by the nodes of the containers of the
+	// graph and its indexes. A list node has two pointers, a red-black
+	// tree node three pointers and a color, a hash table node a next
+	// pointer and for string keys the cached hash.
+
+	const size_t list_node_size = 2 * sizeof(void*);
+	const size_t tree_node_size = 4 * sizeof(void*);
+	const size_t hash_node_size = sizeof(void*);
+
+	// Control block of a shared_ptr with its deleter and allocator.
+
+	const size_t control_block_size = 4 * sizeof(void*);
+
+
+	template <typename HashTable>
+	size_t
+	hash_table_heap_size(const HashTable& hash_table, size_t node_size)
+	{
+	    return hash_table.bucket_count() * sizeof(void*) + hash_table.size() * node_size;
+	}
+
+    }
+
+
+    MemoryUsage
+    Devicegraph::Impl::memory_usage() const
+    {
+	MemoryUsage ret;
+
+	for (vertex_descriptor vertex : vertices())
+	{
+	    const Device* device = graph[vertex].get();
+	    const Device::Impl& impl = device->get_impl();
+
+	    ret.devices[impl.get_classname()] += sizeof(Device) + impl.get_sizeof();
+	    ret.strings += impl.get_strings_heap_size();
+	    ret.userdata += impl.get_userdata_heap_size();
+
+	    // the vertex with its out- and in-edge sets and properties
+
+	    ret.graph += list_node_size + 2 * sizeof(std::set<edge_descriptor>) + sizeof(size_t) +
+		sizeof(shared_ptr<Device>) + control_block_size;
+	}
+
+	for (edge_descriptor edge : edges())
+	{
+	    const Holder* holder = graph[edge].get();
+	    const Holder::Impl& impl = holder->get_impl();
+
+	    ret.holders[impl.get_classname()] += sizeof(Holder) + impl.get_sizeof();
+
+	    // the edge in the out- and in-edge sets of its vertices and in the
+	    // edge list
+
+	    ret.graph += 2 * (tree_node_size + 2 * sizeof(void*)) + list_node_size + 2 * sizeof(void*) +
+		sizeof(shared_ptr<Holder>) + control_block_size;
+	}
+
+	ret.graph += hash_table_heap_size(sid_index, hash_node_size + sizeof(sid_index_t::value_type));
+
+	for (const string_index_t* string_index : { &name_index, &uuid_index })
+	{
+	    ret.graph += hash_table_heap_size(*string_index, hash_node_size + sizeof(size_t) +
+					      sizeof(string_index_t::value_type));
+
+	    for (const string_index_t::value_type& value : *string_index)
+		ret.graph += heap_size(value.first);
+	}
+
+	for (const map<string, Bucket>::value_type& value : class_index)
+	{
+	    ret.graph += tree_node_size + sizeof(value) + heap_size(value.first) +
+		value.second.entries.capacity() * sizeof(value.second.entries[0]);
+	}
+
+	ret.graph += indexed_vertices.capacity() * sizeof(vertex_descriptor);
+
+	ret.graph += hash_table_heap_size(unchecked_sids, hash_node_size + sizeof(sid_t)) +
+	    unchecked_holders.capacity() * sizeof(pair<sid_t, sid_t>) +
+	    hash_table_heap_size(changed_sids, hash_node_size + sizeof(sid_t)) +
+	    hash_table_heap_size(uncompared_sids, hash_node_size + sizeof(sid_t)) +
+	    uncompared_holders.size() * (tree_node_size + sizeof(pair<sid_t, sid_t>));
+
+	{
+	    std::lock_guard<std::mutex> lock(query_cache_mutex);
+
+	    ret.graph += query_cache.sizes.capacity() * sizeof(query_cache.sizes[0]) +
+		query_cache.names.capacity() * sizeof(query_cache.names[0]) +
+		hash_table_heap_size(query_cache.udev_ids, hash_node_size + sizeof(size_t) +
+				     sizeof(pair<const string, vertex_descriptor>));
+
+	    for (const pair<string, vertex_descriptor>& value : query_cache.names)
+		ret.graph += heap_size(value.first);
+
+	    for (const pair<const string, vertex_descriptor>& value : query_cache.udev_ids)
+		ret.graph += heap_size(value.first);
+	}
+
+	{
+	    std::lock_guard<std::mutex> lock(closure_cache_mutex);
+
+	    for (const std::unordered_map<vertex_descriptor, Closure>* closures :
+		     { &closure_cache.descendants, &closure_cache.ancestors })
+	    {
+		ret.graph += hash_table_heap_size(*closures, hash_node_size +
+						  sizeof(std::pair<const vertex_descriptor, Closure>));
+
+		for (const std::pair<const vertex_descriptor, Closure>& value : *closures)
+		{
+		    ret.graph += value.second.vertices.capacity() * sizeof(vertex_descriptor) +
+			value.second.sorted_indexes.capacity() * sizeof(size_t);
+		}
+	    }
+	}
+
+	return ret;
+    }
+
+
+    vector<Devicegraph::Impl::vertex_descriptor>
+    Devicegraph::Impl::query(const DeviceQuery& query) const
+    {
+	const DeviceQuery::Impl& query_impl = query.get_impl();
+
+	vector<vertex_descriptor> candidates;
+
+	{
+	    std::lock_guard<std::mutex> lock(query_cache_mutex);
+
+	    candidates = query_candidates(query_impl);
+	}
+
+	vector<vertex_descriptor> ret;
+
+	for (vertex_descriptor vertex : candidates)
+	{
+	    if (query_impl.matches(graph[vertex].get()))
+		ret.push_back(vertex);
+	}
+
+	sort(ret.begin(), ret.end(), [this](vertex_descriptor lhs, vertex_descriptor rhs) {
+	    return graph[lhs]->get_sid() < graph[rhs]->get_sid();
+	});
+
+	return ret;
+    }
+
+
+    vector<Devicegraph::Impl::vertex_descriptor>
+    Devicegraph::Impl::query_candidates(const DeviceQuery::Impl& query) const
+    {
+	if (query_cache.generation != generation || query_cache.modifications != modifications)
+	{
+	    query_cache = QueryCache();
+	    query_cache.generation = generation;
+	    query_cache.modifications = modifications;
+	}
+
+	vector<vertex_descriptor> ret;
+
+	if (query.check_uuid)
+	{
+	    for (const string_index_t::value_type& value : find_vertices_by_uuid(query.uuid))
+		ret.push_back(value.second);
+
+	    return ret;
+	}
+
+	if (query.check_name_prefix)
+	{
+	    if (!query_cache.has_names)
+	    {
+		query_cache.names.assign(name_index.begin(), name_index.end());
+		sort(query_cache.names.begin(), query_cache.names.end());
+		query_cache.has_names = true;
+	    }
+
+	    for (vector<pair<string, vertex_descriptor>>::const_iterator it =
+		     lower_bound(query_cache.names.begin(), query_cache.names.end(),
+				 make_pair(query.name_prefix, graph_t::null_vertex()));
+		 it != query_cache.names.end() && boost::starts_with(it->first, query.name_prefix); ++it)
+		ret.push_back(it->second);
+
+	    return ret;
+	}
+
+	if (query.check_min_size || query.check_max_size)
+	{
+	    if (!query_cache.has_sizes)
+	    {
+		for (vertex_descriptor vertex : vertices())
+		{
+		    const Device* device = graph[vertex].get();
+		    if (is_blk_device(device))
+			query_cache.sizes.emplace_back(to_blk_device(device)->get_size(), vertex);
+		}
+
+		sort(query_cache.sizes.begin(), query_cache.sizes.end());
+		query_cache.has_sizes = true;
+	    }
+
+	    typedef vector<pair<unsigned long long, vertex_descriptor>>::const_iterator const_iterator;
+
+	    const_iterator first = query_cache.sizes.begin();
+	    if (query.check_min_size)
+		first = lower_bound(query_cache.sizes.begin(), query_cache.sizes.end(),
+				    make_pair(query.min_size, graph_t::null_vertex()));
+
+	    for (const_iterator it = first; it != query_cache.sizes.end(); ++it)
+	    {
+		if (query.check_max_size && it->first > query.max_size)
+		    break;
+
+		ret.push_back(it->second);
+	    }
+
+	    return ret;
+	}
+
+	if (query.check_udev_id)
+	{
+	    if (!query_cache.has_udev_ids)
+	    {
+		for (vertex_descriptor vertex : vertices())
+		{
+		    const Device* device = graph[vertex].get();
+		    if (is_blk_device(device))
+		    {
+			for (const string& udev_id : to_blk_device(device)->get_udev_ids())
+			    query_cache.udev_ids.emplace(udev_id, vertex);
+		    }
+		}
+
+		query_cache.has_udev_ids = true;
+	    }
+
+	    for (const string_index_t::value_type& value :
+		     boost::make_iterator_range(query_cache.udev_ids.equal_range(query.udev_id)))
+		ret.push_back(value.second);
+
+	    return ret;
+	}
+
+	if (query.is_of_type)
+	    return vertices_of_type(query.is_of_type);
+
+	return indexed_vertices;
+    }
+
+
+    bool
+    Devicegraph::Impl::is_probed() const
+    {
+	return &(get_storage()->get_probed()->get_impl()) == this;
+    }
+
+
+    bool
+    Devicegraph::Impl::is_staging() const
+    {
+	return &(get_storage()->get_staging()->get_impl()) == this;
+    }
+
+
+    bool
+    Devicegraph::Impl::empty() const
+    {
+	return boost::num_vertices(graph) == 0;
+    }
+
+
+    size_t
+    Devicegraph::Impl::num_devices() const
+    {
+	return boost::num_vertices(graph);
+    }
+
+
+    size_t
+    Devicegraph::Impl::num_holders() const
+    {
+	return boost::num_edges(graph);
+    }
+
+
+    boost::iterator_range<Devicegraph::Impl::vertex_iterator>
+    Devicegraph::Impl::vertices() const
+    {
+	return boost::make_iterator_range(boost::vertices(graph));
+    }
+
+
+    boost::iterator_range<Devicegraph::Impl::edge_iterator>
+    Devicegraph::Impl::edges() const
+    {
+	return boost::make_iterator_range(boost::edges(graph));
+    }
+
+
+    Devicegraph::Impl::vertex_descriptor
+    Devicegraph::Impl::add_vertex(Device* device)
+    {
+	// The control block of the shared_ptr is allocated from the
+	// MemoryPool like the Impl of the device.
+
+	shared_ptr<Device> ptr(device, default_delete<Device>(), PoolAllocator<Device>());
+
+	vertex_descriptor vertex = add_vertex(ptr, next_sequence++);
+
+	if (is_journaling())
+	{
+	    savepoints.back().devices.insert(device);
+
+	    journal.emplace_back(JournalEntry::Type::ADD_VERTEX);
+	    journal.back().device = ptr;
+	}
+
+	return vertex;
+    }
+
+
+    Devicegraph::Impl::vertex_descriptor
+    Devicegraph::Impl::add_vertex(const shared_ptr<Device>& device, unsigned long long sequence)
+    {
+	// a duplicate sid can only be reported by a full check
+
+	if (sid_index.find(device->get_sid()) != sid_index.end())
+	    unchecked_all = true;
+
+	vertex_descriptor vertex = boost::add_vertex(graph_t::vertex_property_type(indexed_vertices.size(), device),
+						     graph);
+
+	indexed_vertices.push_back(vertex);
+
+	add_to_indexes(vertex, sequence);
+
+	toggle_topology_hash(vertex, device->get_sid());
+	++generation;
+
+	add_unchecked(vertex);
+
+	return vertex;
+    }
+
+
+    Devicegraph::Impl::edge_descriptor
+    Devicegraph::Impl::add_edge(vertex_descriptor source_vertex, vertex_descriptor target_vertex,
+				Holder* holder)
+    {
+	shared_ptr<Holder> ptr(holder, default_delete<Holder>(), PoolAllocator<Holder>());
+
+	edge_descriptor edge = add_edge(source_vertex, target_vertex, ptr);
+
+	if (is_journaling())
+	{
+	    savepoints.back().holders.insert(holder);
+
+	    journal.emplace_back(JournalEntry::Type::ADD_EDGE);
+	    journal.back().source_sid = graph[source_vertex]->get_sid();
+	    journal.back().target_sid = graph[target_vertex]->get_sid();
+	}
+
+	return edge;
+    }
+
+
+    Devicegraph::Impl::edge_descriptor
+    Devicegraph::Impl::add_edge(vertex_descriptor source_vertex, vertex_descriptor target_vertex,
+				const shared_ptr<Holder>& holder)
+    {
+	pair<Devicegraph::Impl::edge_descriptor, bool> tmp =
+	    boost::add_edge(source_vertex, target_vertex, holder, graph);
+
+	if (!tmp.second)
+	    ST_THROW(HolderAlreadyExists(graph[source_vertex]->get_sid(),
+					 graph[target_vertex]->get_sid()));
+
+	toggle_topology_hash(tmp.first, graph[source_vertex]->get_sid(), graph[target_vertex]->get_sid());
+	++generation;
+
+	add_unchecked(source_vertex);
+	add_unchecked(target_vertex);
+	unchecked_holders.emplace_back(graph[source_vertex]->get_sid(), graph[target_vertex]->get_sid());
+
+	// TODO should also set devicegraph and edge in holder but the
+	// devicegraph is not available here
+
+	return tmp.first;
+    }
+
+
+    bool
+    Devicegraph::Impl::device_exists(sid_t sid) const
+    {
+	return sid_index.find(sid) != sid_index.end();
+    }
+
+
+    bool
+    Devicegraph::Impl::holder_exists(sid_t source_sid, sid_t target_sid) const
+    {
+	sid_index_t::const_iterator source_it = sid_index.find(source_sid);
+	if (source_it == sid_index.end())
+	    return false;
+
+	sid_index_t::const_iterator target_it = sid_index.find(target_sid);
+	if (target_it == sid_index.end())
+	    return false;
+
+	return boost::edge(source_it->second.vertex, target_it->second.vertex, graph).second;
+    }
+
+
+    constexpr size_t Devicegraph::Impl::npos;
+
+
+    size_t
+    Devicegraph::Impl::get_local_index(sid_t sid) const
+    {
+	sid_index_t::const_iterator it = sid_index.find(sid);
+	if (it == sid_index.end())
+	    return npos;
+
+	return get_vertex_index(it->second.vertex);
+    }
+
+
+    Devicegraph::Impl::vertex_descriptor
+    Devicegraph::Impl::find_vertex(sid_t sid) const
+    {
+	sid_index_t::const_iterator it = sid_index.find(sid);
+	if (it == sid_index.end())
+	    ST_THROW(DeviceNotFoundBySid(sid));
+
+	return it->second.vertex;
+    }
+
+
+    Devicegraph::Impl::edge_descriptor
+    Devicegraph::Impl::find_edge(sid_t source_sid, sid_t target_sid) const
+    {
+	sid_index_t::const_iterator source_it = sid_index.find(source_sid);
+	sid_index_t::const_iterator target_it = sid_index.find(target_sid);
+
+	if (source_it != sid_index.end() && target_it != sid_index.end())
+	{
+	    pair<edge_descriptor, bool> tmp = boost::edge(source_it->second.vertex, target_it->second.vertex, graph);
+	    if (tmp.second)
+		return tmp.first;
+	}
+
+	ST_THROW(HolderNotFoundBySids(source_sid, target_sid));
+    }
+
+
+    Devicegraph::Impl::edge_descriptor
+    Devicegraph::Impl::set_source(edge_descriptor old_edge, vertex_descriptor source_vertex)
+    {
+	vertex_descriptor target_vertex = boost::target(old_edge, graph);
+
+	Holder* new_holder = graph[old_edge].get()->clone();
+
+	Devicegraph::Impl::edge_descriptor new_edge = add_edge(source_vertex, target_vertex,
+							       new_holder);
+
+	// set back-reference
+	new_holder->get_impl().set_edge(new_edge);
+
+	remove_edge(old_edge);
+
+	return new_edge;
+    }
+
+
+    namespace
+    {
+
+	void
+	insert_into_string_index(Devicegraph::Impl::string_index_t& index, const string& key,
+				 Devicegraph::Impl::vertex_descriptor vertex)
+	{
+	    if (!key.empty())
+		index.emplace(key, vertex);
+	}
+
+
+	void
+	erase_from_string_index(Devicegraph::Impl::string_index_t& index, const string& key,
+				Devicegraph::Impl::vertex_descriptor vertex)
+	{
+	    if (key.empty())
+		return;
+
+	    pair<Devicegraph::Impl::string_index_t::iterator, Devicegraph::Impl::string_index_t::iterator> range =
+		index.equal_range(key);
+
+	    for (Devicegraph::Impl::string_index_t::iterator it = range.first; it != range.second; ++it)
+	    {
+		if (it->second == vertex)
+		{
+		    index.erase(it);
+		    return;
+		}
+	    }
+	}
+
+    }
+
+
+    void
+    Devicegraph::Impl::add_to_indexes(vertex_descriptor vertex, unsigned long long sequence)
+    {
+	const Device* device = graph[vertex].get();
+	const Device::Impl& device_impl = device->get_impl();
+
+	sid_index[device_impl.get_sid()] = { vertex, sequence };
+
+	insert_into_string_index(name_index, device_impl.get_index_name(), vertex);
+	insert_into_string_index(uuid_index, device_impl.get_index_uuid(), vertex);
+
+	class_index[device_impl.get_classname()].insert(sequence, vertex);
+    }
+
+
+    void
+    Devicegraph::Impl::remove_from_indexes(vertex_descriptor vertex)
+    {
+	const Device* device = graph[vertex].get();
+	const Device::Impl& device_impl = device->get_impl();
+
+	Bucket& bucket = class_index[device_impl.get_classname()];
+
+	sid_index_t::iterator it = sid_index.find(device_impl.get_sid());
+	if (it != sid_index.end() && it->second.vertex == vertex)
+	{
+	    bucket.remove(it->second.sequence, vertex);
+	    sid_index.erase(it);
+	}
+	else
+	{
+	    // only possible with duplicate sids, see check()
+	    bucket.remove(vertex);
+	}
+
+	erase_from_string_index(name_index, device_impl.get_index_name(), vertex);
+	erase_from_string_index(uuid_index, device_impl.get_index_uuid(), vertex);
+    }
+
+
+    void
+    Devicegraph::Impl::change_sid(vertex_descriptor vertex, sid_t old_sid)
+    {
+	const Device::Impl& device_impl = graph[vertex]->get_impl();
+
+	if (sid_index.find(device_impl.get_sid()) != sid_index.end())
+	    unchecked_all = true;
+
+	IndexEntry index_entry;
+
+	sid_index_t::iterator it = sid_index.find(old_sid);
+	if (it != sid_index.end() && it->second.vertex == vertex)
+	{
+	    index_entry = it->second;
+	    sid_index.erase(it);
+	}
+	else
+	{
+	    // only possible with duplicate sids, see check()
+	    index_entry = { vertex, class_index[device_impl.get_classname()].find_sequence(vertex) };
+	}
+
+	sid_index[device_impl.get_sid()] = index_entry;
+
+	const sid_t new_sid = device_impl.get_sid();
+
+	toggle_topology_hash(vertex, old_sid);
+	toggle_topology_hash(vertex, new_sid);
+
+	add_unchecked(vertex);
+	changed_sids.insert(old_sid);
+
+	for (edge_descriptor edge : boost::make_iterator_range(boost::out_edges(vertex, graph)))
+	{
+	    sid_t target_sid = graph[boost::target(edge, graph)]->get_sid();
+	    toggle_topology_hash(edge, old_sid, target_sid);
+	    toggle_topology_hash(edge, new_sid, target_sid);
+	}
+
+	for (edge_descriptor edge : boost::make_iterator_range(boost::in_edges(vertex, graph)))
+	{
+	    sid_t source_sid = graph[boost::source(edge, graph)]->get_sid();
+	    toggle_topology_hash(edge, source_sid, old_sid);
+	    toggle_topology_hash(edge, source_sid, new_sid);
+	}
+
+	++generation;
+    }
+
+
+    void
+    Devicegraph::Impl::toggle_topology_hash(vertex_descriptor vertex, sid_t sid)
+    {
+	const Device* device = graph[vertex].get();
+
+	topology_hash ^= device_topology_hash(sid, device->get_impl().get_classname());
+    }
+
+
+    void
+    Devicegraph::Impl::toggle_topology_hash(edge_descriptor edge, sid_t source_sid, sid_t target_sid)
+    {
+	const Holder* holder = graph[edge].get();
+
+	topology_hash ^= holder_topology_hash(source_sid, target_sid, holder->get_impl().get_classname());
+    }
+
+
+    void
+    Devicegraph::Impl::change_name(vertex_descriptor vertex, const string& old_name)
+    {
+	erase_from_string_index(name_index, old_name, vertex);
+	insert_into_string_index(name_index, graph[vertex]->get_impl().get_index_name(), vertex);
+    }
+
+
+    void
+    Devicegraph::Impl::change_uuid(vertex_descriptor vertex, const string& old_uuid)
+    {
+	erase_from_string_index(uuid_index, old_uuid, vertex);
+	insert_into_string_index(uuid_index, graph[vertex]->get_impl().get_index_uuid(), vertex);
+    }
+
+
+    boost::iterator_range<Devicegraph::Impl::string_index_t::const_iterator>
+    Devicegraph::Impl::find_vertices_by_name(const string& name) const
+    {
+	return boost::make_iterator_range(name_index.equal_range(name));
+    }
+
+
+    boost::iterator_range<Devicegraph::Impl::string_index_t::const_iterator>
+    Devicegraph::Impl::find_vertices_by_uuid(const string& uuid) const
+    {
+	return boost::make_iterator_range(uuid_index.equal_range(uuid));
+    }
+
+
+    void
+    Devicegraph::Impl::Bucket::remove(unsigned long long sequence, vertex_descriptor vertex)
+    {
+	vector<pair<unsigned long long, vertex_descriptor>>::iterator it =
+	    lower_bound(entries.begin(), entries.end(), make_pair(sequence, graph_t::null_vertex()),
+			[](const pair<unsigned long long, vertex_descriptor>& lhs,
+			   const pair<unsigned long long, vertex_descriptor>& rhs) {
+			    return lhs.first < rhs.first;
+			});
+
+	if (it == entries.end() || it->second != vertex)
+	    ST_THROW(LogicException("vertex not found in class index"));
+
+	it->second = graph_t::null_vertex();
+
+	if (++num_removed > entries.size() / 2)
+	    compact();
+    }
+
+
+    void
+    Devicegraph::Impl::Bucket::remove(vertex_descriptor vertex)
+    {
+	for (pair<unsigned long long, vertex_descriptor>& entry : entries)
+	{
+	    if (entry.second == vertex)
+	    {
+		entry.second = graph_t::null_vertex();
+
+		if (++num_removed > entries.size() / 2)
+		    compact();
+
+		return;
+	    }
+	}
+
+	ST_THROW(LogicException("vertex not found in class index"));
+    }
+
+
+    void
+    Devicegraph::Impl::Bucket::insert(unsigned long long sequence, vertex_descriptor vertex)
+    {
+	if (entries.empty() || entries.back().first < sequence)
+	{
+	    entries.emplace_back(sequence, vertex);
+	    return;
+	}
+
+	// only when a removed vertex is added again, see rollback_to()
+
+	vector<pair<unsigned long long, vertex_descriptor>>::iterator it =
+	    lower_bound(entries.begin(), entries.end(), make_pair(sequence, graph_t::null_vertex()),
+			[](const pair<unsigned long long, vertex_descriptor>& lhs,
+			   const pair<unsigned long long, vertex_descriptor>& rhs) {
+			    return lhs.first < rhs.first;
+			});
+
+	if (it != entries.end() && it->first == sequence)
+	{
+	    if (it->second != graph_t::null_vertex())
+		ST_THROW(LogicException("duplicate sequence in class index"));
+
+	    it->second = vertex;
+	    --num_removed;
+	}
+	else
+	{
+	    entries.emplace(it, sequence, vertex);
+	}
+    }
+
+
+    unsigned long long
+    Devicegraph::Impl::Bucket::find_sequence(vertex_descriptor vertex) const
+    {
+	for (const pair<unsigned long long, vertex_descriptor>& entry : entries)
+	{
+	    if (entry.second == vertex)
+		return entry.first;
+	}
+
+	ST_THROW(LogicException("vertex not found in class index"));
+    }
+
+
+    void
+    Devicegraph::Impl::Bucket::compact()
+    {
+	entries.erase(remove_if(entries.begin(), entries.end(),
+				[](const pair<unsigned long long, vertex_descriptor>& entry) {
+				    return entry.second == graph_t::null_vertex();
+				}), entries.end());
+
+	num_removed = 0;
+    }
+
+
+    vector<Devicegraph::Impl::vertex_descriptor>
+    Devicegraph::Impl::vertices_of_type(std::function<bool(const Device*)> is_of_type) const
+    {
+	// Check one device per bucket. Since all devices in a bucket have the
+	// same class the result holds for the whole bucket.
+
+	vector<const Bucket*> buckets;
+	size_t size = 0;
+
+	for (const map<string, Bucket>::value_type& key_value : class_index)
+	{
+	    const Bucket& bucket = key_value.second;
+
+	    for (const pair<unsigned long long, vertex_descriptor>& entry : bucket.entries)
+	    {
+		if (entry.second == graph_t::null_vertex())
+		    continue;
+
+		if (is_of_type(graph[entry.second].get()))
+		{
+		    buckets.push_back(&bucket);
+		    size += bucket.entries.size() - bucket.num_removed;
+		}
+
+		break;
+	    }
+	}
+
+	vector<vertex_descriptor> ret;
+	ret.reserve(size);
+
+	if (buckets.size() == 1)
+	{
+	    for (const pair<unsigned long long, vertex_descriptor>& entry : buckets.front()->entries)
+	    {
+		if (entry.second != graph_t::null_vertex())
+		    ret.push_back(entry.second);
+	    }
+	}
+	else if (!buckets.empty())
+	{
+	    // merge the buckets to keep the insertion order of the vertices
+
+	    vector<pair<unsigned long long, vertex_descriptor>> tmp;
+	    tmp.reserve(size);
+
+	    for (const Bucket* bucket : buckets)
+	    {
+		for (const pair<unsigned long long, vertex_descriptor>& entry : bucket->entries)
+		{
+		    if (entry.second != graph_t::null_vertex())
+			tmp.push_back(entry);
+		}
+	    }
+
+	    sort(tmp.begin(), tmp.end(), [](const pair<unsigned long long, vertex_descriptor>& lhs,
+					    const pair<unsigned long long, vertex_descriptor>& rhs) {
+		return lhs.first < rhs.first;
+	    });
+
+	    for (const pair<unsigned long long, vertex_descriptor>& entry : tmp)
+		ret.push_back(entry.second);
+	}
+
+	return ret;
+    }
+
+
+    void
+    Devicegraph::Impl::clear()
+    {
+	// remove the vertices one by one so that they are recorded in the
+	// journal
+
+	if (is_journaling())
+	{
+	    while (!indexed_vertices.empty())
+		remove_vertex(indexed_vertices.back());
+	}
+
+	graph.clear();
+	indexed_vertices.clear();
+	sid_index.clear();
+	name_index.clear();
+	uuid_index.clear();
+	class_index.clear();
+	topology_hash = 0;
+	++generation;
+	clear_unchecked();
+	changed_all = true;
+    }
+
+
+    void
+    Devicegraph::Impl::remove_vertex(vertex_descriptor vertex)
+    {
+	if (is_journaling())
+	{
+	    // the edges are removed together with the vertex and must be
+	    // added again after the vertex
+
+	    vector<edge_descriptor> tmp;
+
+	    for (edge_descriptor edge : boost::make_iterator_range(boost::out_edges(vertex, graph)))
+		tmp.push_back(edge);
+
+	    for (edge_descriptor edge : boost::make_iterator_range(boost::in_edges(vertex, graph)))
+		tmp.push_back(edge);
+
+	    for (edge_descriptor edge : tmp)
+	    {
+		journal.emplace_back(JournalEntry::Type::REMOVE_EDGE);
+		journal.back().holder = graph[edge];
+		journal.back().source_sid = graph[boost::source(edge, graph)]->get_sid();
+		journal.back().target_sid = graph[boost::target(edge, graph)]->get_sid();
+	    }
+
+	    const Device* device = graph[vertex].get();
+
+	    sid_index_t::const_iterator it = sid_index.find(device->get_sid());
+
+	    journal.emplace_back(JournalEntry::Type::REMOVE_VERTEX);
+	    journal.back().device = graph[vertex];
+	    journal.back().sequence = it != sid_index.end() && it->second.vertex == vertex ? it->second.sequence :
+		class_index[device->get_impl().get_classname()].find_sequence(vertex);
+	}
+
+	remove_from_indexes(vertex);
+
+	const sid_t sid = graph[vertex]->get_sid();
+
+	toggle_topology_hash(vertex, sid);
+
+	for (edge_descriptor edge : boost::make_iterator_range(boost::out_edges(vertex, graph)))
+	    toggle_topology_hash(edge, sid, graph[boost::target(edge, graph)]->get_sid());
+
+	for (edge_descriptor edge : boost::make_iterator_range(boost::in_edges(vertex, graph)))
+	    toggle_topology_hash(edge, graph[boost::source(edge, graph)]->get_sid(), sid);
+
+	++generation;
+
+	changed_sids.insert(sid);
+
+	for (vertex_descriptor tmp : children(vertex))
+	    add_unchecked(tmp);
+	for (vertex_descriptor tmp : parents(vertex))
+	    add_unchecked(tmp);
+
+	// keep the vertex index dense by moving the last vertex into the gap
+
+	size_t index = get_vertex_index(vertex);
+	vertex_descriptor last = indexed_vertices.back();
+	indexed_vertices[index] = last;
+	boost::put(boost::vertex_index, graph, last, index);
+	indexed_vertices.pop_back();
+
+	boost::clear_vertex(vertex, graph);
+	boost::remove_vertex(vertex, graph);
+    }
+
+
+    void
+    Devicegraph::Impl::remove_edge(edge_descriptor edge)
+    {
+	if (is_journaling())
+	{
+	    journal.emplace_back(JournalEntry::Type::REMOVE_EDGE);
+	    journal.back().holder = graph[edge];
+	    journal.back().source_sid = graph[boost::source(edge, graph)]->get_sid();
+	    journal.back().target_sid = graph[boost::target(edge, graph)]->get_sid();
+	}
+
+	toggle_topology_hash(edge, graph[boost::source(edge, graph)]->get_sid(),
+			     graph[boost::target(edge, graph)]->get_sid());
+	++generation;
+
+	add_unchecked(boost::source(edge, graph));
+	add_unchecked(boost::target(edge, graph));
+
+	boost::remove_edge(edge, graph);
+    }
+
+
+    void
+    Devicegraph::Impl::swap(Devicegraph::Impl& x)
+    {
+	// the journals refer to the devicegraphs before the swap
+
+	discard_journal();
+	x.discard_journal();
 
-	// TODO should also set devicegraph and edge in holder but the
-	// devicegraph is not available here
+	graph.swap(x.graph);
+	indexed_vertices.swap(x.indexed_vertices);
+	sid_index.swap(x.sid_index);
+	name_index.swap(x.name_index);
+	uuid_index.swap(x.uuid_index);
+	class_index.swap(x.class_index);
+	std::swap(next_sequence, x.next_sequence);
+	std::swap(topology_hash, x.topology_hash);
 
-	return tmp.first;
-    }
+	// both devicegraphs changed so both need a generation not used
+	// before by either of them
 
+	generation = x.generation = max(generation, x.generation) + 1;
 
-    set<sid_t>
-    Devicegraph::Impl::get_device_sids() const
-    {
-	set<sid_t> sids;
-	for (vertex_descriptor vertex : vertices())
-	    sids.insert(graph[vertex]->get_sid());
-	return sids;
+	// the back references of the devices and holders are not updated so
+	// only a full check is meaningful
+
+	unchecked_all = x.unchecked_all = true;
+	changed_all = x.changed_all = true;
     }
 
 
-    set<pair<sid_t, sid_t>>
-    Devicegraph::Impl::get_holder_sids() const
+    unsigned int
+    Devicegraph::Impl::begin_savepoint()
     {
-	set<pair<sid_t, sid_t>> sids;
-	for (edge_descriptor edge : edges())
-	    sids.insert(make_pair(graph[edge]->get_source_sid(), graph[edge]->get_target_sid()));
-	return sids;
+	savepoints.emplace_back(journal.size());
+
+	return savepoints.size() - 1;
     }
 
 
-    bool
-    Devicegraph::Impl::device_exists(sid_t sid) const
+    void
+    Devicegraph::Impl::rollback_to(unsigned int savepoint)
     {
-	for (vertex_descriptor vertex : vertices())
-	{
-	    if (graph[vertex]->get_sid() == sid)
-		return true;
-	}
+	if (savepoint >= savepoints.size())
+	    ST_THROW(Exception(sformat("unknown savepoint %d", savepoint)));
 
-	return false;
-    }
+	const size_t position = savepoints[savepoint].position;
 
+	rolling_back = true;
 
-    bool
-    Devicegraph::Impl::holder_exists(sid_t source_sid, sid_t target_sid) const
-    {
-	for (edge_descriptor edge : edges())
+	try
 	{
-	    if (graph[source(edge)]->get_sid() == source_sid &&
-		graph[target(edge)]->get_sid() == target_sid)
-		return true;
+	    while (journal.size() > position)
+	    {
+		undo(journal.back());
+		journal.pop_back();
+	    }
+	}
+	catch (...)
+	{
+	    rolling_back = false;
+	    throw;
 	}
 
-	return false;
+	rolling_back = false;
+
+	savepoints.erase(savepoints.begin() + savepoint + 1, savepoints.end());
+	savepoints.back().devices.clear();
+	savepoints.back().holders.clear();
     }
 
 
-    Devicegraph::Impl::vertex_descriptor
-    Devicegraph::Impl::find_vertex(sid_t sid) const
+    void
+    Devicegraph::Impl::release(unsigned int savepoint)
     {
-	for (vertex_descriptor vertex : vertices())
+	if (savepoint >= savepoints.size())
+	    ST_THROW(Exception(sformat("unknown savepoint %d", savepoint)));
+
+	if (savepoint == 0)
 	{
-	    if (graph[vertex]->get_sid() == sid)
-		return vertex;
+	    discard_journal();
+	    return;
 	}
 
-	ST_THROW(DeviceNotFoundBySid(sid));
-     }
+	// the changes now belong to the previous savepoint
 
+	Savepoint& previous = savepoints[savepoint - 1];
 
-    Devicegraph::Impl::edge_descriptor
-    Devicegraph::Impl::find_edge(sid_t source_sid, sid_t target_sid) const
-    {
-	for (edge_descriptor edge : edges())
+	for (size_t i = savepoint; i < savepoints.size(); ++i)
 	{
-	    if (graph[source(edge)]->get_sid() == source_sid &&
-		graph[target(edge)]->get_sid() == target_sid)
-		return edge;
+	    previous.devices.insert(savepoints[i].devices.begin(), savepoints[i].devices.end());
+	    previous.holders.insert(savepoints[i].holders.begin(), savepoints[i].holders.end());
 	}
 
-	ST_THROW(HolderNotFoundBySids(source_sid, target_sid));
+	savepoints.erase(savepoints.begin() + savepoint, savepoints.end());
     }
 
 
-    Devicegraph::Impl::edge_descriptor
-    Devicegraph::Impl::set_source(edge_descriptor old_edge, vertex_descriptor source_vertex)
+    void
+    Devicegraph::Impl::discard_journal()
     {
-	vertex_descriptor target_vertex = boost::target(old_edge, graph);
+	journal.clear();
+	savepoints.clear();
+    }
 
-	Holder* new_holder = graph[old_edge].get()->clone();
 
-	Devicegraph::Impl::edge_descriptor new_edge = add_edge(source_vertex, target_vertex,
-							       new_holder);
+    void
+    Devicegraph::Impl::journal_device(vertex_descriptor vertex)
+    {
+	// undo() does the bookkeeping itself, the vertex of a device being
+	// added again is not valid here
 
-	// set back-reference
-	new_holder->get_impl().set_edge(new_edge);
+	if (rolling_back)
+	    return;
 
-	remove_edge(old_edge);
+	++modifications;
 
-	return new_edge;
+	add_unchecked(vertex);
+	uncompared_sids.insert(graph[vertex]->get_sid());
+
+	if (is_journaling())
+	    record_device(vertex);
     }
 
 
     void
-    Devicegraph::Impl::clear()
+    Devicegraph::Impl::journal_holder(edge_descriptor edge)
     {
-	graph.clear();
+	if (rolling_back)
+	    return;
+
+	++modifications;
+
+	add_unchecked(boost::source(edge, graph));
+	add_unchecked(boost::target(edge, graph));
+	uncompared_holders.emplace(graph[boost::source(edge, graph)]->get_sid(),
+				   graph[boost::target(edge, graph)]->get_sid());
+
+	if (is_journaling())
+	    record_holder(edge);
     }
 
 
     void
-    Devicegraph::Impl::remove_vertex(vertex_descriptor vertex)
+    Devicegraph::Impl::record_device(vertex_descriptor vertex)
     {
-	boost::clear_vertex(vertex, graph);
-	boost::remove_vertex(vertex, graph);
+	const shared_ptr<Device>& device = graph[vertex];
+
+	if (!savepoints.back().devices.insert(device.get()).second)
+	    return;
+
+	const Device* tmp = device.get();
+
+	journal.emplace_back(JournalEntry::Type::MODIFY_DEVICE);
+	journal.back().device = device;
+	journal.back().device_snapshot.reset(tmp->get_impl().clone());
     }
 
 
     void
-    Devicegraph::Impl::remove_edge(edge_descriptor edge)
+    Devicegraph::Impl::record_holder(edge_descriptor edge)
     {
-	boost::remove_edge(edge, graph);
+	const shared_ptr<Holder>& holder = graph[edge];
+
+	if (!savepoints.back().holders.insert(holder.get()).second)
+	    return;
+
+	const Holder* tmp = holder.get();
+
+	journal.emplace_back(JournalEntry::Type::MODIFY_HOLDER);
+	journal.back().holder = holder;
+	journal.back().holder_snapshot.reset(tmp->get_impl().clone());
     }
 
 
     void
-    Devicegraph::Impl::swap(Devicegraph::Impl& x)
+    Devicegraph::Impl::undo(const JournalEntry& journal_entry)
     {
-	graph.swap(x.graph);
+	switch (journal_entry.type)
+	{
+	    case JournalEntry::Type::ADD_VERTEX:
+	    {
+		const Device* device = journal_entry.device.get();
+		remove_vertex(device->get_impl().get_vertex());
+	    }
+	    break;
+
+	    case JournalEntry::Type::REMOVE_VERTEX:
+	    {
+		// the vertex in the back references of the device is the
+		// removed one and must not be used
+
+		vertex_descriptor vertex = add_vertex(journal_entry.device, journal_entry.sequence);
+		journal_entry.device->get_impl().set_vertex(vertex);
+	    }
+	    break;
+
+	    case JournalEntry::Type::ADD_EDGE:
+		remove_edge(find_edge(journal_entry.source_sid, journal_entry.target_sid));
+		break;
+
+	    case JournalEntry::Type::REMOVE_EDGE:
+	    {
+		edge_descriptor edge = add_edge(find_vertex(journal_entry.source_sid),
+						find_vertex(journal_entry.target_sid), journal_entry.holder);
+		journal_entry.holder->get_impl().set_edge(edge);
+	    }
+	    break;
+
+	    case JournalEntry::Type::MODIFY_DEVICE:
+	    {
+		journal_entry.device->get_impl().restore(*journal_entry.device_snapshot);
+
+		const Device* device = journal_entry.device.get();
+
+		++modifications;
+		add_unchecked(device->get_impl().get_vertex());
+		uncompared_sids.insert(device->get_sid());
+	    }
+	    break;
+
+	    case JournalEntry::Type::MODIFY_HOLDER:
+	    {
+		journal_entry.holder->get_impl().restore(*journal_entry.holder_snapshot);
+
+		const Holder* holder = journal_entry.holder.get();
+
+		++modifications;
+		add_unchecked(source(holder->get_impl().get_edge()));
+		add_unchecked(target(holder->get_impl().get_edge()));
+		uncompared_holders.emplace(holder->get_source_sid(), holder->get_target_sid());
+	    }
+	    break;
+	}
     }
 
 
@@ -491,21 +1806,17 @@ namespace storage
     }
 
 
-    vector<Devicegraph::Impl::vertex_descriptor>
+    boost::iterator_range<Devicegraph::Impl::adjacency_iterator>
     Devicegraph::Impl::children(vertex_descriptor vertex) const
     {
-	boost::iterator_range<adjacency_iterator> range =
-	    boost::make_iterator_range(boost::adjacent_vertices(vertex, graph));
-	return vector<vertex_descriptor>(range.begin(), range.end());
+	return boost::make_iterator_range(boost::adjacent_vertices(vertex, graph));
     }
 
 
-    vector<Devicegraph::Impl::vertex_descriptor>
+    boost::iterator_range<Devicegraph::Impl::inv_adjacency_iterator>
     Devicegraph::Impl::parents(vertex_descriptor vertex) const
     {
-	boost::iterator_range<inv_adjacency_iterator> range =
-	    boost::make_iterator_range(boost::inv_adjacent_vertices(vertex, graph));
-	return vector<vertex_descriptor>(range.begin(), range.end());
+	return boost::make_iterator_range(boost::inv_adjacent_vertices(vertex, graph));
     }
 
 
@@ -530,43 +1841,84 @@ namespace storage
     }
 
 
-    vector<Devicegraph::Impl::vertex_descriptor>
-    Devicegraph::Impl::descendants(vertex_descriptor vertex, bool itself) const
+    const Devicegraph::Impl::Closure&
+    Devicegraph::Impl::get_closure(vertex_descriptor vertex, bool reverse) const
     {
-	vector<vertex_descriptor> ret;
+	if (closure_cache.generation != generation)
+	{
+	    closure_cache.descendants.clear();
+	    closure_cache.ancestors.clear();
+	    closure_cache.generation = generation;
+	}
 
-	VertexIndexMapGenerator<graph_t> vertex_index_map_generator(graph);
+	std::unordered_map<vertex_descriptor, Closure>& closures = reverse ? closure_cache.ancestors :
+	    closure_cache.descendants;
 
-	VertexRecorder<vertex_descriptor> vertex_recorder(false, ret);
+	std::unordered_map<vertex_descriptor, Closure>::const_iterator it = closures.find(vertex);
+	if (it != closures.end())
+	    return it->second;
 
-	boost::breadth_first_search(graph, vertex, visitor(vertex_recorder).
-				    vertex_index_map(vertex_index_map_generator.get()));
+	Closure closure;
 
-	if (!itself)
-	    ret.erase(remove(ret.begin(), ret.end(), vertex), ret.end());
+	VertexRecorder<vertex_descriptor> vertex_recorder(false, closure.vertices);
 
-	return ret;
+	if (!reverse)
+	{
+	    boost::breadth_first_search(graph, vertex, visitor(vertex_recorder));
+	}
+	else
+	{
+	    typedef boost::reverse_graph<graph_t> reverse_graph_t;
+
+	    reverse_graph_t reverse_graph(graph);
+
+	    boost::breadth_first_search(reverse_graph, vertex, visitor(vertex_recorder));
+	}
+
+	closure.sorted_indexes.reserve(closure.vertices.size());
+	for (vertex_descriptor tmp : closure.vertices)
+	    closure.sorted_indexes.push_back(get_vertex_index(tmp));
+	sort(closure.sorted_indexes.begin(), closure.sorted_indexes.end());
+
+	return closures.emplace(vertex, std::move(closure)).first->second;
     }
 
 
     vector<Devicegraph::Impl::vertex_descriptor>
-    Devicegraph::Impl::ancestors(vertex_descriptor vertex, bool itself) const
+    Devicegraph::Impl::descendants(vertex_descriptor vertex, bool itself) const
     {
+	std::lock_guard<std::mutex> lock(closure_cache_mutex);
+
+	const Closure& closure = get_closure(vertex, false);
+
 	vector<vertex_descriptor> ret;
+	ret.reserve(closure.vertices.size());
+
+	for (vertex_descriptor tmp : closure.vertices)
+	{
+	    if (itself || tmp != vertex)
+		ret.push_back(tmp);
+	}
 
-	typedef boost::reverse_graph<graph_t> reverse_graph_t;
+	return ret;
+    }
 
-	reverse_graph_t reverse_graph(graph);
 
-	VertexIndexMapGenerator<reverse_graph_t> vertex_index_map_generator(reverse_graph);
+    vector<Devicegraph::Impl::vertex_descriptor>
+    Devicegraph::Impl::ancestors(vertex_descriptor vertex, bool itself) const
+    {
+	std::lock_guard<std::mutex> lock(closure_cache_mutex);
 
-	VertexRecorder<vertex_descriptor> vertex_recorder(false, ret);
+	const Closure& closure = get_closure(vertex, true);
 
-	boost::breadth_first_search(reverse_graph, vertex, visitor(vertex_recorder).
-				    vertex_index_map(vertex_index_map_generator.get()));
+	vector<vertex_descriptor> ret;
+	ret.reserve(closure.vertices.size());
 
-	if (!itself)
-	    ret.erase(remove(ret.begin(), ret.end(), vertex), ret.end());
+	for (vertex_descriptor tmp : closure.vertices)
+	{
+	    if (itself || tmp != vertex)
+		ret.push_back(tmp);
+	}
 
 	return ret;
     }
@@ -575,17 +1927,17 @@ namespace storage
     vector<Devicegraph::Impl::vertex_descriptor>
     Devicegraph::Impl::leaves(vertex_descriptor vertex, bool itself) const
     {
-	vector<vertex_descriptor> ret;
+	std::lock_guard<std::mutex> lock(closure_cache_mutex);
 
-	VertexIndexMapGenerator<graph_t> vertex_index_map_generator(graph);
+	const Closure& closure = get_closure(vertex, false);
 
-	VertexRecorder<vertex_descriptor> vertex_recorder(true, ret);
-
-	boost::breadth_first_search(graph, vertex, visitor(vertex_recorder).
-				    vertex_index_map(vertex_index_map_generator.get()));
+	vector<vertex_descriptor> ret;
 
-	if (!itself)
-	    ret.erase(remove(ret.begin(), ret.end(), vertex), ret.end());
+	for (vertex_descriptor tmp : closure.vertices)
+	{
+	    if ((itself || tmp != vertex) && boost::out_degree(tmp, graph) == 0)
+		ret.push_back(tmp);
+	}
 
 	return ret;
     }
@@ -594,23 +1946,34 @@ namespace storage
     vector<Devicegraph::Impl::vertex_descriptor>
     Devicegraph::Impl::roots(vertex_descriptor vertex, bool itself) const
     {
+	std::lock_guard<std::mutex> lock(closure_cache_mutex);
+
+	const Closure& closure = get_closure(vertex, true);
+
 	vector<vertex_descriptor> ret;
 
-	typedef boost::reverse_graph<graph_t> reverse_graph_t;
+	for (vertex_descriptor tmp : closure.vertices)
+	{
+	    if ((itself || tmp != vertex) && boost::in_degree(tmp, graph) == 0)
+		ret.push_back(tmp);
+	}
 
-	reverse_graph_t reverse_graph(graph);
+	return ret;
+    }
 
-	VertexIndexMapGenerator<reverse_graph_t> vertex_index_map_generator(graph);
 
-	VertexRecorder<vertex_descriptor> vertex_recorder(true, ret);
+    bool
+    Devicegraph::Impl::is_descendant(vertex_descriptor vertex, vertex_descriptor descendant, bool itself) const
+    {
+	if (vertex == descendant)
+	    return itself;
 
-	boost::breadth_first_search(reverse_graph, vertex, visitor(vertex_recorder).
-				    vertex_index_map(vertex_index_map_generator.get()));
+	std::lock_guard<std::mutex> lock(closure_cache_mutex);
 
-	if (!itself)
-	    ret.erase(remove(ret.begin(), ret.end(), vertex), ret.end());
+	const Closure& closure = get_closure(vertex, false);
 
-	return ret;
+	return binary_search(closure.sorted_indexes.begin(), closure.sorted_indexes.end(),
+			     get_vertex_index(descendant));
     }
 
 
@@ -634,25 +1997,56 @@ namespace storage
     }
 
 
-    vector<Devicegraph::Impl::edge_descriptor>
+    boost::iterator_range<Devicegraph::Impl::in_edge_iterator>
     Devicegraph::Impl::in_edges(vertex_descriptor vertex) const
     {
-	boost::iterator_range<in_edge_iterator> range =
-	    boost::make_iterator_range(boost::in_edges(vertex, graph));
-	return vector<edge_descriptor>(range.begin(), range.end());
+	return boost::make_iterator_range(boost::in_edges(vertex, graph));
     }
 
 
-    vector<Devicegraph::Impl::edge_descriptor>
+    boost::iterator_range<Devicegraph::Impl::out_edge_iterator>
     Devicegraph::Impl::out_edges(vertex_descriptor vertex) const
     {
-	boost::iterator_range<out_edge_iterator> range =
-	    boost::make_iterator_range(boost::out_edges(vertex, graph));
-	return vector<edge_descriptor>(range.begin(), range.end());
+	return boost::make_iterator_range(boost::out_edges(vertex, graph));
     }
 
 
-    typedef std::function<Device* (Devicegraph* devicegraph, const xmlNode* node)> device_load_fnc;
+    void
+    Devicegraph::Impl::copy(Devicegraph& dest) const
+    {
+	// Copy vertices and edges in one pass each. The edges are connected
+	// via the sid index of the destination like during load() so that
+	// no vertex index map of this graph is needed. The indexes of the
+	// destination are sized upfront. The devices and holders are cloned
+	// since sharing them copy-on-write is not possible, see
+	// doc/design-decisions.md.
+
+	Impl& dest_impl = dest.get_impl();
+
+	dest_impl.clear();
+
+	dest_impl.sid_index.reserve(num_devices());
+
+	for (vertex_descriptor vertex : vertices())
+	{
+	    Device* device = graph[vertex]->clone();
+
+	    vertex_descriptor dest_vertex = dest_impl.add_vertex(device);
+	    device->get_impl().set_devicegraph_and_vertex(&dest, dest_vertex);
+	}
+
+	for (edge_descriptor edge : edges())
+	{
+	    Holder* holder = graph[edge]->clone();
+
+	    vertex_descriptor dest_source = dest_impl.find_vertex(graph[source(edge)]->get_sid());
+	    vertex_descriptor dest_target = dest_impl.find_vertex(graph[target(edge)]->get_sid());
+
+	    edge_descriptor dest_edge = dest_impl.add_edge(dest_source, dest_target, holder);
+	    holder->get_impl().set_devicegraph_and_edge(&dest, dest_edge);
+	}
+    }
+
 
     const map<string, device_load_fnc> device_load_registry = {
 	{ "Disk", &Disk::load },
@@ -710,44 +2104,67 @@ namespace storage
 
 	clear();
 
-	XmlFile xml(filename);
+	if (is_binary_file(filename))
+	{
+	    load_binary(devicegraph, filename);
+	    return;
+	}
+
+	// The xml file is streamed so that only one device or holder is in
+	// memory at a time. Since holders refer to devices by sid the
+	// devices must come first, as written by save().
 
-	const xmlNode* root_node = xml.getRootElement();
-	if (!root_node)
+	XmlReader reader(filename);
+
+	if (!reader.next_element())
 	    ST_THROW(Exception("root node not found"));
 
-	const xmlNode* devicegraph_node = getChildNode(root_node, "Devicegraph");
-	if (!devicegraph_node)
+	if (reader.get_name() != string("Devicegraph"))
 	    ST_THROW(Exception("Devicegraph node not found"));
 
-	const xmlNode* devices_node = getChildNode(devicegraph_node, "Devices");
-	if (devices_node)
+	enum class Section { NONE, DEVICES, HOLDERS };
+
+	Section section = Section::NONE;
+
+	while (reader.next_element())
 	{
-	    for (const xmlNode* device_node : getChildNodes(devices_node))
+	    const string name = reader.get_name();
+
+	    if (reader.get_depth() == 1)
 	    {
-		const string& classname = (const char*) device_node->parent->name;
+		if (name == "Devices")
+		    section = Section::DEVICES;
+		else if (name == "Holders")
+		    section = Section::HOLDERS;
+		else
+		    section = Section::NONE;
+
+		continue;
+	    }
+
+	    if (reader.get_depth() != 2 || section == Section::NONE)
+		continue;
 
-		map<string, device_load_fnc>::const_iterator it = device_load_registry.find(classname);
+	    const xmlNode* node = reader.expand();
+	    if (!node)
+		continue;
+
+	    if (section == Section::DEVICES)
+	    {
+		map<string, device_load_fnc>::const_iterator it = device_load_registry.find(name);
 		if (it == device_load_registry.end())
-		    ST_THROW(Exception(sformat("unknown device class name %s", classname.c_str())));
+		    ST_THROW(Exception(sformat("unknown device class name %s", name.c_str())));
 
-		const Device* device = it->second(devicegraph, device_node);
+		const Device* device = it->second(devicegraph, node);
 		Device::Impl::raise_global_sid(device->get_sid());
 	    }
-	}
-
-	const xmlNode* holders_node = getChildNode(devicegraph_node, "Holders");
-	if (holders_node)
-	{
-	    for (const xmlNode* holder_node : getChildNodes(holders_node))
+	    else
 	    {
-		const string& classname = (const char*) holder_node->parent->name;
-
-		map<string, holder_load_fnc>::const_iterator it = holder_load_registry.find(classname);
+		map<string, holder_load_fnc>::const_iterator it = holder_load_registry.find(name);
 		if (it == holder_load_registry.end())
-		    ST_THROW(Exception(sformat("unknown holder class name %s", classname.c_str())));
+		    ST_THROW(Exception(sformat("unknown holder class name %s", name.c_str())));
 
-		it->second(devicegraph, holder_node);
+		it->second(devicegraph, node);
 	    }
 	}
     }
@@ -756,6 +2173,23 @@ namespace storage
     void
     Devicegraph::Impl::save(const string& filename) const
     {
+	const vector<vertex_descriptor> all_vertices(vertices().begin(), vertices().end());
+	const vector<edge_descriptor> all_edges(edges().begin(), edges().end());
+
+	save(filename, all_vertices, all_edges);
+    }
+
+
+    void
+    Devicegraph::Impl::save(const string& filename, const vector<vertex_descriptor>& vertices,
+			    const vector<edge_descriptor>& edges) const
+    {
+	if (has_binary_file_extension(filename))
+	{
+	    save_binary(filename, vertices, edges);
+	    return;
+	}
+
 	XmlFile xml;
 
 	xmlNode* devicegraph_node = xmlNewNode("Devicegraph");
@@ -766,7 +2200,7 @@ namespace storage
 
 	xmlNode* devices_node = xmlNewChild(devicegraph_node, "Devices");
 
-	for (vertex_descriptor vertex : vertices())
+	for (vertex_descriptor vertex : vertices)
 	{
 	    const Device* device = graph[vertex].get();
 	    xmlNode* device_node = xmlNewChild(devices_node, device->get_impl().get_classname());
@@ -775,7 +2209,7 @@ namespace storage
 
 	xmlNode* holders_node = xmlNewChild(devicegraph_node, "Holders");
 
-	for (edge_descriptor edge : edges())
+	for (edge_descriptor edge : edges)
 	{
 	    const Holder* holder = graph[edge].get();
 	    xmlNode* holder_node = xmlNewChild(holders_node, holder->get_impl().get_classname());
@@ -786,6 +2220,118 @@ namespace storage
     }
 
 
+    void
+    Devicegraph::Impl::load_binary(Devicegraph* devicegraph, const string& filename)
+    {
+	BinaryFileReader reader(filename);
+
+	// Each device and holder is restored from a small xml node holding
+	// only its own data so that the load functions of all classes can be
+	// used unchanged. So the xml file is not parsed and no document for
+	// the whole devicegraph is built, but the attributes are still stored
+	// as strings and converted by the load functions of the classes. The
+	// sids are also set as strings since the load functions read them
+	// from the node. See BinaryFile.h for the scope of the format.
+
+	typedef std::unique_ptr<xmlNode, void(*)(xmlNode*)> node_ptr;
+
+	const uint32_t num_devices = reader.read_uint32();
+
+	sid_index.reserve(num_devices);
+
+	for (uint32_t i = 0; i < num_devices; ++i)
+	{
+	    const size_t end = reader.begin_record();
+
+	    const string& classname = reader.read_string();
+
+	    map<string, device_load_fnc>::const_iterator it = device_load_registry.find(classname);
+	    if (it == device_load_registry.end())
+		ST_THROW(Exception(sformat("unknown device class name %s", classname.c_str())));
+
+	    node_ptr device_node(xmlNewNode(classname.c_str()), &xmlFreeNode);
+	    setChildValue(device_node.get(), "sid", reader.read_uint32());
+	    reader.read_xml_children(device_node.get());
+
+	    const Device* device = it->second(devicegraph, device_node->children);
+	    Device::Impl::raise_global_sid(device->get_sid());
+
+	    reader.end_record(end);
+	}
+
+	const uint32_t num_holders = reader.read_uint32();
+
+	for (uint32_t i = 0; i < num_holders; ++i)
+	{
+	    const size_t end = reader.begin_record();
+
+	    const string& classname = reader.read_string();
+
+	    map<string, holder_load_fnc>::const_iterator it = holder_load_registry.find(classname);
+	    if (it == holder_load_registry.end())
+		ST_THROW(Exception(sformat("unknown holder class name %s", classname.c_str())));
+
+	    node_ptr holder_node(xmlNewNode(classname.c_str()), &xmlFreeNode);
+	    setChildValue(holder_node.get(), "source-sid", reader.read_uint32());
+	    setChildValue(holder_node.get(), "target-sid", reader.read_uint32());
+	    reader.read_xml_children(holder_node.get());
+
+	    it->second(devicegraph, holder_node->children);
+
+	    reader.end_record(end);
+	}
+    }
+
+
+    void
+    Devicegraph::Impl::save_binary(const string& filename, const vector<vertex_descriptor>& vertices,
+				   const vector<edge_descriptor>& edges) const
+    {
+	BinaryFileWriter writer;
+
+	typedef std::unique_ptr<xmlNode, void(*)(xmlNode*)> node_ptr;
+
+	writer.write_uint32(vertices.size());
+
+	for (vertex_descriptor vertex : vertices)
+	{
+	    const Device* device = graph[vertex].get();
+
+	    const size_t position = writer.begin_record();
+
+	    writer.write_string(device->get_impl().get_classname());
+	    writer.write_uint32(device->get_sid());
+
+	    node_ptr device_node(xmlNewNode(device->get_impl().get_classname()), &xmlFreeNode);
+	    device->save(device_node.get());
+	    writer.write_xml_children(device_node.get(), { "sid" });
+
+	    writer.end_record(position);
+	}
+
+	writer.write_uint32(edges.size());
+
+	for (edge_descriptor edge : edges)
+	{
+	    const Holder* holder = graph[edge].get();
+
+	    const size_t position = writer.begin_record();
+
+	    writer.write_string(holder->get_impl().get_classname());
+	    writer.write_uint32(graph[source(edge)]->get_sid());
+	    writer.write_uint32(graph[target(edge)]->get_sid());
+
+	    node_ptr holder_node(xmlNewNode(holder->get_impl().get_classname()), &xmlFreeNode);
+	    holder->save(holder_node.get());
+	    writer.write_xml_children(holder_node.get(), { "source-sid", "target-sid" });
+
+	    writer.end_record(position);
+	}
+
+	writer.save(filename);
+    }
+
+
     void
     Devicegraph::Impl::print(std::ostream& out) const
     {
@@ -952,35 +2498,82 @@ namespace storage
 	    }
 	};
 
+	/**
+	 * Opens the file, calls write_body() and checks for errors.
+	 */
+	void
+	write_graphviz_file(const string& filename, const std::function<void(ostream& out)>& write_body)
+	{
+	    ofstream fout(filename);
+
+	    fout << "// " << generated_string() << "\n\n";
+
+	    // TODO write same rank stuff, should be possible in write_graph
+
+	    // TODO the node must include device name (or better some unique id) to
+	    // detect clicked objects in YaST
+
+	    // TODO in the long run a filesystem must support several mount points, so
+	    // boost::write_graphviz might not be able to handle our needs (or the
+	    // needs of YaST).  Just keep a write_graphviz function here for debugging
+	    // and move the thing YaST needs to yast2-storage.
+
+	    write_body(fout);
+
+	    fout.close();
+
+	    if (!fout.good())
+		ST_THROW(Exception(sformat("failed to write '%s'", filename.c_str())));
+	}
+
     }
 
 
     void
     Devicegraph::Impl::write_graphviz(const string& filename, GraphvizFlags graphviz_flags) const
     {
-	ofstream fout(filename);
+	write_graphviz_file(filename, [this, graphviz_flags](ostream& out) {
+	    boost::write_graphviz(out, graph, write_vertex(*this, graphviz_flags), write_edge(*this),
+				  write_graph(*this), boost::get(boost::vertex_index, graph));
+	});
+    }
+
+
+    void
+    Devicegraph::Impl::write_graphviz(const string& filename, GraphvizFlags graphviz_flags,
+				      const vector<vertex_descriptor>& vertices,
+				      const vector<edge_descriptor>& edges) const
+    {
+	// Writes only the given vertices and edges in the same format as
+	// boost::write_graphviz() so the time does not depend on the size of
+	// the whole devicegraph.
 
-	fout << "// " << generated_string() << "\n\n";
+	write_graphviz_file(filename, [this, graphviz_flags, &vertices, &edges](ostream& out) {
 
-	// TODO write same rank stuff, should be possible in write_graph
+	    const write_vertex vertex_writer(*this, graphviz_flags);
+	    const write_edge edge_writer(*this);
 
-	// TODO the node must include device name (or better some unique id) to
-	// detect clicked objects in YaST
+	    out << "digraph G {" << '\n';
 
-	// TODO in the long run a filesystem must support several mount points, so
-	// boost::write_graphviz might not be able to handle our needs (or the
-	// needs of YaST).  Just keep a write_graphviz function here for debugging
-	// and move the thing YaST needs to yast2-storage.
+	    write_graph(*this)(out);
 
-	VertexIndexMapGenerator<graph_t> vertex_index_map_generator(graph);
+	    for (vertex_descriptor vertex : vertices)
+	    {
+		out << get_vertex_index(vertex);
+		vertex_writer(out, vertex);
+		out << ";" << '\n';
+	    }
 
-	boost::write_graphviz(fout, graph, write_vertex(*this, graphviz_flags), write_edge(*this),
-			      write_graph(*this), vertex_index_map_generator.get());
+	    for (edge_descriptor edge : edges)
+	    {
+		out << get_vertex_index(source(edge)) << "->" << get_vertex_index(target(edge)) << " ";
+		edge_writer(out, edge);
+		out << ";" << '\n';
+	    }
 
-	fout.close();
+	    out << "}" << '\n';
 
-	if (!fout.good())
-	    ST_THROW(Exception(sformat("failed to write '%s'", filename.c_str())));
+	});
     }
 
 }
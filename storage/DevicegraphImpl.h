@@ -26,8 +26,15 @@
 
 
 #include <set>
+#include <map>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 #include <boost/noncopyable.hpp>
 #include <boost/graph/adjacency_list.hpp>
+#include <boost/range/adaptor/filtered.hpp>
+#include <boost/range/adaptor/transformed.hpp>
 
 #include "storage/Devices/Device.h"
 #include "storage/Devices/BlkDevice.h"
@@ -40,9 +47,19 @@ namespace storage
     using std::string;
     using std::vector;
     using std::set;
+    using std::map;
     using std::pair;
 
 
+    typedef std::function<Device* (Devicegraph* devicegraph, const xmlNode* node)> device_load_fnc;
+
+    /**
+     * Maps the classnames of all device classes that can be loaded to
+     * their load functions.
+     */
+    extern const map<string, device_load_fnc> device_load_registry;
+
+
     class Devicegraph::Impl : private boost::noncopyable
     {
 
@@ -58,8 +75,15 @@ namespace storage
 	// properties, see:
 	// http://www.boost.org/doc/libs/1_56_0/libs/graph/doc/bundles.html
 
+	// Since VertexList=boost::listS provides no vertex index the vertices
+	// additionally have an internal vertex_index property. It is kept
+	// dense (in the range [0, num_devices())) by add_vertex() and
+	// remove_vertex() so that algorithms can use vector based property
+	// maps without generating a vertex index map for each call.
+
 	typedef boost::adjacency_list<boost::setS, boost::listS, boost::bidirectionalS,
-				      std::shared_ptr<Device>, std::shared_ptr<Holder>> graph_t;
+				      boost::property<boost::vertex_index_t, size_t, std::shared_ptr<Device>>,
+				      std::shared_ptr<Holder>> graph_t;
 
 	typedef graph_t::vertex_descriptor vertex_descriptor;
 	typedef graph_t::edge_descriptor edge_descriptor;
@@ -75,15 +99,55 @@ namespace storage
 
 	typedef graph_t::vertices_size_type vertices_size_type;
 
+	typedef std::unordered_multimap<string, vertex_descriptor> string_index_t;
+
 	Impl(const Storage* storage) : storage(storage) {}
 
 	bool operator==(const Impl& rhs) const;
 	bool operator!=(const Impl& rhs) const { return !(*this == rhs); }
 
+	/**
+	 * Checks all devices and holders.
+	 */
 	void check(const CheckCallbacks* check_callbacks) const;
 
+	/**
+	 * Only checks the devices and holders added, removed or connected
+	 * differently since the last successful check, and their
+	 * neighbours. Only cycles closed by new holders are looked for.
+	 * Modified attributes of devices are only validated by check().
+	 */
+	void check_incremental(const CheckCallbacks* check_callbacks) const;
+
+	/**
+	 * The sids of devices check_incremental() would check, apart from
+	 * the neighbours. Only meaningful if is_unchecked_all() is false.
+	 */
+	const std::unordered_set<sid_t>& get_unchecked_sids() const { return unchecked_sids; }
+	bool is_unchecked_all() const { return unchecked_all; }
+
+	/**
+	 * The sids of the devices added, removed or modified and of the
+	 * devices whose holders changed since the last clear_changes(). Used
+	 * to calculate actiongraphs incrementally. Only meaningful if
+	 * is_changed_all() is false, otherwise the changes are unknown, e.g.
+	 * after load() or swap().
+	 */
+	const std::unordered_set<sid_t>& get_changed_sids() const { return changed_sids; }
+	bool is_changed_all() const { return changed_all; }
+
+	/**
+	 * Forgets the changes and starts a new epoch. A result depending
+	 * on the changes since a clear_changes() must check that the epoch
+	 * did not change since then.
+	 */
+	void clear_changes() const;
+	unsigned long long get_changes_epoch() const { return changes_epoch; }
+
 	uint64_t used_features() const;
 
+	MemoryUsage memory_usage() const;
+
 	void log_diff(std::ostream& log, const Impl& rhs) const;
 
 	/**
@@ -101,8 +165,26 @@ namespace storage
 	size_t num_devices() const;
 	size_t num_holders() const;
 
-	set<sid_t> get_device_sids() const;
-	set<pair<sid_t, sid_t>> get_holder_sids() const;
+	/**
+	 * Hash over the sids and classnames of all devices and the sids of
+	 * source and target and the classnames of all holders. Maintained
+	 * incrementally so different topologies can be detected in O(1).
+	 * The attributes of devices and holders are not included.
+	 */
+	uint64_t get_topology_hash() const { return topology_hash; }
+
+	/**
+	 * Counter that is incremented whenever a device or holder is added
+	 * or removed or the sid of a device changes. Allows to cache results
+	 * depending only on the structure of the graph.
+	 */
+	unsigned long long get_generation() const { return generation; }
+
+	/**
+	 * Counter that is incremented whenever a device or holder is added,
+	 * removed or possibly modified, see Devicegraph::get_modification_counter().
+	 */
+	unsigned long long get_modification_counter() const { return generation + modifications; }
 
 	vertex_descriptor add_vertex(Device* device);
 	edge_descriptor add_edge(vertex_descriptor source_vertex, vertex_descriptor target_vertex,
@@ -119,6 +201,45 @@ namespace storage
 
 	edge_descriptor set_source(edge_descriptor edge, vertex_descriptor vertex);
 
+	/**
+	 * Updates the sid index after the sid of the device of vertex was
+	 * changed from old_sid.
+	 */
+	void change_sid(vertex_descriptor vertex, sid_t old_sid);
+
+	/**
+	 * Find the vertices whose devices have the index name or index uuid
+	 * (see Device::Impl::get_index_name() and
+	 * Device::Impl::get_index_uuid()).
+	 */
+	boost::iterator_range<string_index_t::const_iterator> find_vertices_by_name(const string& name) const;
+	boost::iterator_range<string_index_t::const_iterator> find_vertices_by_uuid(const string& uuid) const;
+
+	/**
+	 * Updates the name and uuid indexes after the index name or index
+	 * uuid of the device of vertex was changed.
+	 */
+	void change_name(vertex_descriptor vertex, const string& old_name);
+	void change_uuid(vertex_descriptor vertex, const string& old_uuid);
+
+	/**
+	 * Returns the dense index of the vertex. The index of a vertex can
+	 * change when another vertex is removed.
+	 */
+	size_t get_vertex_index(vertex_descriptor vertex) const { return boost::get(boost::vertex_index, graph, vertex); }
+
+	/**
+	 * Returns the dense local index of the device with the sid, which is
+	 * the vertex index, or npos if no device has the sid. In contrast to
+	 * sids, which are sparse, it can be used to index side tables that
+	 * are plain vectors of size num_devices(). Since the index of a
+	 * device can change when another device is removed, side tables are
+	 * only valid as long as no devices are removed.
+	 */
+	size_t get_local_index(sid_t sid) const;
+
+	static constexpr size_t npos = -1;
+
 	Device* operator[](vertex_descriptor vertex) { return graph[vertex].get(); }
 	const Device* operator[](vertex_descriptor vertex) const { return graph[vertex].get(); }
 
@@ -130,53 +251,197 @@ namespace storage
 	void remove_vertex(vertex_descriptor vertex);
 	void remove_edge(edge_descriptor edge);
 
+	/**
+	 * Begins a savepoint, see Devicegraph::begin_savepoint(). While a
+	 * savepoint is active all changes are recorded in a journal: Adding
+	 * and removing vertices and edges with the information to undo it
+	 * and, before the first modification of a device or holder since
+	 * the last savepoint, a copy of its Impl.
+	 */
+	unsigned int begin_savepoint();
+
+	/**
+	 * Undoes the changes recorded since the savepoint by working
+	 * backwards through the journal.
+	 */
+	void rollback_to(unsigned int savepoint);
+
+	void release(unsigned int savepoint);
+
+	bool has_savepoints() const { return !savepoints.empty(); }
+
+	/**
+	 * Called before the device of vertex or the holder of edge is
+	 * modified, see Device::Impl::journal_modification(). Records it in
+	 * the journal if a savepoint is active and it has not been recorded
+	 * since the last savepoint. Also counts the modifications so that
+	 * indexes over attributes can detect changes and marks the device,
+	 * or the source and target of the holder, as unchecked. Does nothing
+	 * during a rollback.
+	 */
+	void journal_device(vertex_descriptor vertex);
+	void journal_holder(edge_descriptor edge);
+
+	/**
+	 * Finds the devices matching the query sorted by sid, see
+	 * Devicegraph::query().
+	 */
+	vector<vertex_descriptor> query(const DeviceQuery& query) const;
+
 	boost::iterator_range<vertex_iterator> vertices() const;
 	boost::iterator_range<edge_iterator> edges() const;
 
+	void copy(Devicegraph& dest) const;
+
+	/**
+	 * Loads the devicegraph from an xml or binary file. The format is
+	 * detected from the content of the file.
+	 */
 	void load(Devicegraph* devicegraph, const string& filename);
+
+	/**
+	 * Saves the devicegraph to a file. The binary format is used if
+	 * the filename has the extension ".bin", otherwise xml.
+	 */
 	void save(const string& filename) const;
 
+	/**
+	 * Saves only the given vertices and edges, used for views of the
+	 * devicegraph. The edges must be between the given vertices.
+	 */
+	void save(const string& filename, const vector<vertex_descriptor>& vertices,
+		  const vector<edge_descriptor>& edges) const;
+
 	void print(std::ostream& out) const;
 
 	void write_graphviz(const string& filename, GraphvizFlags graphviz_flags) const;
 
+	/**
+	 * Writes only the given vertices and edges, used for views of the
+	 * devicegraph. The edges must be between the given vertices.
+	 */
+	void write_graphviz(const string& filename, GraphvizFlags graphviz_flags,
+			    const vector<vertex_descriptor>& vertices,
+			    const vector<edge_descriptor>& edges) const;
+
 	size_t num_children(vertex_descriptor vertex) const;
 	size_t num_parents(vertex_descriptor vertex) const;
 
 	vertex_descriptor child(vertex_descriptor vertex) const;
 	vertex_descriptor parent(vertex_descriptor vertex) const;
 
-	// TODO use iterator base functions instead of vector based below
-	// boost::iterator_range<adjacency_iterator> children(vertex_descriptor vertex) const;
-	// boost::iterator_range<inv_adjacency_iterator> parents(vertex_descriptor vertex) const;
-
-	vector<vertex_descriptor> children(vertex_descriptor vertex) const;
-	vector<vertex_descriptor> parents(vertex_descriptor vertex) const;
+	boost::iterator_range<adjacency_iterator> children(vertex_descriptor vertex) const;
+	boost::iterator_range<inv_adjacency_iterator> parents(vertex_descriptor vertex) const;
 	vector<vertex_descriptor> siblings(vertex_descriptor vertex, bool itself) const;
+
+	/**
+	 * The descendants, ancestors, leaves and roots are computed from
+	 * the closure cache, see get_closure().
+	 */
 	vector<vertex_descriptor> descendants(vertex_descriptor vertex, bool itself) const;
 	vector<vertex_descriptor> ancestors(vertex_descriptor vertex, bool itself) const;
 	vector<vertex_descriptor> leaves(vertex_descriptor vertex, bool itself) const;
 	vector<vertex_descriptor> roots(vertex_descriptor vertex, bool itself) const;
 
+	/**
+	 * Check whether descendant is a descendant of vertex. O(log k) once
+	 * the descendants of vertex are cached.
+	 */
+	bool is_descendant(vertex_descriptor vertex, vertex_descriptor descendant, bool itself) const;
+
 	edge_descriptor in_edge(vertex_descriptor vertex) const;
 	edge_descriptor out_edge(vertex_descriptor vertex) const;
 
-	vector<edge_descriptor> in_edges(vertex_descriptor vertex) const;
-	vector<edge_descriptor> out_edges(vertex_descriptor vertex) const;
+	boost::iterator_range<in_edge_iterator> in_edges(vertex_descriptor vertex) const;
+	boost::iterator_range<out_edge_iterator> out_edges(vertex_descriptor vertex) const;
+
+
+	/**
+	 * Predicate and function to filter and convert vertices to devices of
+	 * Type, used by the lazy ranges below.
+	 */
+	template <typename Type>
+	struct IsDeviceOfType
+	{
+	    IsDeviceOfType(const graph_t& graph) : graph(&graph) {}
+
+	    bool operator()(vertex_descriptor vertex) const
+	    {
+		return dynamic_cast<const Type*>((*graph)[vertex].get()) != nullptr;
+	    }
+
+	    const graph_t* graph;
+	};
+
+	template <typename Type>
+	struct ToDeviceOfType
+	{
+	    typedef Type* result_type;
+
+	    ToDeviceOfType(const graph_t& graph) : graph(&graph) {}
+
+	    Type* operator()(vertex_descriptor vertex) const
+	    {
+		return static_cast<Type*>((*graph)[vertex].get());
+	    }
+
+	    const graph_t* graph;
+	};
+
+	template <typename Type, typename Range>
+	using devices_of_type_range_t =
+	    boost::transformed_range<ToDeviceOfType<Type>, const boost::filtered_range<IsDeviceOfType<Type>, const Range>>;
+
+	template <typename Type, typename Range>
+	devices_of_type_range_t<Type, Range>
+	devices_of_type(const Range& range) const
+	{
+	    return range | boost::adaptors::filtered(IsDeviceOfType<Type>(graph)) |
+		boost::adaptors::transformed(ToDeviceOfType<Type>(graph));
+	}
+
+	/**
+	 * Lazy ranges of the children and parents of type Type, e.g.
+	 * children_of_type<const Partition>(vertex). Nothing is allocated.
+	 * The graph must not be modified while iterating.
+	 */
+	template <typename Type>
+	devices_of_type_range_t<Type, boost::iterator_range<adjacency_iterator>>
+	children_of_type(vertex_descriptor vertex) const
+	{
+	    return devices_of_type<Type>(children(vertex));
+	}
+
+	template <typename Type>
+	devices_of_type_range_t<Type, boost::iterator_range<inv_adjacency_iterator>>
+	parents_of_type(vertex_descriptor vertex) const
+	{
+	    return devices_of_type<Type>(parents(vertex));
+	}
+
+
+	/**
+	 * Returns the vertices of the devices for which is_of_type returns
+	 * true in insertion order. Uses the class index so is_of_type is
+	 * only called once per device class and must only depend on the
+	 * class of the device.
+	 */
+	vector<vertex_descriptor> vertices_of_type(std::function<bool(const Device*)> is_of_type) const;
 
 
 	template<typename Type>
 	vector<Type*>
 	get_devices_of_type() const
 	{
+	    const vector<vertex_descriptor> tmp = vertices_of_type([](const Device* device) {
+		return dynamic_cast<const Type*>(device) != nullptr;
+	    });
+
 	    vector<Type*> ret;
+	    ret.reserve(tmp.size());
 
-	    for (vertex_descriptor vertex : vertices())
-	    {
-		Type* device = dynamic_cast<Type*>(graph[vertex].get());
-		if (device)
-		    ret.push_back(device);
-	    }
+	    for (vertex_descriptor vertex : tmp)
+		ret.push_back(static_cast<Type*>(graph[vertex].get()));
 
 	    return ret;
 	}
@@ -187,12 +452,16 @@ namespace storage
 	vector<Type*>
 	get_devices_of_type_if(Pred pred) const
 	{
+	    const vector<vertex_descriptor> tmp = vertices_of_type([](const Device* device) {
+		return dynamic_cast<const Type*>(device) != nullptr;
+	    });
+
 	    vector<Type*> ret;
 
-	    for (vertex_descriptor vertex : vertices())
+	    for (vertex_descriptor vertex : tmp)
 	    {
-		Type* device = dynamic_cast<Type*>(graph[vertex].get());
-		if (device && pred(device))
+		Type* device = static_cast<Type*>(graph[vertex].get());
+		if (pred(device))
 		    ret.push_back(device);
 	    }
 
@@ -200,9 +469,9 @@ namespace storage
 	}
 
 
-	template <typename Type>
+	template <typename Type, typename Range>
 	vector<Type*>
-	filter_devices_of_type(const vector<vertex_descriptor>& vertices)
+	filter_devices_of_type(const Range& vertices)
 	{
 	    vector<Type*> ret;
 
@@ -218,9 +487,9 @@ namespace storage
 
 
 
-	template <typename Type>
+	template <typename Type, typename Range>
 	vector<const Type*>
-	filter_devices_of_type(const vector<vertex_descriptor>& vertices) const
+	filter_devices_of_type(const Range& vertices) const
 	{
 	    vector<const Type*> ret;
 
@@ -235,9 +504,9 @@ namespace storage
 	}
 
 
-	template <typename Type>
+	template <typename Type, typename Range>
 	vector<Type*>
-	filter_holders_of_type(const vector<edge_descriptor>& edges)
+	filter_holders_of_type(const Range& edges)
 	{
 	    vector<Type*> ret;
 
@@ -252,9 +521,9 @@ namespace storage
 	}
 
 
-	template <typename Type>
+	template <typename Type, typename Range>
 	vector<const Type*>
-	filter_holders_of_type(const vector<edge_descriptor>& edges) const
+	filter_holders_of_type(const Range& edges) const
 	{
 	    vector<const Type*> ret;
 
@@ -279,6 +548,276 @@ namespace storage
 
 	const Storage* storage;
 
+	/**
+	 * The sequence number reflects the insertion order of the vertex.
+	 */
+	struct IndexEntry
+	{
+	    vertex_descriptor vertex;
+	    unsigned long long sequence;
+	};
+
+	typedef std::unordered_map<sid_t, IndexEntry> sid_index_t;
+
+	/**
+	 * Index from sid to vertex to make find_vertex() and friends
+	 * O(1). Edges are found via the vertices of their source and target.
+	 */
+	sid_index_t sid_index;
+
+	/**
+	 * The vertices of the devices of one class ordered by sequence
+	 * number. Removed vertices are replaced by null_vertex until the
+	 * bucket is compacted.
+	 */
+	struct Bucket
+	{
+	    vector<pair<unsigned long long, vertex_descriptor>> entries;
+	    size_t num_removed = 0;
+
+	    void remove(unsigned long long sequence, vertex_descriptor vertex);
+	    void remove(vertex_descriptor vertex);
+
+	    void insert(unsigned long long sequence, vertex_descriptor vertex);
+
+	    unsigned long long find_sequence(vertex_descriptor vertex) const;
+
+	    void compact();
+	};
+
+	/**
+	 * Index from the classname of the device to the vertices, used by
+	 * get_devices_of_type() and friends.
+	 */
+	map<string, Bucket> class_index;
+
+	/**
+	 * The vertices by their dense vertex index.
+	 */
+	vector<vertex_descriptor> indexed_vertices;
+
+	unsigned long long next_sequence = 0;
+
+	/**
+	 * Indexes from name and uuid to vertices used by find_by_name() and
+	 * find_by_uuid().
+	 */
+	string_index_t name_index;
+	string_index_t uuid_index;
+
+	void add_to_indexes(vertex_descriptor vertex, unsigned long long sequence);
+	void remove_from_indexes(vertex_descriptor vertex);
+
+	uint64_t topology_hash = 0;
+
+	unsigned long long generation = 0;
+
+	/**
+	 * Adds or removes (it is a xor) the contribution of a device or
+	 * holder to the topology hash.
+	 */
+	void toggle_topology_hash(vertex_descriptor vertex, sid_t sid);
+	void toggle_topology_hash(edge_descriptor edge, sid_t source_sid, sid_t target_sid);
+
+	/**
+	 * The vertices reachable from a vertex, including the vertex itself,
+	 * in breadth-first order and their dense vertex indexes sorted for
+	 * lookups.
+	 */
+	struct Closure
+	{
+	    vector<vertex_descriptor> vertices;
+	    vector<size_t> sorted_indexes;
+	};
+
+	/**
+	 * Cache of the closures of the descendants and ancestors. Only valid
+	 * for the generation it was computed for. Since it is modified by
+	 * const functions it is protected by a mutex.
+	 */
+	struct ClosureCache
+	{
+	    unsigned long long generation = 0;
+
+	    std::unordered_map<vertex_descriptor, Closure> descendants;
+	    std::unordered_map<vertex_descriptor, Closure> ancestors;
+	};
+
+	mutable ClosureCache closure_cache;
+	mutable std::mutex closure_cache_mutex;
+
+	/**
+	 * Number of possible modifications of devices and holders, see
+	 * journal_device().
+	 */
+	unsigned long long modifications = 0;
+
+	/**
+	 * Sorted indexes over attributes of the devices used by query().
+	 * Each index is built on first use. All are only valid for the
+	 * generation and the number of modifications they were built for.
+	 */
+	struct QueryCache
+	{
+	    unsigned long long generation = 0;
+	    unsigned long long modifications = 0;
+
+	    bool has_sizes = false;
+	    vector<pair<unsigned long long, vertex_descriptor>> sizes;
+
+	    bool has_names = false;
+	    vector<pair<string, vertex_descriptor>> names;
+
+	    bool has_udev_ids = false;
+	    std::unordered_multimap<string, vertex_descriptor> udev_ids;
+	};
+
+	mutable QueryCache query_cache;
+	mutable std::mutex query_cache_mutex;
+
+	/**
+	 * Finds the candidates for the query using the index for the most
+	 * selective criterion. The query_cache_mutex must be locked by the
+	 * caller.
+	 */
+	vector<vertex_descriptor> query_candidates(const DeviceQuery::Impl& query) const;
+
+	/**
+	 * Sids of the devices and holders added, removed, connected
+	 * differently or possibly modified since the last successful check,
+	 * used by check_incremental(). If unchecked_all is set only a full
+	 * check is possible.
+	 */
+	mutable std::unordered_set<sid_t> unchecked_sids;
+	mutable vector<pair<sid_t, sid_t>> unchecked_holders;
+	mutable bool unchecked_all = false;
+
+	void add_unchecked(vertex_descriptor vertex);
+	void clear_unchecked() const;
+
+	/**
+	 * Sids of the devices changed since the last clear_changes(), see
+	 * get_changed_sids(). Every device added to the unchecked devices is
+	 * also added here.
+	 */
+	mutable std::unordered_set<sid_t> changed_sids;
+	mutable bool changed_all = true;
+	mutable unsigned long long changes_epoch = 0;
+
+	static unsigned long long next_instance_id();
+
+	/**
+	 * Id of the devicegraph object unique within the process, used to
+	 * identify the other devicegraph of the last comparison.
+	 */
+	const unsigned long long instance_id = next_instance_id();
+
+	/**
+	 * Sids of the devices and pairs of sids of the holders possibly
+	 * modified since the last comparison by operator==.
+	 */
+	mutable std::unordered_set<sid_t> uncompared_sids;
+	mutable set<pair<sid_t, sid_t>> uncompared_holders;
+
+	/**
+	 * Result of the last comparison by operator== together with the
+	 * other devicegraph and the generations of both. The result is only
+	 * reused if the other devicegraph has the matching information, so
+	 * both uncompared sets contain all modifications since then.
+	 */
+	struct EqualCache
+	{
+	    unsigned long long other_instance_id = 0;
+	    unsigned long long generation = 0;
+	    unsigned long long other_generation = 0;
+	    bool equal = false;
+	};
+
+	mutable EqualCache equal_cache;
+
+	bool matches_equal_cache(const Impl& rhs) const;
+	bool equal_devices_and_holders(const Impl& rhs) const;
+	bool equal_uncompared_devices_and_holders(const Impl& rhs) const;
+
+	vertex_descriptor add_vertex(const std::shared_ptr<Device>& device, unsigned long long sequence);
+	edge_descriptor add_edge(vertex_descriptor source_vertex, vertex_descriptor target_vertex,
+				 const std::shared_ptr<Holder>& holder);
+
+	/**
+	 * Entry of the journal with the information to undo one change.
+	 * For removed vertices and edges the device or holder is kept
+	 * alive so that it can be added again as the same object.
+	 */
+	struct JournalEntry
+	{
+	    enum class Type { ADD_VERTEX, REMOVE_VERTEX, ADD_EDGE, REMOVE_EDGE, MODIFY_DEVICE, MODIFY_HOLDER };
+
+	    JournalEntry(Type type) : type(type) {}
+
+	    Type type;
+
+	    std::shared_ptr<Device> device;
+	    std::shared_ptr<Holder> holder;
+
+	    sid_t source_sid = 0;
+	    sid_t target_sid = 0;
+
+	    unsigned long long sequence = 0;
+
+	    std::shared_ptr<const Device::Impl> device_snapshot;
+	    std::shared_ptr<const Holder::Impl> holder_snapshot;
+	};
+
+	/**
+	 * The position of the savepoint in the journal and the devices and
+	 * holders recorded or added since the savepoint which need no
+	 * further recording.
+	 */
+	struct Savepoint
+	{
+	    Savepoint(size_t position) : position(position) {}
+
+	    size_t position;
+
+	    std::unordered_set<const Device*> devices;
+	    std::unordered_set<const Holder*> holders;
+	};
+
+	vector<JournalEntry> journal;
+	vector<Savepoint> savepoints;
+	bool rolling_back = false;
+
+	bool is_journaling() const { return !savepoints.empty() && !rolling_back; }
+
+	void record_device(vertex_descriptor vertex);
+	void record_holder(edge_descriptor edge);
+
+	void undo(const JournalEntry& journal_entry);
+
+	void discard_journal();
+
+	void load_binary(Devicegraph* devicegraph, const string& filename);
+	void save_binary(const string& filename, const vector<vertex_descriptor>& vertices,
+			 const vector<edge_descriptor>& edges) const;
+
+	void check_back_references(vertex_descriptor vertex) const;
+	void check_back_references(edge_descriptor edge) const;
+
+	/**
+	 * Runs the checks of the devices, in parallel for large
+	 * devicegraphs. Error messages are reported in the order of
+	 * vertices.
+	 */
+	void check_devices(const vector<vertex_descriptor>& vertices,
+			   const CheckCallbacks* check_callbacks) const;
+
+	/**
+	 * Returns the closure of the descendants or, if reverse is true, of
+	 * the ancestors of the vertex. The closure_cache_mutex must be
+	 * locked by the caller.
+	 */
+	const Closure& get_closure(vertex_descriptor vertex, bool reverse) const;
+
     };
 
 }
@@ -0,0 +1,404 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#include <deque>
+#include <algorithm>
+
+#include "storage/DevicegraphViewImpl.h"
+#include "storage/Devices/DeviceImpl.h"
+#include "storage/Holders/HolderImpl.h"
+#include "storage/Utils/ExceptionImpl.h"
+
+
+namespace storage
+{
+
+    DevicegraphView::Impl::Impl(const Devicegraph* devicegraph, const vector<sid_t>& root_sids,
+				DeviceFilter device_filter, HolderFilter holder_filter)
+	: devicegraph(devicegraph), generation(devicegraph->get_impl().get_generation()),
+	  device_filter(device_filter), holder_filter(holder_filter)
+    {
+	const Devicegraph::Impl& impl = devicegraph->get_impl();
+
+	std::unordered_set<vertex_descriptor> visited;
+	std::deque<vertex_descriptor> queue;
+
+	for (sid_t root_sid : root_sids)
+	{
+	    vertex_descriptor vertex = impl.find_vertex(root_sid);
+
+	    if (device_filter && !device_filter(impl[vertex]))
+		continue;
+
+	    if (visited.insert(vertex).second)
+		queue.push_back(vertex);
+	}
+
+	while (!queue.empty())
+	{
+	    vertex_descriptor vertex = queue.front();
+	    queue.pop_front();
+
+	    vertices.push_back(vertex);
+
+	    for (edge_descriptor edge : impl.out_edges(vertex))
+	    {
+		if (holder_filter && !holder_filter(impl[edge]))
+		    continue;
+
+		vertex_descriptor target = impl.target(edge);
+
+		if (visited.find(target) == visited.end())
+		{
+		    if (device_filter && !device_filter(impl[target]))
+			continue;
+
+		    visited.insert(target);
+		    queue.push_back(target);
+		}
+
+		edges.push_back(edge);
+	    }
+	}
+
+	sorted_indexes.reserve(vertices.size());
+	for (vertex_descriptor vertex : vertices)
+	    sorted_indexes.push_back(impl.get_vertex_index(vertex));
+	sort(sorted_indexes.begin(), sorted_indexes.end());
+    }
+
+
+    void
+    DevicegraphView::Impl::check_generation() const
+    {
+	if (devicegraph->get_impl().get_generation() != generation)
+	    ST_THROW(Exception("devicegraph changed since the view was created"));
+    }
+
+
+    size_t
+    DevicegraphView::Impl::num_devices() const
+    {
+	check_generation();
+
+	return vertices.size();
+    }
+
+
+    size_t
+    DevicegraphView::Impl::num_holders() const
+    {
+	check_generation();
+
+	return edges.size();
+    }
+
+
+    const vector<DevicegraphView::Impl::vertex_descriptor>&
+    DevicegraphView::Impl::get_vertices() const
+    {
+	check_generation();
+
+	return vertices;
+    }
+
+
+    const vector<DevicegraphView::Impl::edge_descriptor>&
+    DevicegraphView::Impl::get_edges() const
+    {
+	check_generation();
+
+	return edges;
+    }
+
+
+    bool
+    DevicegraphView::Impl::contains(vertex_descriptor vertex) const
+    {
+	return binary_search(sorted_indexes.begin(), sorted_indexes.end(),
+			     devicegraph->get_impl().get_vertex_index(vertex));
+    }
+
+
+    bool
+    DevicegraphView::Impl::accepts(edge_descriptor edge) const
+    {
+	return !holder_filter || holder_filter(devicegraph->get_impl()[edge]);
+    }
+
+
+    bool
+    DevicegraphView::Impl::device_exists(sid_t sid) const
+    {
+	check_generation();
+
+	const Devicegraph::Impl& impl = devicegraph->get_impl();
+
+	return impl.device_exists(sid) && contains(impl.find_vertex(sid));
+    }
+
+
+    DevicegraphView::Impl::vertex_descriptor
+    DevicegraphView::Impl::find_vertex(sid_t sid) const
+    {
+	if (!device_exists(sid))
+	    ST_THROW(DeviceNotFoundBySid(sid));
+
+	return devicegraph->get_impl().find_vertex(sid);
+    }
+
+
+    vector<DevicegraphView::Impl::vertex_descriptor>
+    DevicegraphView::Impl::children(vertex_descriptor vertex) const
+    {
+	check_generation();
+
+	const Devicegraph::Impl& impl = devicegraph->get_impl();
+
+	vector<vertex_descriptor> ret;
+
+	for (edge_descriptor edge : impl.out_edges(vertex))
+	{
+	    vertex_descriptor target = impl.target(edge);
+	    if (accepts(edge) && contains(target))
+		ret.push_back(target);
+	}
+
+	return ret;
+    }
+
+
+    vector<DevicegraphView::Impl::vertex_descriptor>
+    DevicegraphView::Impl::parents(vertex_descriptor vertex) const
+    {
+	check_generation();
+
+	const Devicegraph::Impl& impl = devicegraph->get_impl();
+
+	vector<vertex_descriptor> ret;
+
+	for (edge_descriptor edge : impl.in_edges(vertex))
+	{
+	    vertex_descriptor source = impl.source(edge);
+	    if (accepts(edge) && contains(source))
+		ret.push_back(source);
+	}
+
+	return ret;
+    }
+
+
+    vector<DevicegraphView::Impl::vertex_descriptor>
+    DevicegraphView::Impl::descendants(vertex_descriptor vertex, bool itself) const
+    {
+	check_generation();
+
+	std::unordered_set<vertex_descriptor> visited = { vertex };
+	std::deque<vertex_descriptor> queue = { vertex };
+
+	vector<vertex_descriptor> ret;
+
+	while (!queue.empty())
+	{
+	    vertex_descriptor tmp = queue.front();
+	    queue.pop_front();
+
+	    if (itself || tmp != vertex)
+		ret.push_back(tmp);
+
+	    for (vertex_descriptor child : children(tmp))
+	    {
+		if (visited.insert(child).second)
+		    queue.push_back(child);
+	    }
+	}
+
+	return ret;
+    }
+
+
+    void
+    DevicegraphView::Impl::save(const string& filename) const
+    {
+	check_generation();
+
+	devicegraph->get_impl().save(filename, vertices, edges);
+    }
+
+
+    void
+    DevicegraphView::Impl::write_graphviz(const string& filename, GraphvizFlags graphviz_flags) const
+    {
+	check_generation();
+
+	devicegraph->get_impl().write_graphviz(filename, graphviz_flags, vertices, edges);
+    }
+
+
+    namespace
+    {
+
+	vector<const Device*>
+	to_sorted_devices(const Devicegraph::Impl& impl, const vector<Devicegraph::Impl::vertex_descriptor>& vertices)
+	{
+	    vector<const Device*> ret;
+	    ret.reserve(vertices.size());
+
+	    for (Devicegraph::Impl::vertex_descriptor vertex : vertices)
+		ret.push_back(impl[vertex]);
+
+	    sort(ret.begin(), ret.end(), Device::compare_by_sid);
+
+	    return ret;
+	}
+
+    }
+
+
+    DevicegraphView::DevicegraphView(const Devicegraph* devicegraph, const std::vector<sid_t>& root_sids)
+	: impl(new Impl(devicegraph, root_sids, nullptr, nullptr))
+    {
+    }
+
+
+    DevicegraphView::DevicegraphView(const Devicegraph* devicegraph, const std::vector<sid_t>& root_sids,
+				     DeviceFilter device_filter, HolderFilter holder_filter)
+	: impl(new Impl(devicegraph, root_sids, device_filter, holder_filter))
+    {
+    }
+
+
+    DevicegraphView::~DevicegraphView()
+    {
+    }
+
+
+    const Devicegraph*
+    DevicegraphView::get_devicegraph() const
+    {
+	return get_impl().get_devicegraph();
+    }
+
+
+    bool
+    DevicegraphView::empty() const
+    {
+	return get_impl().num_devices() == 0;
+    }
+
+
+    size_t
+    DevicegraphView::num_devices() const
+    {
+	return get_impl().num_devices();
+    }
+
+
+    size_t
+    DevicegraphView::num_holders() const
+    {
+	return get_impl().num_holders();
+    }
+
+
+    bool
+    DevicegraphView::device_exists(sid_t sid) const
+    {
+	return get_impl().device_exists(sid);
+    }
+
+
+    const Device*
+    DevicegraphView::find_device(sid_t sid) const
+    {
+	return get_devicegraph()->get_impl()[get_impl().find_vertex(sid)];
+    }
+
+
+    vector<const Device*>
+    DevicegraphView::get_all_devices() const
+    {
+	return to_sorted_devices(get_devicegraph()->get_impl(), get_impl().get_vertices());
+    }
+
+
+    vector<const Holder*>
+    DevicegraphView::get_all_holders() const
+    {
+	const Devicegraph::Impl& devicegraph_impl = get_devicegraph()->get_impl();
+
+	vector<const Holder*> ret;
+	ret.reserve(get_impl().get_edges().size());
+
+	for (Devicegraph::Impl::edge_descriptor edge : get_impl().get_edges())
+	    ret.push_back(devicegraph_impl[edge]);
+
+	sort(ret.begin(), ret.end(), [](const Holder* lhs, const Holder* rhs) {
+	    return make_pair(lhs->get_source_sid(), lhs->get_target_sid()) <
+		make_pair(rhs->get_source_sid(), rhs->get_target_sid());
+	});
+
+	return ret;
+    }
+
+
+    vector<const Device*>
+    DevicegraphView::get_children(const Device* device) const
+    {
+	Impl::vertex_descriptor vertex = get_impl().find_vertex(device->get_sid());
+
+	return to_sorted_devices(get_devicegraph()->get_impl(), get_impl().children(vertex));
+    }
+
+
+    vector<const Device*>
+    DevicegraphView::get_parents(const Device* device) const
+    {
+	Impl::vertex_descriptor vertex = get_impl().find_vertex(device->get_sid());
+
+	return to_sorted_devices(get_devicegraph()->get_impl(), get_impl().parents(vertex));
+    }
+
+
+    vector<const Device*>
+    DevicegraphView::get_descendants(const Device* device, bool itself) const
+    {
+	Impl::vertex_descriptor vertex = get_impl().find_vertex(device->get_sid());
+
+	return to_sorted_devices(get_devicegraph()->get_impl(), get_impl().descendants(vertex, itself));
+    }
+
+
+    void
+    DevicegraphView::save(const std::string& filename) const
+    {
+	get_impl().save(filename);
+    }
+
+
+    void
+    DevicegraphView::write_graphviz(const std::string& filename, GraphvizFlags graphviz_flags) const
+    {
+	get_impl().write_graphviz(filename, graphviz_flags);
+    }
+
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#ifndef STORAGE_DEVICEGRAPH_VIEW_H
+#define STORAGE_DEVICEGRAPH_VIEW_H
+
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <boost/noncopyable.hpp>
+
+#include "storage/Devices/Device.h"
+#include "storage/Graphviz.h"
+
+
+namespace storage
+{
+
+    class Devicegraph;
+    class Holder;
+
+
+    /**
+     * A read-only view of a part of a devicegraph. The view contains the
+     * root devices and all their descendants reachable through holders
+     * accepted by the holder filter and devices accepted by the device
+     * filter. A root not accepted by the device filter is not part of the
+     * view.
+     *
+     * The view does not copy the devicegraph. Creating it costs time
+     * proportional to the size of the view, not to the size of the
+     * devicegraph. So working on one disk of a huge system, e.g. saving
+     * it, does not pay for all other disks.
+     *
+     * The view must not be used after devices or holders have been
+     * added to or removed from the devicegraph. Changed attributes are
+     * visible in the view but are not used to reevaluate the filters.
+     */
+    class DevicegraphView : private boost::noncopyable
+    {
+
+    public:
+
+	typedef std::function<bool(const Device*)> DeviceFilter;
+	typedef std::function<bool(const Holder*)> HolderFilter;
+
+	/**
+	 * Creates a view with the devices with the root sids and all their
+	 * descendants.
+	 *
+	 * @throw DeviceNotFoundBySid
+	 */
+	DevicegraphView(const Devicegraph* devicegraph, const std::vector<sid_t>& root_sids);
+
+	/**
+	 * Creates a view with the devices with the root sids and their
+	 * descendants accepted by the filters. An empty filter accepts
+	 * everything. Not available in the bindings.
+	 *
+	 * @throw DeviceNotFoundBySid
+	 */
+	DevicegraphView(const Devicegraph* devicegraph, const std::vector<sid_t>& root_sids,
+			DeviceFilter device_filter, HolderFilter holder_filter);
+
+	~DevicegraphView();
+
+	const Devicegraph* get_devicegraph() const;
+
+	bool empty() const;
+
+	size_t num_devices() const;
+	size_t num_holders() const;
+
+	bool device_exists(sid_t sid) const;
+
+	/**
+	 * @throw DeviceNotFoundBySid
+	 */
+	const Device* find_device(sid_t sid) const;
+
+	/**
+	 * Returns all devices of the view sorted by sid.
+	 *
+	 * @throw Exception
+	 */
+	std::vector<const Device*> get_all_devices() const;
+
+	/**
+	 * Returns all holders of the view sorted by the sids of source and
+	 * target.
+	 *
+	 * @throw Exception
+	 */
+	std::vector<const Holder*> get_all_holders() const;
+
+	/**
+	 * Returns the children of the device within the view sorted by sid.
+	 *
+	 * @throw DeviceNotFoundBySid
+	 */
+	std::vector<const Device*> get_children(const Device* device) const;
+
+	/**
+	 * Returns the parents of the device within the view sorted by sid.
+	 *
+	 * @throw DeviceNotFoundBySid
+	 */
+	std::vector<const Device*> get_parents(const Device* device) const;
+
+	/**
+	 * Returns the descendants of the device within the view sorted by
+	 * sid.
+	 *
+	 * @throw DeviceNotFoundBySid
+	 */
+	std::vector<const Device*> get_descendants(const Device* device, bool itself) const;
+
+	/**
+	 * Saves the devices and holders of the view, see
+	 * Devicegraph::save(). The file can be loaded as a devicegraph.
+	 *
+	 * @throw Exception
+	 */
+	void save(const std::string& filename) const;
+
+	/**
+	 * @throw Exception
+	 */
+	void write_graphviz(const std::string& filename, GraphvizFlags graphviz_flags =
+			    GraphvizFlags::NONE) const;
+
+    public:
+
+	class Impl;
+
+	Impl& get_impl() { return *impl; }
+	const Impl& get_impl() const { return *impl; }
+
+    private:
+
+	const std::unique_ptr<Impl> impl;
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#ifndef STORAGE_DEVICEGRAPH_VIEW_IMPL_H
+#define STORAGE_DEVICEGRAPH_VIEW_IMPL_H
+
+
+#include "storage/DevicegraphView.h"
+#include "storage/DevicegraphImpl.h"
+
+
+namespace storage
+{
+
+    using namespace std;
+
+
+    class DevicegraphView::Impl : private boost::noncopyable
+    {
+    public:
+
+	typedef Devicegraph::Impl::vertex_descriptor vertex_descriptor;
+	typedef Devicegraph::Impl::edge_descriptor edge_descriptor;
+
+	/**
+	 * Collects the vertices and edges of the view by a breadth-first
+	 * search from the roots.
+	 */
+	Impl(const Devicegraph* devicegraph, const vector<sid_t>& root_sids, DeviceFilter device_filter,
+	     HolderFilter holder_filter);
+
+	const Devicegraph* get_devicegraph() const { return devicegraph; }
+
+	/**
+	 * All functions accessing the vertices or edges of the view throw
+	 * an exception if the devicegraph changed since the view was
+	 * created, see check_generation().
+	 */
+
+	size_t num_devices() const;
+	size_t num_holders() const;
+
+	/**
+	 * The vertices in the order of the breadth-first search and the
+	 * edges between them.
+	 */
+	const vector<vertex_descriptor>& get_vertices() const;
+	const vector<edge_descriptor>& get_edges() const;
+
+	bool contains(vertex_descriptor vertex) const;
+
+	bool device_exists(sid_t sid) const;
+
+	/**
+	 * Finds the vertex of the device with the sid within the view.
+	 *
+	 * @throw DeviceNotFoundBySid
+	 */
+	vertex_descriptor find_vertex(sid_t sid) const;
+
+	vector<vertex_descriptor> children(vertex_descriptor vertex) const;
+	vector<vertex_descriptor> parents(vertex_descriptor vertex) const;
+	vector<vertex_descriptor> descendants(vertex_descriptor vertex, bool itself) const;
+
+	void save(const string& filename) const;
+
+	void write_graphviz(const string& filename, GraphvizFlags graphviz_flags) const;
+
+    private:
+
+	/**
+	 * Checks that no devices or holders were added to or removed from
+	 * the devicegraph since the view was created. Otherwise the stored
+	 * vertices and edges might be invalid.
+	 *
+	 * @throw Exception
+	 */
+	void check_generation() const;
+
+	bool accepts(edge_descriptor edge) const;
+
+	const Devicegraph* devicegraph;
+
+	const unsigned long long generation;
+
+	const DeviceFilter device_filter;
+	const HolderFilter holder_filter;
+
+	vector<vertex_descriptor> vertices;
+	vector<edge_descriptor> edges;
+
+	/**
+	 * The dense indexes of the vertices, sorted, to check in O(log n)
+	 * whether a vertex is part of the view. The indexes are stable as
+	 * long as the generation of the devicegraph does not change.
+	 */
+	vector<size_t> sorted_indexes;
+
+    };
+
+}
+
+#endif
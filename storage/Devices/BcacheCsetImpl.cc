@@ -70,6 +70,19 @@ namespace storage
     }
 
 
+    void
+    BcacheCset::Impl::set_uuid(const string& uuid)
+    {
+	const string old_uuid = Impl::uuid;
+
+	journal_modification();
+
+	Impl::uuid = uuid;
+
+	index_uuid_changed(old_uuid);
+    }
+
+
     uint64_t
     BcacheCset::Impl::used_features() const
     {
@@ -202,4 +215,15 @@ namespace storage
 	return storage::find_by_uuid<const BcacheCset>(devicegraph, uuid);
     }
 
+
+    size_t
+    BcacheCset::Impl::get_strings_heap_size() const
+    {
+	size_t ret = Device::Impl::get_strings_heap_size();
+
+	ret += heap_size(uuid);
+
+	return ret;
+    }
+
 }
@@ -55,6 +55,8 @@ namespace storage
 
 	virtual string get_displayname() const override { return get_uuid(); }
 
+	virtual string get_index_uuid() const override { return get_uuid(); }
+
 	static bool is_valid_uuid(const string& uuid);
 
 	vector<const BlkDevice*> get_blk_devices() const;
@@ -65,6 +67,9 @@ namespace storage
 	virtual void probe_pass_1b(Prober& prober) override;
 
 	virtual Impl* clone() const override { return new Impl(*this); }
+	virtual size_t get_sizeof() const override { return sizeof(*this); }
+	virtual void assign(const Device::Impl& rhs) override { *this = dynamic_cast<const Impl&>(rhs); }
+	virtual size_t get_strings_heap_size() const override;
 
 	virtual void save(xmlNode* node) const override;
 
@@ -73,7 +78,7 @@ namespace storage
 	virtual uint64_t used_features() const override;
 
 	const string& get_uuid() const { return uuid; }
-	void set_uuid(const string& uuid) { Impl::uuid = uuid; }
+	void set_uuid(const string& uuid);
 
 	virtual bool equal(const Device::Impl& rhs) const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override;
@@ -59,6 +59,8 @@ namespace storage
 	virtual void probe_pass_1b(Prober& prober) override;
 
 	virtual Impl* clone() const override { return new Impl(*this); }
+	virtual size_t get_sizeof() const override { return sizeof(*this); }
+	virtual void assign(const Device::Impl& rhs) override { *this = dynamic_cast<const Impl&>(rhs); }
 
 	virtual void save(xmlNode* node) const override;
 
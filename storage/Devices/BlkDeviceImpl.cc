@@ -158,13 +158,21 @@ namespace storage
     void
     BlkDevice::Impl::set_name(const string& name)
     {
+	const string old_name = Impl::name;
+
+	journal_modification();
+
 	Impl::name = name;
+
+	index_name_changed(old_name);
     }
 
 
     void
     BlkDevice::Impl::set_region(const Region& region)
     {
+	journal_modification();
+
 	Impl::region = region;
 
 	for (Device* child : get_non_impl()->get_children())
@@ -521,8 +529,10 @@ namespace storage
     {
 	Devicegraph* devicegraph = get_devicegraph();
 
-	vector<Devicegraph::Impl::edge_descriptor> out_edges =
-	    devicegraph->get_impl().out_edges(get_vertex());
+	// copy since set_source() modifies the out edges
+
+	const vector<Devicegraph::Impl::edge_descriptor> out_edges =
+	    boost::copy_range<vector<Devicegraph::Impl::edge_descriptor>>(devicegraph->get_impl().out_edges(get_vertex()));
 
 	Encryption* encryption = Luks::create(devicegraph, dm_name);
 	Devicegraph::Impl::vertex_descriptor encryption_vertex = encryption->get_impl().get_vertex();
@@ -551,8 +561,10 @@ namespace storage
 	Encryption* encryption = get_encryption();
 	Devicegraph::Impl::vertex_descriptor encryption_vertex = encryption->get_impl().get_vertex();
 
-	vector<Devicegraph::Impl::edge_descriptor> out_edges =
-	    devicegraph->get_impl().out_edges(encryption_vertex);
+	// copy since set_source() modifies the out edges
+
+	const vector<Devicegraph::Impl::edge_descriptor> out_edges =
+	    boost::copy_range<vector<Devicegraph::Impl::edge_descriptor>>(devicegraph->get_impl().out_edges(encryption_vertex));
 
 	for (Devicegraph::Impl::edge_descriptor out_edge : out_edges)
 	{
@@ -631,4 +643,20 @@ namespace storage
 	}
     }
 
+
+    size_t
+    BlkDevice::Impl::get_strings_heap_size() const
+    {
+	size_t ret = Device::Impl::get_strings_heap_size();
+
+	ret += heap_size(name) +
+	    heap_size(sysfs_name) +
+	    heap_size(sysfs_path) +
+	    heap_size(udev_paths) +
+	    heap_size(udev_ids) +
+	    heap_size(dm_table_name);
+
+	return ret;
+    }
+
 }
@@ -57,19 +57,23 @@ namespace storage
 
 	virtual string get_sort_key() const override { return get_name(); }
 
+	virtual string get_index_name() const override { return get_name(); }
+
+	virtual size_t get_strings_heap_size() const override;
+
 	virtual void check(const CheckCallbacks* check_callbacks) const override;
 
 	const string& get_name() const { return name; }
 	void set_name(const string& name);
 
 	const string& get_sysfs_name() const { return sysfs_name; }
-	void set_sysfs_name(const string& sysfs_name) { Impl::sysfs_name = sysfs_name; }
+	void set_sysfs_name(const string& sysfs_name) { journal_modification(); Impl::sysfs_name = sysfs_name; }
 
 	const string& get_sysfs_path() const { return sysfs_path; }
-	void set_sysfs_path(const string& sysfs_path) { Impl::sysfs_path = sysfs_path; }
+	void set_sysfs_path(const string& sysfs_path) { journal_modification(); Impl::sysfs_path = sysfs_path; }
 
 	bool is_active() const { return active; }
-	void set_active(bool active) { Impl::active = active; }
+	void set_active(bool active) { journal_modification(); Impl::active = active; }
 
 	const Region& get_region() const { return region; }
 	virtual void set_region(const Region& region);
@@ -80,15 +84,15 @@ namespace storage
 	string get_size_string() const;
 
 	const vector<string>& get_udev_paths() const { return udev_paths; }
-	void set_udev_paths(const vector<string>& udev_paths) { Impl::udev_paths = udev_paths; }
+	void set_udev_paths(const vector<string>& udev_paths) { journal_modification(); Impl::udev_paths = udev_paths; }
 
 	const vector<string>& get_udev_ids() const { return udev_ids; }
-	void set_udev_ids(const vector<string>& udev_ids) { Impl::udev_ids = udev_ids; }
+	void set_udev_ids(const vector<string>& udev_ids) { journal_modification(); Impl::udev_ids = udev_ids; }
 
 	string get_mount_by_name(MountByType mount_by_type) const;
 
 	const string& get_dm_table_name() const { return dm_table_name; }
-	void set_dm_table_name(const string& dm_table_name) { Impl::dm_table_name = dm_table_name; }
+	void set_dm_table_name(const string& dm_table_name) { journal_modification(); Impl::dm_table_name = dm_table_name; }
 
 	BlkFilesystem* create_blk_filesystem(FsType fs_type);
 
@@ -283,4 +283,15 @@ namespace storage
 	});
     }
 
+
+    size_t
+    Dasd::Impl::get_strings_heap_size() const
+    {
+	size_t ret = Partitionable::Impl::get_strings_heap_size();
+
+	ret += heap_size(bus_id);
+
+	return ret;
+    }
+
 }
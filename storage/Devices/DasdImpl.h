@@ -57,22 +57,25 @@ namespace storage
 	virtual string get_sort_key() const override;
 
 	virtual Impl* clone() const override { return new Impl(*this); }
+	virtual size_t get_sizeof() const override { return sizeof(*this); }
+	virtual void assign(const Device::Impl& rhs) override { *this = dynamic_cast<const Impl&>(rhs); }
+	virtual size_t get_strings_heap_size() const override;
 
 	virtual void save(xmlNode* node) const override;
 
 	virtual void check(const CheckCallbacks* check_callbacks) const override;
 
 	string get_bus_id() const { return bus_id; }
-	void set_bus_id(string bus_id) { Impl::bus_id = bus_id; }
+	void set_bus_id(string bus_id) { journal_modification(); Impl::bus_id = bus_id; }
 
 	bool is_rotational() const { return rotational; }
-	void set_rotational(bool rotational) { Impl::rotational = rotational; }
+	void set_rotational(bool rotational) { journal_modification(); Impl::rotational = rotational; }
 
 	DasdType get_type() const { return type; }
-	void set_type(DasdType type) { Impl::type = type; }
+	void set_type(DasdType type) { journal_modification(); Impl::type = type; }
 
 	DasdFormat get_format() const { return format; }
-	void set_format(DasdFormat format) { Impl::format = format; }
+	void set_format(DasdFormat format) { journal_modification(); Impl::format = format; }
 
 	virtual vector<PtType> get_possible_partition_table_types() const override;
 
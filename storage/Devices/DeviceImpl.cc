@@ -131,6 +131,76 @@ namespace storage
     }
 
 
+    void
+    Device::Impl::set_sid(sid_t sid)
+    {
+	sid_t old_sid = Impl::sid;
+
+	journal_modification();
+
+	Impl::sid = sid;
+
+	if (devicegraph)
+	    devicegraph->get_impl().change_sid(vertex, old_sid);
+    }
+
+
+    void
+    Device::Impl::index_name_changed(const string& old_name)
+    {
+	if (devicegraph)
+	    devicegraph->get_impl().change_name(vertex, old_name);
+    }
+
+
+    void
+    Device::Impl::index_uuid_changed(const string& old_uuid)
+    {
+	if (devicegraph)
+	    devicegraph->get_impl().change_uuid(vertex, old_uuid);
+    }
+
+
+    void
+    Device::Impl::restore(const Impl& snapshot)
+    {
+	Devicegraph* tmp_devicegraph = devicegraph;
+	Devicegraph::Impl::vertex_descriptor tmp_vertex = vertex;
+
+	const sid_t old_sid = sid;
+	const string old_name = get_index_name();
+	const string old_uuid = get_index_uuid();
+
+	assign(snapshot);
+
+	devicegraph = tmp_devicegraph;
+	vertex = tmp_vertex;
+
+	if (!devicegraph)
+	    return;
+
+	if (sid != old_sid)
+	    devicegraph->get_impl().change_sid(vertex, old_sid);
+
+	if (get_index_name() != old_name)
+	    index_name_changed(old_name);
+
+	if (get_index_uuid() != old_uuid)
+	    index_uuid_changed(old_uuid);
+    }
+
+
+    void
+    Device::Impl::set_vertex(Devicegraph::Impl::vertex_descriptor vertex)
+    {
+	Impl::vertex = vertex;
+
+	const Device* device = devicegraph->get_impl()[vertex];
+	if (&device->get_impl() != this)
+	    ST_THROW(LogicException("wrong vertex for back references"));
+    }
+
+
     void
     Device::Impl::set_devicegraph_and_vertex(Devicegraph* devicegraph,
 					     Devicegraph::Impl::vertex_descriptor vertex)
@@ -477,6 +547,13 @@ namespace storage
 	}
 
 
+	double
+	Resize::estimated_cost(const Actiongraph::Impl& actiongraph, const CommitCosts& commit_costs) const
+	{
+	    return get_device(actiongraph, RHS)->get_impl().do_resize_cost(commit_costs);
+	}
+
+
 	Text
 	Reallot::text(const CommitData& commit_data) const
 	{
@@ -525,6 +602,13 @@ namespace storage
 	}
 
 
+	double
+	Reallot::estimated_cost(const Actiongraph::Impl& actiongraph, const CommitCosts& commit_costs) const
+	{
+	    return get_device(actiongraph, RHS)->get_impl().do_reallot_cost(commit_costs);
+	}
+
+
 	bool
 	Reallot::action_removes_device(const Action::Base* action) const
 	{
@@ -30,6 +30,8 @@
 
 #include "storage/Utils/AppUtil.h"
 #include "storage/Utils/ExceptionImpl.h"
+#include "storage/Utils/MemoryPool.h"
+#include "storage/Utils/HeapSize.h"
 #include "storage/Devices/Device.h"
 #include "storage/Holders/HolderImpl.h"
 #include "storage/Devicegraph.h"
@@ -79,7 +81,7 @@ namespace storage
 
     // abstract class
 
-    class Device::Impl
+    class Device::Impl : public PoolAllocated
     {
     public:
 
@@ -87,12 +89,41 @@ namespace storage
 
 	virtual Impl* clone() const = 0;
 
+	/**
+	 * Size of the object of the dynamic type, used for memory
+	 * accounting.
+	 */
+	virtual size_t get_sizeof() const = 0;
+
+	/**
+	 * Assigns an object of the same dynamic type, used to undo
+	 * modifications of the device.
+	 */
+	virtual void assign(const Impl& rhs) = 0;
+
+	/**
+	 * Heap memory used by the strings of the object, e.g. names and
+	 * uuids, used for memory accounting. Classes with string members
+	 * add theirs.
+	 */
+	virtual size_t get_strings_heap_size() const { return 0; }
+
+	size_t get_userdata_heap_size() const { return heap_size(userdata); }
+
 	virtual const char* get_classname() const = 0;
 
 	virtual string get_displayname() const = 0;
 
 	virtual string get_sort_key() const { return ""; }
 
+	/**
+	 * Name and uuid under which the devicegraph indexes the device for
+	 * find_by_name() and find_by_uuid(). Empty if the device is not
+	 * indexed.
+	 */
+	virtual string get_index_name() const { return ""; }
+	virtual string get_index_uuid() const { return ""; }
+
 	virtual void save(xmlNode* node) const = 0;
 
 	virtual void check(const CheckCallbacks* check_callbacks) const;
@@ -107,7 +138,7 @@ namespace storage
 	const Storage* get_storage() const;
 
 	sid_t get_sid() const { return sid; }
-	void set_sid(sid_t sid) { Impl::sid = sid; }
+	void set_sid(sid_t sid);
 
 	void set_devicegraph_and_vertex(Devicegraph* devicegraph,
 					Devicegraph::Impl::vertex_descriptor vertex);
@@ -117,13 +148,39 @@ namespace storage
 
 	Devicegraph::Impl::vertex_descriptor get_vertex() const;
 
+	/**
+	 * Returns the dense local index of the device in its devicegraph,
+	 * see Devicegraph::Impl::get_local_index().
+	 */
+	size_t get_local_index() const { return get_devicegraph()->get_impl().get_vertex_index(vertex); }
+
+	/**
+	 * Informs the devicegraph that the device is about to be modified,
+	 * see Devicegraph::Impl::journal_device(). Must be called by every
+	 * function modifying attributes of the device before the
+	 * modification.
+	 */
+	void journal_modification() { if (devicegraph) devicegraph->get_impl().journal_device(vertex); }
+
+	/**
+	 * Restores the state recorded by journal_modification(). The back
+	 * references are kept and the indexes of the devicegraph are updated.
+	 */
+	void restore(const Impl& snapshot);
+
+	/**
+	 * Sets the vertex after the device was added again to its
+	 * devicegraph, used to undo removing the device.
+	 */
+	void set_vertex(Devicegraph::Impl::vertex_descriptor vertex);
+
 	virtual Device* get_non_impl() { return devicegraph->get_impl()[vertex]; }
 	virtual const Device* get_non_impl() const { return devicegraph->get_impl()[vertex]; }
 
 	void remove_descendants();
 
 	const map<string, string>& get_userdata() const { return userdata; }
-	void set_userdata(const map<string, string>& userdata) { Impl::userdata = userdata; }
+	void set_userdata(const map<string, string>& userdata) { journal_modification(); Impl::userdata = userdata; }
 
 	virtual void probe_pass_1a(Prober& prober);
 	virtual void probe_pass_1b(Prober& prober);
@@ -185,6 +242,15 @@ namespace storage
 				     Tense tense) const;
 	virtual void do_reallot(ReallotMode reallot_mode, const Device* device) const;
 
+	/**
+	 * Estimated costs of the create, delete, resize and reallot actions,
+	 * see Action::Base::estimated_cost().
+	 */
+	virtual double do_create_cost(const CommitCosts& commit_costs) const { return commit_costs.other; }
+	virtual double do_delete_cost(const CommitCosts& commit_costs) const { return commit_costs.other; }
+	virtual double do_resize_cost(const CommitCosts& commit_costs) const { return commit_costs.other; }
+	virtual double do_reallot_cost(const CommitCosts& commit_costs) const { return commit_costs.other; }
+
 	bool has_children() const;
 	size_t num_children() const;
 
@@ -238,7 +304,7 @@ namespace storage
 
 	    const Devicegraph::Impl& devicegraph_impl = get_devicegraph()->get_impl();
 
-	    return devicegraph_impl.filter_devices_of_type<Type>(devicegraph_impl.children(get_vertex())).size();
+	    return boost::distance(devicegraph_impl.children_of_type<Type>(get_vertex()));
 	}
 
 	template<typename Type>
@@ -367,6 +433,13 @@ namespace storage
 
 	Impl(const xmlNode* node);
 
+	/**
+	 * Must be called by setters of the values returned by
+	 * get_index_name() and get_index_uuid().
+	 */
+	void index_name_changed(const string& old_name);
+	void index_uuid_changed(const string& old_uuid);
+
     private:
 
 	/**
@@ -429,6 +502,9 @@ namespace storage
 	    virtual void add_dependencies(Actiongraph::Impl::vertex_descriptor vertex,
 					  Actiongraph::Impl& actiongraph) const override;
 
+	    virtual double estimated_cost(const Actiongraph::Impl& actiongraph,
+					  const CommitCosts& commit_costs) const override;
+
 	    Side get_side() const { return resize_mode == ResizeMode::GROW ? RHS : LHS; }
 
 	    const ResizeMode resize_mode;
@@ -449,6 +525,9 @@ namespace storage
 	    virtual void add_dependencies(Actiongraph::Impl::vertex_descriptor vertex,
 					  Actiongraph::Impl& actiongraph) const override;
 
+	    virtual double estimated_cost(const Actiongraph::Impl& actiongraph,
+					  const CommitCosts& commit_costs) const override;
+
 	    const ReallotMode reallot_mode;
 
 	    /**
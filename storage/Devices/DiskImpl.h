@@ -58,14 +58,16 @@ namespace storage
 	virtual string get_sort_key() const override;
 
 	virtual Impl* clone() const override { return new Impl(*this); }
+	virtual size_t get_sizeof() const override { return sizeof(*this); }
+	virtual void assign(const Device::Impl& rhs) override { *this = dynamic_cast<const Impl&>(rhs); }
 
 	virtual void save(xmlNode* node) const override;
 
 	bool is_rotational() const { return rotational; }
-	void set_rotational(bool rotational) { Impl::rotational = rotational; }
+	void set_rotational(bool rotational) { journal_modification(); Impl::rotational = rotational; }
 
 	Transport get_transport() const { return transport; }
-	void set_transport(Transport transport) { Impl::transport = transport; }
+	void set_transport(Transport transport) { journal_modification(); Impl::transport = transport; }
 
 	static void probe_disks(Prober& prober);
 	virtual void probe_pass_1a(Prober& prober) override;
@@ -56,6 +56,8 @@ namespace storage
 	static bool deactivate_dm_raids();
 
 	virtual Impl* clone() const override { return new Impl(*this); }
+	virtual size_t get_sizeof() const override { return sizeof(*this); }
+	virtual void assign(const Device::Impl& rhs) override { *this = dynamic_cast<const Impl&>(rhs); }
 
 	virtual void save(xmlNode* node) const override;
 
@@ -64,7 +66,7 @@ namespace storage
 	static bool is_valid_name(const string& name);
 
 	bool is_rotational() const { return rotational; }
-	void set_rotational(bool rotational) { Impl::rotational = rotational; }
+	void set_rotational(bool rotational) { journal_modification(); Impl::rotational = rotational; }
 
 	static void probe_dm_raids(Prober& prober);
 	virtual void probe_pass_1a(Prober& prober) override;
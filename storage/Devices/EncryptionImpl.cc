@@ -84,6 +84,8 @@ namespace storage
     void
     Encryption::Impl::set_crypt_options(const CryptOpts& crypt_options)
     {
+	journal_modification();
+
 	Impl::crypt_options = crypt_options;
     }
 
@@ -91,6 +93,8 @@ namespace storage
     void
     Encryption::Impl::set_crypt_options(const vector<string>& crypt_options)
     {
+	journal_modification();
+
 	Impl::crypt_options.set_opts(crypt_options);
     }
 
@@ -315,6 +319,13 @@ namespace storage
     }
 
 
+    double
+    Encryption::Impl::do_create_cost(const CommitCosts& commit_costs) const
+    {
+	return commit_costs.cryptsetup;
+    }
+
+
     Text
     Encryption::Impl::do_delete_text(Tense tense) const
     {
@@ -552,4 +563,18 @@ namespace storage
 
     }
 
+
+    size_t
+    Encryption::Impl::get_strings_heap_size() const
+    {
+	size_t ret = BlkDevice::Impl::get_strings_heap_size();
+
+	ret += heap_size(password);
+
+	for (const string& crypt_option : crypt_options)
+	    ret += sizeof(string) + heap_size(crypt_option);
+
+	return ret;
+    }
+
 }
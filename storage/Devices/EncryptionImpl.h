@@ -58,10 +58,10 @@ namespace storage
 
 	const string& get_password() const { return password; }
 
-	void set_password(const string& password) { Impl::password = password; }
+	void set_password(const string& password) { journal_modification(); Impl::password = password; }
 
 	MountByType get_mount_by() const { return mount_by; }
-	void set_mount_by(const MountByType mount_by) { Impl::mount_by = mount_by; }
+	void set_mount_by(const MountByType mount_by) { journal_modification(); Impl::mount_by = mount_by; }
 
 	void set_default_mount_by();
 
@@ -72,11 +72,14 @@ namespace storage
 	void set_crypt_options(const vector<string>& crypt_options);
 
 	bool is_in_etc_crypttab() const { return in_etc_crypttab; }
-	void set_in_etc_crypttab(bool in_etc_crypttab) { Impl::in_etc_crypttab = in_etc_crypttab; }
+	void set_in_etc_crypttab(bool in_etc_crypttab) { journal_modification(); Impl::in_etc_crypttab = in_etc_crypttab; }
 
 	const BlkDevice* get_blk_device() const;
 
 	virtual Impl* clone() const override { return new Impl(*this); }
+	virtual size_t get_sizeof() const override { return sizeof(*this); }
+	virtual void assign(const Device::Impl& rhs) override { *this = dynamic_cast<const Impl&>(rhs); }
+	virtual size_t get_strings_heap_size() const override;
 
 	virtual void save(xmlNode* node) const override;
 
@@ -95,6 +98,8 @@ namespace storage
 
 	virtual Text do_delete_text(Tense tense) const override;
 
+	virtual double do_create_cost(const CommitCosts& commit_costs) const override;
+
 	virtual Text do_resize_text(ResizeMode resize_mode, const Device* lhs, const Device* rhs,
 				    Tense tense) const override;
 
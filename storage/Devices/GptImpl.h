@@ -54,6 +54,8 @@ namespace storage
 	virtual PtType get_type() const override { return PtType::GPT; }
 
 	virtual Impl* clone() const override { return new Impl(*this); }
+	virtual size_t get_sizeof() const override { return sizeof(*this); }
+	virtual void assign(const Device::Impl& rhs) override { *this = dynamic_cast<const Impl&>(rhs); }
 
 	virtual void save(xmlNode* node) const override;
 
@@ -74,10 +76,10 @@ namespace storage
 	virtual unsigned int max_primary() const override;
 
 	bool is_enlarge() const { return enlarge; }
-	void set_enlarge(bool enlarge) { Impl::enlarge = enlarge; }
+	void set_enlarge(bool enlarge) { journal_modification(); Impl::enlarge = enlarge; }
 
 	bool is_pmbr_boot() const { return pmbr_boot; }
-	void set_pmbr_boot(bool pmbr_boot) { Impl::pmbr_boot = pmbr_boot; }
+	void set_pmbr_boot(bool pmbr_boot) { journal_modification(); Impl::pmbr_boot = pmbr_boot; }
 
 	virtual Region get_usable_region() const override;
 
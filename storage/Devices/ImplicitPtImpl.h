@@ -54,6 +54,8 @@ namespace storage
 	virtual PtType get_type() const override { return PtType::IMPLICIT; }
 
 	virtual Impl* clone() const override { return new Impl(*this); }
+	virtual size_t get_sizeof() const override { return sizeof(*this); }
+	virtual void assign(const Device::Impl& rhs) override { *this = dynamic_cast<const Impl&>(rhs); }
 
 	virtual void probe_pass_1c(Prober& prober) override;
 
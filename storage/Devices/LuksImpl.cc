@@ -515,4 +515,15 @@ namespace storage
         }
     }
 
+
+    size_t
+    Luks::Impl::get_strings_heap_size() const
+    {
+	size_t ret = Encryption::Impl::get_strings_heap_size();
+
+	ret += heap_size(uuid);
+
+	return ret;
+    }
+
 }
@@ -73,6 +73,9 @@ namespace storage
 	virtual void probe_pass_1e(Prober& prober) override;
 
 	virtual Impl* clone() const override { return new Impl(*this); }
+	virtual size_t get_sizeof() const override { return sizeof(*this); }
+	virtual void assign(const Device::Impl& rhs) override { *this = dynamic_cast<const Impl&>(rhs); }
+	virtual size_t get_strings_heap_size() const override;
 
 	virtual EncryptionType get_type() const override { return EncryptionType::LUKS; }
 
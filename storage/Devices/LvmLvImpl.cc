@@ -145,6 +145,19 @@ namespace storage
     }
 
 
+    void
+    LvmLv::Impl::set_uuid(const string& uuid)
+    {
+	const string old_uuid = Impl::uuid;
+
+	journal_modification();
+
+	Impl::uuid = uuid;
+
+	index_uuid_changed(old_uuid);
+    }
+
+
     bool
     LvmLv::Impl::activate_lvm_lvs(const ActivateCallbacks* activate_callbacks)
     {
@@ -273,6 +286,8 @@ namespace storage
 	if (stripes > 128)
 	    ST_THROW(Exception("stripes above 128"));
 
+	journal_modification();
+
 	Impl::stripes = stripes;
     }
 
@@ -289,6 +304,8 @@ namespace storage
 		ST_THROW(Exception("stripe size not a power of two"));
 	}
 
+	journal_modification();
+
 	Impl::stripe_size = stripe_size;
     }
 
@@ -315,6 +332,8 @@ namespace storage
 		ST_THROW(Exception("chunk size not multiple of 64 KiB"));
 	}
 
+	journal_modification();
+
 	Impl::chunk_size = chunk_size;
     }
 
@@ -361,6 +380,8 @@ namespace storage
     void
     LvmLv::Impl::set_lv_name(const string& lv_name)
     {
+	journal_modification();
+
 	Impl::lv_name = lv_name;
 
 	const LvmVg* lvm_vg = get_lvm_vg();
@@ -432,7 +453,7 @@ namespace storage
 	Devicegraph::Impl& devicegraph = get_devicegraph()->get_impl();
 	Devicegraph::Impl::vertex_descriptor vertex = get_vertex();
 
-	for (LvmLv* lvm_lv : devicegraph.filter_devices_of_type<LvmLv>(devicegraph.children(vertex)))
+	for (LvmLv* lvm_lv : devicegraph.children_of_type<LvmLv>(vertex))
 	{
 	    if (lvm_lv->get_lv_name() == lv_name)
 		return lvm_lv;
@@ -927,6 +948,27 @@ namespace storage
     }
 
 
+    double
+    LvmLv::Impl::do_create_cost(const CommitCosts& commit_costs) const
+    {
+	return commit_costs.lvm;
+    }
+
+
+    double
+    LvmLv::Impl::do_delete_cost(const CommitCosts& commit_costs) const
+    {
+	return commit_costs.lvm;
+    }
+
+
+    double
+    LvmLv::Impl::do_resize_cost(const CommitCosts& commit_costs) const
+    {
+	return commit_costs.lvm;
+    }
+
+
     Text
     LvmLv::Impl::do_delete_text(Tense tense) const
     {
@@ -1173,4 +1215,15 @@ namespace storage
 	    boost::replace_all_copy(lv_name, "-", "--");
     }
 
+
+    size_t
+    LvmLv::Impl::get_strings_heap_size() const
+    {
+	size_t ret = BlkDevice::Impl::get_strings_heap_size();
+
+	ret += heap_size(lv_name) + heap_size(uuid);
+
+	return ret;
+    }
+
 }
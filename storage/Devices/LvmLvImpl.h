@@ -54,6 +54,8 @@ namespace storage
 
 	virtual string get_displayname() const override { return get_lv_name(); }
 
+	virtual string get_index_uuid() const override { return get_uuid(); }
+
 	static bool activate_lvm_lvs(const ActivateCallbacks* activate_callbacks);
 
 	static bool deactivate_lvm_lvs();
@@ -62,6 +64,9 @@ namespace storage
 	virtual void probe_pass_1a(Prober& prober) override;
 
 	virtual Impl* clone() const override { return new Impl(*this); }
+	virtual size_t get_sizeof() const override { return sizeof(*this); }
+	virtual void assign(const Device::Impl& rhs) override { *this = dynamic_cast<const Impl&>(rhs); }
+	virtual size_t get_strings_heap_size() const override;
 
 	virtual void save(xmlNode* node) const override;
 
@@ -81,7 +86,7 @@ namespace storage
 	LvType get_lv_type() const { return lv_type; }
 
 	const string& get_uuid() const { return uuid; }
-	void set_uuid(const string& uuid) { Impl::uuid = uuid; }
+	void set_uuid(const string& uuid);
 
 	unsigned long long number_of_extents() const { return get_region().get_length(); }
 
@@ -138,6 +143,10 @@ namespace storage
 	virtual Text do_delete_text(Tense tense) const override;
 	virtual void do_delete() const override;
 
+	virtual double do_create_cost(const CommitCosts& commit_costs) const override;
+	virtual double do_delete_cost(const CommitCosts& commit_costs) const override;
+	virtual double do_resize_cost(const CommitCosts& commit_costs) const override;
+
 	virtual Text do_activate_text(Tense tense) const override;
 	virtual void do_activate() const override;
 
@@ -71,6 +71,19 @@ namespace storage
     }
 
 
+    void
+    LvmPv::Impl::set_uuid(const string& uuid)
+    {
+	const string old_uuid = Impl::uuid;
+
+	journal_modification();
+
+	Impl::uuid = uuid;
+
+	index_uuid_changed(old_uuid);
+    }
+
+
     bool
     LvmPv::Impl::has_blk_device() const
     {
@@ -339,6 +352,27 @@ namespace storage
     }
 
 
+    double
+    LvmPv::Impl::do_create_cost(const CommitCosts& commit_costs) const
+    {
+	return commit_costs.lvm;
+    }
+
+
+    double
+    LvmPv::Impl::do_delete_cost(const CommitCosts& commit_costs) const
+    {
+	return commit_costs.lvm;
+    }
+
+
+    double
+    LvmPv::Impl::do_resize_cost(const CommitCosts& commit_costs) const
+    {
+	return commit_costs.lvm;
+    }
+
+
     Text
     LvmPv::Impl::do_delete_text(Tense tense) const
     {
@@ -368,4 +402,15 @@ namespace storage
 	    ST_THROW(Exception("delete LvmPv failed"));
     }
 
+
+    size_t
+    LvmPv::Impl::get_strings_heap_size() const
+    {
+	size_t ret = Device::Impl::get_strings_heap_size();
+
+	ret += heap_size(uuid);
+
+	return ret;
+    }
+
 }
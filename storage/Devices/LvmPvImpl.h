@@ -50,14 +50,19 @@ namespace storage
 
 	virtual string get_displayname() const override { return "lvm pv"; }
 
+	virtual string get_index_uuid() const override { return get_uuid(); }
+
 	virtual Impl* clone() const override { return new Impl(*this); }
+	virtual size_t get_sizeof() const override { return sizeof(*this); }
+	virtual void assign(const Device::Impl& rhs) override { *this = dynamic_cast<const Impl&>(rhs); }
+	virtual size_t get_strings_heap_size() const override;
 
 	virtual void save(xmlNode* node) const override;
 
 	virtual void check(const CheckCallbacks* check_callbacks) const override;
 
 	const string& get_uuid() const { return uuid; }
-	void set_uuid(const string& uuid) { Impl::uuid = uuid; }
+	void set_uuid(const string& uuid);
 
 	bool has_blk_device() const;
 
@@ -96,6 +101,10 @@ namespace storage
 	virtual Text do_delete_text(Tense tense) const override;
 	virtual void do_delete() const override;
 
+	virtual double do_create_cost(const CommitCosts& commit_costs) const override;
+	virtual double do_delete_cost(const CommitCosts& commit_costs) const override;
+	virtual double do_resize_cost(const CommitCosts& commit_costs) const override;
+
     private:
 
 	string uuid;
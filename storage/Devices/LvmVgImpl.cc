@@ -89,6 +89,19 @@ namespace storage
     }
 
 
+    void
+    LvmVg::Impl::set_uuid(const string& uuid)
+    {
+	const string old_uuid = Impl::uuid;
+
+	journal_modification();
+
+	Impl::uuid = uuid;
+
+	index_uuid_changed(old_uuid);
+    }
+
+
     void
     LvmVg::Impl::probe_lvm_vgs(Prober& prober)
     {
@@ -145,6 +158,8 @@ namespace storage
 	if (!is_power_of_two(extent_size) || !is_multiple_of(extent_size, 128 * KiB))
 	    ST_THROW(InvalidExtentSize(extent_size));
 
+	journal_modification();
+
 	region.set_block_size(extent_size);
 
 	// TODO adjust lvm lvs
@@ -159,7 +174,9 @@ namespace storage
 	unsigned long long ret = 0;
 	unsigned long long spare_metadata_extents = 0;
 
-	for (const LvmLv* lvm_lv : get_lvm_lvs())
+	const Devicegraph::Impl& devicegraph = get_devicegraph()->get_impl();
+
+	for (const LvmLv* lvm_lv : devicegraph.children_of_type<const LvmLv>(get_vertex()))
 	{
 	    if (contains(ignore_sids, lvm_lv->get_sid()))
 		continue;
@@ -254,6 +271,8 @@ namespace storage
     void
     LvmVg::Impl::set_vg_name(const string& vg_name)
     {
+	journal_modification();
+
 	Impl::vg_name = vg_name;
 
 	// TODO call set_name() for all lvm_lvs
@@ -277,6 +296,8 @@ namespace storage
 		extent_count += (size - 1 * MiB) / extent_size;
 	}
 
+	journal_modification();
+
 	region.set_length(extent_count);
     }
 
@@ -384,7 +405,7 @@ namespace storage
 	Devicegraph::Impl& devicegraph = get_devicegraph()->get_impl();
 	Devicegraph::Impl::vertex_descriptor vertex = get_vertex();
 
-	for (LvmLv* lvm_lv : devicegraph.filter_devices_of_type<LvmLv>(devicegraph.children(vertex)))
+	for (LvmLv* lvm_lv : devicegraph.children_of_type<LvmLv>(vertex))
 	{
 	    if (lvm_lv->get_lv_name() == lv_name)
 		return lvm_lv;
@@ -526,6 +547,27 @@ namespace storage
     }
 
 
+    double
+    LvmVg::Impl::do_create_cost(const CommitCosts& commit_costs) const
+    {
+	return commit_costs.lvm;
+    }
+
+
+    double
+    LvmVg::Impl::do_delete_cost(const CommitCosts& commit_costs) const
+    {
+	return commit_costs.lvm;
+    }
+
+
+    double
+    LvmVg::Impl::do_reallot_cost(const CommitCosts& commit_costs) const
+    {
+	return commit_costs.lvm;
+    }
+
+
     Text
     LvmVg::Impl::do_reallot_text(ReallotMode reallot_mode, const Device* device, Tense tense) const
     {
@@ -661,8 +703,7 @@ namespace storage
 	if (!resize)
 	    return false;
 
-	const Devicegraph* devicegraph = actiongraph.get_devicegraph(RHS);
-	const Device* device = devicegraph->find_device(resize->sid);
+	const Device* device = resize->get_device(actiongraph, RHS);
 	if (!is_lvm_pv(device))
 	    return false;
 
@@ -726,4 +767,15 @@ namespace storage
 	return lvm_lv->get_lvm_vg()->get_sid() == get_sid();
     }
 
+
+    size_t
+    LvmVg::Impl::get_strings_heap_size() const
+    {
+	size_t ret = Device::Impl::get_strings_heap_size();
+
+	ret += heap_size(vg_name) + heap_size(uuid);
+
+	return ret;
+    }
+
 }
@@ -60,15 +60,20 @@ namespace storage
 
 	virtual string get_sort_key() const override { return DEVDIR "/" + vg_name; }
 
+	virtual string get_index_uuid() const override { return get_uuid(); }
+
 	static void probe_lvm_vgs(Prober& prober);
 	virtual void probe_pass_1a(Prober& prober) override;
 
 	void calculate_reserved_extents(Prober& prober);
 
 	unsigned long long get_reserved_extents() const { return reserved_extents; }
-	void set_reserved_extents(unsigned long long reserved_extents) { Impl::reserved_extents = reserved_extents; }
+	void set_reserved_extents(unsigned long long reserved_extents) { journal_modification(); Impl::reserved_extents = reserved_extents; }
 
 	virtual Impl* clone() const override { return new Impl(*this); }
+	virtual size_t get_sizeof() const override { return sizeof(*this); }
+	virtual void assign(const Device::Impl& rhs) override { *this = dynamic_cast<const Impl&>(rhs); }
+	virtual size_t get_strings_heap_size() const override;
 
 	virtual void save(xmlNode* node) const override;
 
@@ -95,7 +100,7 @@ namespace storage
 	void set_vg_name(const string& vg_name);
 
 	const string& get_uuid() const { return uuid; }
-	void set_uuid(const string& uuid) { Impl::uuid = uuid; }
+	void set_uuid(const string& uuid);
 
 	LvmPv* add_lvm_pv(BlkDevice* blk_device);
 	void remove_lvm_pv(BlkDevice* blk_device);
@@ -134,6 +139,10 @@ namespace storage
 	virtual void do_reduce(const LvmPv* lvm_pv) const;
 	virtual void do_extend(const LvmPv* lvm_pv) const;
 
+	virtual double do_create_cost(const CommitCosts& commit_costs) const override;
+	virtual double do_delete_cost(const CommitCosts& commit_costs) const override;
+	virtual double do_reallot_cost(const CommitCosts& commit_costs) const override;
+
 	virtual void add_dependencies(Actiongraph::Impl& actiongraph) const override;
 
     private:
@@ -47,6 +47,8 @@ namespace storage
 	virtual const char* get_classname() const override { return DeviceTraits<MdContainer>::classname; }
 
 	virtual Impl* clone() const override { return new Impl(*this); }
+	virtual size_t get_sizeof() const override { return sizeof(*this); }
+	virtual void assign(const Device::Impl& rhs) override { *this = dynamic_cast<const Impl&>(rhs); }
 
 	virtual void check(const CheckCallbacks* check_callbacks) const override;
 
@@ -226,6 +226,8 @@ namespace storage
 	if (Impl::md_level == md_level)
 	    return;
 
+	journal_modification();
+
 	Impl::md_level = md_level;
 
 	calculate_region_and_topology();
@@ -238,6 +240,8 @@ namespace storage
 	if (Impl::chunk_size == chunk_size)
 	    return;
 
+	journal_modification();
+
 	Impl::chunk_size = chunk_size;
 
 	calculate_region_and_topology();
@@ -1110,4 +1114,15 @@ namespace storage
 
     }
 
+
+    size_t
+    Md::Impl::get_strings_heap_size() const
+    {
+	size_t ret = Partitionable::Impl::get_strings_heap_size();
+
+	ret += heap_size(uuid) + heap_size(metadata);
+
+	return ret;
+    }
+
 }
@@ -61,6 +61,9 @@ namespace storage
 	virtual string get_sort_key() const override;
 
 	virtual Impl* clone() const override { return new Impl(*this); }
+	virtual size_t get_sizeof() const override { return sizeof(*this); }
+	virtual void assign(const Device::Impl& rhs) override { *this = dynamic_cast<const Impl&>(rhs); }
+	virtual size_t get_strings_heap_size() const override;
 
 	virtual void save(xmlNode* node) const override;
 
@@ -82,7 +85,7 @@ namespace storage
 	void set_md_level(MdLevel md_level);
 
 	MdParity get_md_parity() const { return md_parity; }
-	void set_md_parity(MdParity md_parity) { Impl::md_parity = md_parity; }
+	void set_md_parity(MdParity md_parity) { journal_modification(); Impl::md_parity = md_parity; }
 
 	unsigned long get_chunk_size() const { return chunk_size; }
 	void set_chunk_size(unsigned long chunk_size);
@@ -92,12 +95,12 @@ namespace storage
 	const string& get_uuid() const { return uuid; }
 
 	const string& get_metadata() const { return metadata; }
-	void set_metadata(const string& metadata) { Impl::metadata = metadata; }
+	void set_metadata(const string& metadata) { journal_modification(); Impl::metadata = metadata; }
 
 	unsigned int minimal_number_of_devices() const;
 
 	bool is_in_etc_mdadm() const { return in_etc_mdadm; }
-	void set_in_etc_mdadm(bool in_etc_mdadm) { Impl::in_etc_mdadm = in_etc_mdadm; }
+	void set_in_etc_mdadm(bool in_etc_mdadm) { journal_modification(); Impl::in_etc_mdadm = in_etc_mdadm; }
 
 	static bool is_valid_name(const string& name);
 
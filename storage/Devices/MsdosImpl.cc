@@ -86,6 +86,8 @@ namespace storage
     void
     Msdos::Impl::set_minimal_mbr_gap(unsigned long minimal_mbr_gap)
     {
+	journal_modification();
+
 	Impl::minimal_mbr_gap = minimal_mbr_gap;
     }
 
@@ -67,6 +67,8 @@ namespace storage
 	virtual PtType get_type() const override { return PtType::MSDOS; }
 
 	virtual Impl* clone() const override { return new Impl(*this); }
+	virtual size_t get_sizeof() const override { return sizeof(*this); }
+	virtual void assign(const Device::Impl& rhs) override { *this = dynamic_cast<const Impl&>(rhs); }
 
 	virtual void save(xmlNode* node) const override;
 
@@ -312,4 +312,15 @@ namespace storage
 	    ST_THROW(Exception("deactivate multipath failed"));
     }
 
+
+    size_t
+    Multipath::Impl::get_strings_heap_size() const
+    {
+	size_t ret = Partitionable::Impl::get_strings_heap_size();
+
+	ret += heap_size(vendor) + heap_size(model);
+
+	return ret;
+    }
+
 }
@@ -56,6 +56,9 @@ namespace storage
 	static bool deactivate_multipaths();
 
 	virtual Impl* clone() const override { return new Impl(*this); }
+	virtual size_t get_sizeof() const override { return sizeof(*this); }
+	virtual void assign(const Device::Impl& rhs) override { *this = dynamic_cast<const Impl&>(rhs); }
+	virtual size_t get_strings_heap_size() const override;
 
 	virtual void save(xmlNode* node) const override;
 
@@ -68,7 +71,7 @@ namespace storage
 	const string& get_model() const { return model; }
 
 	bool is_rotational() const { return rotational; }
-	void set_rotational(bool rotational) { Impl::rotational = rotational; }
+	void set_rotational(bool rotational) { journal_modification(); Impl::rotational = rotational; }
 
 	static void probe_multipaths(Prober& prober);
 	virtual void probe_pass_1a(Prober& prober) override;
@@ -359,6 +359,8 @@ namespace storage
 	    ST_THROW(Exception(sformat("illegal partition type %s on %s", toString(type).c_str(),
 				       toString(partition_table->get_type()).c_str())));
 
+	journal_modification();
+
 	Impl::type = type;
     }
 
@@ -372,6 +374,8 @@ namespace storage
 	    ST_THROW(Exception(sformat("illegal partition id %d on %s", id,
 				       toString(partition_table->get_type()).c_str())));
 
+	journal_modification();
+
 	Impl::id = id;
     }
 
@@ -390,9 +394,14 @@ namespace storage
 	    PartitionTable* partition_table = get_partition_table();
 
 	    for (Partition* partition : partition_table->get_partitions())
+	    {
+		partition->get_impl().journal_modification();
 		partition->get_impl().boot = false;
+	    }
 	}
 
+	journal_modification();
+
 	Impl::boot = boot;
     }
 
@@ -406,6 +415,8 @@ namespace storage
 	    ST_THROW(Exception(sformat("set_boot not supported on %s",
 				       toString(partition_table->get_type()).c_str())));
 
+	journal_modification();
+
 	Impl::legacy_boot = legacy_boot;
     }
 
@@ -1002,6 +1013,27 @@ namespace storage
     }
 
 
+    double
+    Partition::Impl::do_create_cost(const CommitCosts& commit_costs) const
+    {
+	return commit_costs.parted + commit_costs.udevadm_settle;
+    }
+
+
+    double
+    Partition::Impl::do_delete_cost(const CommitCosts& commit_costs) const
+    {
+	return commit_costs.parted + commit_costs.udevadm_settle;
+    }
+
+
+    double
+    Partition::Impl::do_resize_cost(const CommitCosts& commit_costs) const
+    {
+	return commit_costs.parted + commit_costs.udevadm_settle;
+    }
+
+
     Text
     Partition::Impl::do_resize_text(ResizeMode resize_mode, const Device* lhs, const Device* rhs,
 				    Tense tense) const
@@ -59,6 +59,8 @@ namespace storage
 	virtual string get_sort_key() const override;
 
 	virtual Impl* clone() const override { return new Impl(*this); }
+	virtual size_t get_sizeof() const override { return sizeof(*this); }
+	virtual void assign(const Device::Impl& rhs) override { *this = dynamic_cast<const Impl&>(rhs); }
 
 	virtual void probe_pass_1a(Prober& prober) override;
 
@@ -133,6 +135,10 @@ namespace storage
 				    Tense tense) const override;
 	virtual void do_resize(ResizeMode resize_mode, const Device* rhs) const override;
 
+	virtual double do_create_cost(const CommitCosts& commit_costs) const override;
+	virtual double do_delete_cost(const CommitCosts& commit_costs) const override;
+	virtual double do_resize_cost(const CommitCosts& commit_costs) const override;
+
 	static unsigned int default_id_for_type(PartitionType type);
 
     private:
@@ -435,6 +435,12 @@ namespace storage
 
 	for (Actiongraph::Impl::vertex_descriptor vertex : actiongraph.vertices())
 	{
+	    // the actions of partition tables with a reused action are all
+	    // reused together with their dependencies
+
+	    if (actiongraph.is_reused(vertex))
+		continue;
+
 	    const Action::Base* action = actiongraph[vertex];
 
 	    const Action::Create* create_action = dynamic_cast<const Action::Create*>(action);
@@ -492,17 +498,16 @@ namespace storage
 	// Some functions used for sorting actions by partition number.
 
         const Devicegraph* devicegraph_rhs = actiongraph.get_devicegraph(RHS);
-        const Devicegraph* devicegraph_lhs = actiongraph.get_devicegraph(LHS);
 
 	std::function<unsigned int(Actiongraph::Impl::vertex_descriptor)> key_fnc1 =
-	    [&actiongraph, &devicegraph_lhs](Actiongraph::Impl::vertex_descriptor vertex) {
+	    [&actiongraph](Actiongraph::Impl::vertex_descriptor vertex) {
 	    const Action::Base* action = actiongraph[vertex];
-	    const Partition* partition = to_partition(devicegraph_lhs->find_device(action->sid));
+	    const Partition* partition = to_partition(action->find_device(actiongraph, LHS));
 	    return partition->get_number();
 	};
 
 	std::function<int(Actiongraph::Impl::vertex_descriptor)> key_fnc2 =
-	    [&actiongraph, &devicegraph_lhs](Actiongraph::Impl::vertex_descriptor vertex) {
+	    [&actiongraph](Actiongraph::Impl::vertex_descriptor vertex) {
 	    const Action::RenameIn* action = dynamic_cast<const Action::RenameIn*>(actiongraph[vertex]);
 	    const Partition* partition_lhs = to_partition(action->get_renamed_blk_device(actiongraph, LHS));
 	    const Partition* partition_rhs = to_partition(action->get_renamed_blk_device(actiongraph, RHS));
@@ -512,9 +517,9 @@ namespace storage
 	};
 
 	std::function<unsigned int(Actiongraph::Impl::vertex_descriptor)> key_fnc3 =
-	    [&actiongraph, &devicegraph_rhs](Actiongraph::Impl::vertex_descriptor vertex) {
+	    [&actiongraph](Actiongraph::Impl::vertex_descriptor vertex) {
 	    const Action::Base* action = actiongraph[vertex];
-	    const Partition* partition = to_partition(devicegraph_rhs->find_device(action->sid));
+	    const Partition* partition = to_partition(action->find_rhs_device(actiongraph));
 	    return partition->get_number();
 	};
 
@@ -552,12 +557,19 @@ namespace storage
 	    if (devicegraph_rhs->device_exists(tmp.first))
 	    {
 		const PartitionTable* partition_table = to_partition_table(devicegraph_rhs->find_device(tmp.first));
-		actiongraph.last_action_on_partition_table[partition_table->get_sid()] = actions.back();
+		actiongraph.set_last_action_on_partition_table(partition_table->get_sid(), actions.back());
 	    }
 	}
     }
 
 
+    double
+    PartitionTable::Impl::do_create_cost(const CommitCosts& commit_costs) const
+    {
+	return commit_costs.parted + commit_costs.udevadm_settle;
+    }
+
+
     void
     PartitionTable::Impl::do_delete() const
     {
@@ -133,6 +133,8 @@ namespace storage
 
 	virtual void do_delete() const override;
 
+	virtual double do_create_cost(const CommitCosts& commit_costs) const override;
+
     protected:
 
 	Impl()
@@ -48,10 +48,10 @@ namespace storage
 	void check(const CheckCallbacks* check_callbacks) const override;
 
 	const Topology& get_topology() const { return topology; }
-	void set_topology(const Topology& topology) { Impl::topology = topology; }
+	void set_topology(const Topology& topology) { journal_modification(); Impl::topology = topology; }
 
 	unsigned int get_range() const { return range; }
-	void set_range(unsigned int range) { Impl::range = range; }
+	void set_range(unsigned int range) { journal_modification(); Impl::range = range; }
 
 	PtType get_default_partition_table_type() const;
 
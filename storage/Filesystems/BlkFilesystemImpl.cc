@@ -74,6 +74,8 @@ namespace storage
     void
     BlkFilesystem::Impl::set_label(const string& label)
     {
+	journal_modification();
+
 	Impl::label = label;
     }
 
@@ -81,6 +83,8 @@ namespace storage
     void
     BlkFilesystem::Impl::set_uuid(const string& uuid)
     {
+	journal_modification();
+
 	Impl::uuid = uuid;
     }
 
@@ -88,6 +92,8 @@ namespace storage
     void
     BlkFilesystem::Impl::set_mkfs_options(const string& mkfs_options)
     {
+	journal_modification();
+
 	Impl::mkfs_options = mkfs_options;
     }
 
@@ -95,6 +101,8 @@ namespace storage
     void
     BlkFilesystem::Impl::set_tune_options(const string& tune_options)
     {
+	journal_modification();
+
 	Impl::tune_options = tune_options;
     }
 
@@ -288,6 +296,8 @@ namespace storage
     void
     BlkFilesystem::Impl::set_resize_info(const ResizeInfo& tmp)
     {
+	journal_modification();
+
 	resize_info.set_value(tmp);
     }
 
@@ -323,6 +333,8 @@ namespace storage
     void
     BlkFilesystem::Impl::set_content_info(const ContentInfo& tmp)
     {
+	journal_modification();
+
 	content_info.set_value(tmp);
     }
 
@@ -767,6 +779,19 @@ namespace storage
     }
 
 
+    double
+    BlkFilesystem::Impl::do_create_cost(const CommitCosts& commit_costs) const
+    {
+	// mkfs initializes the metadata all over the device
+
+	unsigned long long size = 0;
+	for (const BlkDevice* blk_device : get_blk_devices())
+	    size += blk_device->get_size();
+
+	return commit_costs.mkfs + commit_costs.mkfs_per_gib * size / GiB;
+    }
+
+
     Text
     BlkFilesystem::Impl::do_delete_text(Tense tense) const
     {
@@ -880,4 +905,15 @@ namespace storage
 
     }
 
+
+    size_t
+    BlkFilesystem::Impl::get_strings_heap_size() const
+    {
+	size_t ret = Filesystem::Impl::get_strings_heap_size();
+
+	ret += heap_size(label) + heap_size(uuid) + heap_size(mkfs_options) + heap_size(tune_options);
+
+	return ret;
+    }
+
 }
@@ -49,6 +49,8 @@ namespace storage
     {
     public:
 
+	virtual size_t get_strings_heap_size() const override;
+
 	virtual unsigned long long min_size() const = 0;
 	virtual unsigned long long max_size() const = 0;
 
@@ -128,6 +130,8 @@ namespace storage
 	virtual Text do_delete_text(Tense tense) const override;
 	virtual void do_delete() const override;
 
+	virtual double do_create_cost(const CommitCosts& commit_costs) const override;
+
     protected:
 
 	Impl()
@@ -77,7 +77,7 @@ namespace storage
 	const BtrfsSubvolume* find_btrfs_subvolume_by_path(const string& path) const;
 
         bool get_configure_snapper() const { return configure_snapper; }
-        void set_configure_snapper(bool configure) { Impl::configure_snapper = configure; }
+        void set_configure_snapper(bool configure) { journal_modification(); Impl::configure_snapper = configure; }
 
     public:
 
@@ -96,6 +96,8 @@ namespace storage
 	virtual string get_displayname() const override { return "btrfs"; }
 
 	virtual Impl* clone() const override { return new Impl(*this); }
+	virtual size_t get_sizeof() const override { return sizeof(*this); }
+	virtual void assign(const Device::Impl& rhs) override { *this = dynamic_cast<const Impl&>(rhs); }
 
 	virtual void probe_pass_2a(Prober& prober) override;
 	virtual void probe_pass_2b(Prober& prober) override;
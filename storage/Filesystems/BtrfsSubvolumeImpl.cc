@@ -91,9 +91,14 @@ namespace storage
 	    Btrfs* btrfs = get_btrfs();
 
 	    for (BtrfsSubvolume* btrfs_subvolume : btrfs->get_btrfs_subvolumes())
+	    {
+		btrfs_subvolume->get_impl().journal_modification();
 		btrfs_subvolume->get_impl().default_btrfs_subvolume = false;
+	    }
 	}
 
+	journal_modification();
+
 	default_btrfs_subvolume = true;
     }
 
@@ -692,4 +697,15 @@ namespace storage
 
     }
 
+
+    size_t
+    BtrfsSubvolume::Impl::get_strings_heap_size() const
+    {
+	size_t ret = Mountable::Impl::get_strings_heap_size();
+
+	ret += heap_size(path);
+
+	return ret;
+    }
+
 }
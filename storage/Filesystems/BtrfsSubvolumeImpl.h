@@ -57,23 +57,26 @@ namespace storage
 	virtual string get_displayname() const override;
 
 	virtual Impl* clone() const override { return new Impl(*this); }
+	virtual size_t get_sizeof() const override { return sizeof(*this); }
+	virtual void assign(const Device::Impl& rhs) override { *this = dynamic_cast<const Impl&>(rhs); }
+	virtual size_t get_strings_heap_size() const override;
 
 	virtual void probe_pass_2a(Prober& prober, const string& mount_point);
 	virtual void probe_pass_2b(Prober& prober, const string& mount_point);
 
 	long get_id() const { return id; }
-	void set_id(long id) { Impl::id = id; }
+	void set_id(long id) { journal_modification(); Impl::id = id; }
 
 	bool is_top_level() const { return id == top_level_id; }
 
 	const string& get_path() const { return path; }
-	void set_path(const string& path) { Impl::path = path; }
+	void set_path(const string& path) { journal_modification(); Impl::path = path; }
 
 	bool is_default_btrfs_subvolume() const { return default_btrfs_subvolume; }
 	void set_default_btrfs_subvolume();
 
 	bool is_nocow() const { return nocow; }
-	void set_nocow(bool nocow) { Impl::nocow = nocow; }
+	void set_nocow(bool nocow) { journal_modification(); Impl::nocow = nocow; }
 
 	Btrfs* get_btrfs();
 	const Btrfs* get_btrfs() const;
@@ -58,6 +58,8 @@ namespace storage
 	virtual unsigned long long max_size() const override { return 2 * TiB; }
 
 	virtual Impl* clone() const override { return new Impl(*this); }
+	virtual size_t get_sizeof() const override { return sizeof(*this); }
+	virtual void assign(const Device::Impl& rhs) override { *this = dynamic_cast<const Impl&>(rhs); }
 
 	virtual uint64_t used_features() const override;
 
@@ -114,6 +114,8 @@ namespace storage
     void
     Filesystem::Impl::set_space_info(const SpaceInfo& tmp)
     {
+	journal_modification();
+
 	space_info.set_value(tmp);
     }
 
@@ -122,6 +122,8 @@ namespace storage
 	    ST_THROW(InvalidMountPointPath(path));
 #endif
 
+	journal_modification();
+
 	Impl::path = path;
     }
 
@@ -255,6 +257,8 @@ namespace storage
     void
     MountPoint::Impl::set_mount_options(const MountOpts& mount_options)
     {
+	journal_modification();
+
 	Impl::mount_options = mount_options;
     }
 
@@ -262,6 +266,8 @@ namespace storage
     void
     MountPoint::Impl::set_mount_options(const vector<string>& mount_options)
     {
+	journal_modification();
+
 	Impl::mount_options.set_opts(mount_options);
     }
 
@@ -371,6 +377,20 @@ namespace storage
     }
 
 
+    double
+    MountPoint::Impl::do_create_cost(const CommitCosts& commit_costs) const
+    {
+	return commit_costs.mount;
+    }
+
+
+    double
+    MountPoint::Impl::do_delete_cost(const CommitCosts& commit_costs) const
+    {
+	return commit_costs.mount;
+    }
+
+
     Text
     MountPoint::Impl::do_add_to_etc_fstab_text(Tense tense) const
     {
@@ -532,4 +552,18 @@ namespace storage
 
     }
 
+
+    size_t
+    MountPoint::Impl::get_strings_heap_size() const
+    {
+	size_t ret = Device::Impl::get_strings_heap_size();
+
+	ret += heap_size(path) + heap_size(fstab_device_name);
+
+	for (const string& mount_option : mount_options)
+	    ret += sizeof(string) + heap_size(mount_option);
+
+	return ret;
+    }
+
 }
@@ -51,6 +51,9 @@ namespace storage
 	virtual string get_displayname() const override;
 
 	virtual Impl* clone() const override { return new Impl(*this); }
+	virtual size_t get_sizeof() const override { return sizeof(*this); }
+	virtual void assign(const Device::Impl& rhs) override { *this = dynamic_cast<const Impl&>(rhs); }
+	virtual size_t get_strings_heap_size() const override;
 
 	static bool valid_path(const string& path);
 	static string normalize_path(const string& path);
@@ -59,7 +62,7 @@ namespace storage
 	void set_path(const string& path);
 
 	MountByType get_mount_by() const { return mount_by; }
-	void set_mount_by(const MountByType mount_by) { Impl::mount_by = mount_by; }
+	void set_mount_by(const MountByType mount_by) { journal_modification(); Impl::mount_by = mount_by; }
 
 	void set_default_mount_by();
 
@@ -74,10 +77,10 @@ namespace storage
 	int get_passno() const { return passno; }
 
 	bool is_in_etc_fstab() const { return in_etc_fstab; }
-	void set_in_etc_fstab(bool in_etc_fstab) { Impl::in_etc_fstab = in_etc_fstab; }
+	void set_in_etc_fstab(bool in_etc_fstab) { journal_modification(); Impl::in_etc_fstab = in_etc_fstab; }
 
 	bool is_active() const { return active; }
-	void set_active(bool active) { Impl::active = active; }
+	void set_active(bool active) { journal_modification(); Impl::active = active; }
 
 	bool has_mountable() const;
 
@@ -98,7 +101,7 @@ namespace storage
 	 * This is empty if this filesystem was not in /etc/fstab during probing.
 	 **/
 	const string& get_fstab_device_name() const { return fstab_device_name; }
-	void set_fstab_device_name(const string& name) { Impl::fstab_device_name = name; }
+	void set_fstab_device_name(const string& name) { journal_modification(); Impl::fstab_device_name = name; }
 
 	virtual bool equal(const Device::Impl& rhs) const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override;
@@ -115,6 +118,9 @@ namespace storage
 	virtual Text do_umount_text(Tense tense) const;
 	virtual void do_umount(CommitData& commit_data) const;
 
+	virtual double do_create_cost(const CommitCosts& commit_costs) const override;
+	virtual double do_delete_cost(const CommitCosts& commit_costs) const override;
+
 	virtual Text do_add_to_etc_fstab_text(Tense tense) const;
 	virtual void do_add_to_etc_fstab(CommitData& commit_data) const;
 
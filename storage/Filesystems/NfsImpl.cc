@@ -211,4 +211,15 @@ namespace storage
 	actiongraph.add_chain(actions);
     }
 
+
+    size_t
+    Nfs::Impl::get_strings_heap_size() const
+    {
+	size_t ret = Filesystem::Impl::get_strings_heap_size();
+
+	ret += heap_size(server) + heap_size(path);
+
+	return ret;
+    }
+
 }
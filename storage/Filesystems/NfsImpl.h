@@ -53,6 +53,9 @@ namespace storage
 	virtual string get_displayname() const override { return server + ":" + path; }
 
 	virtual Impl* clone() const override { return new Impl(*this); }
+	virtual size_t get_sizeof() const override { return sizeof(*this); }
+	virtual void assign(const Device::Impl& rhs) override { *this = dynamic_cast<const Impl&>(rhs); }
+	virtual size_t get_strings_heap_size() const override;
 
 	const string& get_server() const { return server; }
 
@@ -68,6 +68,8 @@ namespace storage
 	virtual string get_displayname() const override { return "reiserfs"; }
 
 	virtual Impl* clone() const override { return new Impl(*this); }
+	virtual size_t get_sizeof() const override { return sizeof(*this); }
+	virtual void assign(const Device::Impl& rhs) override { *this = dynamic_cast<const Impl&>(rhs); }
 
 	virtual uint64_t used_features() const override;
 
@@ -35,14 +35,20 @@ namespace storage
     using std::string;
 
 
+    /**
+     * Find a device of Type by its name using the name index of the
+     * devicegraph. Only devices returning their name in
+     * Device::Impl::get_index_name() are found.
+     */
     template<typename Type>
     Type*
     find_by_name(Devicegraph* devicegraph, const string& name)
     {
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+	for (const Devicegraph::Impl::string_index_t::value_type& key_value :
+		 devicegraph->get_impl().find_vertices_by_name(name))
 	{
-	    Type* device = dynamic_cast<Type*>(devicegraph->get_impl()[vertex]);
-	    if (device && device->get_impl().get_name() == name)
+	    Type* device = dynamic_cast<Type*>(devicegraph->get_impl()[key_value.second]);
+	    if (device)
 		return device;
 	}
 
@@ -54,10 +60,11 @@ namespace storage
     const Type*
     find_by_name(const Devicegraph* devicegraph, const string& name)
     {
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+	for (const Devicegraph::Impl::string_index_t::value_type& key_value :
+		 devicegraph->get_impl().find_vertices_by_name(name))
 	{
-	    const Type* device = dynamic_cast<const Type*>(devicegraph->get_impl()[vertex]);
-	    if (device && device->get_impl().get_name() == name)
+	    const Type* device = dynamic_cast<const Type*>(devicegraph->get_impl()[key_value.second]);
+	    if (device)
 		return device;
 	}
 
@@ -65,14 +72,20 @@ namespace storage
     }
 
 
+    /**
+     * Find a device of Type by its uuid using the uuid index of the
+     * devicegraph. Only devices returning their uuid in
+     * Device::Impl::get_index_uuid() are found.
+     */
     template<typename Type>
     Type*
     find_by_uuid(Devicegraph* devicegraph, const string& uuid)
     {
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+	for (const Devicegraph::Impl::string_index_t::value_type& key_value :
+		 devicegraph->get_impl().find_vertices_by_uuid(uuid))
 	{
-	    Type* device = dynamic_cast<Type*>(devicegraph->get_impl()[vertex]);
-	    if (device && device->get_impl().get_uuid() == uuid)
+	    Type* device = dynamic_cast<Type*>(devicegraph->get_impl()[key_value.second]);
+	    if (device)
 		return device;
 	}
 
@@ -84,10 +97,11 @@ namespace storage
     const Type*
     find_by_uuid(const Devicegraph* devicegraph, const string& uuid)
     {
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+	for (const Devicegraph::Impl::string_index_t::value_type& key_value :
+		 devicegraph->get_impl().find_vertices_by_uuid(uuid))
 	{
-	    const Type* device = dynamic_cast<const Type*>(devicegraph->get_impl()[vertex]);
-	    if (device && device->get_impl().get_uuid() == uuid)
+	    const Type* device = dynamic_cast<const Type*>(devicegraph->get_impl()[key_value.second]);
+	    if (device)
 		return device;
 	}
 
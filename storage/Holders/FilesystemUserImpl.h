@@ -44,6 +44,8 @@ namespace storage
 	Impl(const xmlNode* node);
 
 	virtual Impl* clone() const override { return new Impl(*this); }
+	virtual size_t get_sizeof() const override { return sizeof(*this); }
+	virtual void assign(const Holder::Impl& rhs) override { *this = dynamic_cast<const Impl&>(rhs); }
 
 	virtual void save(xmlNode* node) const override;
 
@@ -55,7 +57,7 @@ namespace storage
 	virtual void print(std::ostream& out) const override;
 
 	bool is_journal() const { return journal; }
-	void set_journal(bool journal) { Impl::journal = journal; }
+	void set_journal(bool journal) { journal_modification(); Impl::journal = journal; }
 
     private:
 
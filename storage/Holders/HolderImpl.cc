@@ -64,6 +64,19 @@ namespace storage
     }
 
 
+    void
+    Holder::Impl::restore(const Impl& snapshot)
+    {
+	Devicegraph* tmp_devicegraph = devicegraph;
+	Devicegraph::Impl::edge_descriptor tmp_edge = edge;
+
+	assign(snapshot);
+
+	devicegraph = tmp_devicegraph;
+	edge = tmp_edge;
+    }
+
+
     void
     Holder::Impl::set_edge(Devicegraph::Impl::edge_descriptor edge)
     {
@@ -29,6 +29,7 @@
 #include <type_traits>
 
 #include "storage/Utils/ExceptionImpl.h"
+#include "storage/Utils/MemoryPool.h"
 #include "storage/Holders/Holder.h"
 #include "storage/DevicegraphImpl.h"
 
@@ -41,7 +42,7 @@ namespace storage
 
     // abstract class
 
-    class Holder::Impl
+    class Holder::Impl : public PoolAllocated
     {
     public:
 
@@ -52,6 +53,18 @@ namespace storage
 
 	virtual Impl* clone() const = 0;
 
+	/**
+	 * Size of the object of the dynamic type, used for memory
+	 * accounting.
+	 */
+	virtual size_t get_sizeof() const = 0;
+
+	/**
+	 * Assigns an object of the same dynamic type, used to undo
+	 * modifications of the holder.
+	 */
+	virtual void assign(const Impl& rhs) = 0;
+
 	virtual const char* get_classname() const = 0;
 
 	virtual void save(xmlNode* node) const = 0;
@@ -66,6 +79,18 @@ namespace storage
 
 	Devicegraph::Impl::edge_descriptor get_edge() const { return edge; }
 
+	/**
+	 * Informs the devicegraph that the holder is about to be modified,
+	 * see Device::Impl::journal_modification().
+	 */
+	void journal_modification() { if (devicegraph) devicegraph->get_impl().journal_holder(edge); }
+
+	/**
+	 * Restores the state recorded by journal_modification() keeping the
+	 * back references.
+	 */
+	void restore(const Impl& snapshot);
+
 	Device* get_source();
 	const Device* get_source() const;
 
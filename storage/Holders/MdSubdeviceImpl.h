@@ -44,6 +44,8 @@ namespace storage
 	Impl(const xmlNode* node);
 
 	virtual Impl* clone() const override { return new Impl(*this); }
+	virtual size_t get_sizeof() const override { return sizeof(*this); }
+	virtual void assign(const Holder::Impl& rhs) override { *this = dynamic_cast<const Impl&>(rhs); }
 
 	virtual void save(xmlNode* node) const override;
 
@@ -55,7 +57,7 @@ namespace storage
 	virtual void print(std::ostream& out) const override;
 
 	const string& get_member() const { return member; }
-	void set_member(const string& member) { Impl::member = member; }
+	void set_member(const string& member) { journal_modification(); Impl::member = member; }
 
     private:
 
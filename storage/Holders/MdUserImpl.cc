@@ -102,6 +102,8 @@ namespace storage
         if (Impl::spare == spare)
 	    return;
 
+	journal_modification();
+
 	Impl::spare = spare;
 
 	Md* md = to_md(get_target());
@@ -115,6 +117,8 @@ namespace storage
 	if (Impl::faulty == faulty)
 	    return;
 
+	journal_modification();
+
 	Impl::faulty = faulty;
 
 	Md* md = to_md(get_target());
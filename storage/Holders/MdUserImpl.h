@@ -44,6 +44,8 @@ namespace storage
 	Impl(const xmlNode* node);
 
 	virtual Impl* clone() const override { return new Impl(*this); }
+	virtual size_t get_sizeof() const override { return sizeof(*this); }
+	virtual void assign(const Holder::Impl& rhs) override { *this = dynamic_cast<const Impl&>(rhs); }
 
 	virtual void save(xmlNode* node) const override;
 
@@ -61,7 +63,7 @@ namespace storage
 	void set_faulty(bool faulty);
 
 	unsigned int get_sort_key() const { return sort_key; }
-	void set_sort_key(unsigned int sort_key) { Impl::sort_key = sort_key; }
+	void set_sort_key(unsigned int sort_key) { journal_modification(); Impl::sort_key = sort_key; }
 
     private:
 
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#include "storage/MemoryUsage.h"
+
+
+namespace storage
+{
+
+    using namespace std;
+
+
+    MemoryUsage::MemoryUsage()
+	: devices(), holders(), graph(0), userdata(0), strings(0)
+    {
+    }
+
+
+    unsigned long long
+    MemoryUsage::get_devices_total() const
+    {
+	unsigned long long ret = 0;
+
+	for (const map<string, unsigned long long>::value_type& value : devices)
+	    ret += value.second;
+
+	return ret;
+    }
+
+
+    unsigned long long
+    MemoryUsage::get_holders_total() const
+    {
+	unsigned long long ret = 0;
+
+	for (const map<string, unsigned long long>::value_type& value : holders)
+	    ret += value.second;
+
+	return ret;
+    }
+
+
+    unsigned long long
+    MemoryUsage::get_total() const
+    {
+	return get_devices_total() + get_holders_total() + graph + userdata + strings;
+    }
+
+
+    MemoryUsage&
+    MemoryUsage::operator+=(const MemoryUsage& rhs)
+    {
+	for (const map<string, unsigned long long>::value_type& value : rhs.devices)
+	    devices[value.first] += value.second;
+
+	for (const map<string, unsigned long long>::value_type& value : rhs.holders)
+	    holders[value.first] += value.second;
+
+	graph += rhs.graph;
+	userdata += rhs.userdata;
+	strings += rhs.strings;
+
+	return *this;
+    }
+
+
+    std::ostream&
+    operator<<(std::ostream& out, const MemoryUsage& memory_usage)
+    {
+	out << "total:" << memory_usage.get_total();
+
+	for (const map<string, unsigned long long>::value_type& value : memory_usage.devices)
+	    out << " " << value.first << ":" << value.second;
+
+	for (const map<string, unsigned long long>::value_type& value : memory_usage.holders)
+	    out << " " << value.first << ":" << value.second;
+
+	out << " graph:" << memory_usage.graph << " userdata:" << memory_usage.userdata
+	    << " strings:" << memory_usage.strings;
+
+	return out;
+    }
+
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#ifndef STORAGE_MEMORY_USAGE_H
+#define STORAGE_MEMORY_USAGE_H
+
+
+#include <string>
+#include <map>
+#include <ostream>
+
+
+namespace storage
+{
+
+    /**
+     * Estimated memory usage of devicegraphs in bytes. Sizes of heap
+     * blocks are estimated from the sizes of the objects and the
+     * capacities of their containers. Allocator overhead is not
+     * included.
+     */
+    class MemoryUsage
+    {
+    public:
+
+	MemoryUsage();
+
+	/**
+	 * Bytes used by the device objects, by classname, e.g. "Disk".
+	 */
+	std::map<std::string, unsigned long long> devices;
+
+	/**
+	 * Bytes used by the holder objects, by classname, e.g. "User".
+	 */
+	std::map<std::string, unsigned long long> holders;
+
+	/**
+	 * Bytes used by the graph itself, its indexes and caches.
+	 */
+	unsigned long long graph;
+
+	/**
+	 * Bytes used by the userdata of the devices.
+	 */
+	unsigned long long userdata;
+
+	/**
+	 * Bytes used by strings of the devices, e.g. names and uuids, that
+	 * are not stored in the objects themselves.
+	 */
+	unsigned long long strings;
+
+	unsigned long long get_devices_total() const;
+	unsigned long long get_holders_total() const;
+
+	unsigned long long get_total() const;
+
+	MemoryUsage& operator+=(const MemoryUsage& rhs);
+
+	friend std::ostream& operator<<(std::ostream& out, const MemoryUsage& memory_usage);
+
+    };
+
+}
+
+#endif
@@ -148,6 +148,13 @@ namespace storage
     }
 
 
+    MemoryUsage
+    Storage::memory_usage() const
+    {
+	return get_impl().memory_usage();
+    }
+
+
     MountByType
     Storage::get_default_mount_by() const
     {
@@ -186,7 +193,14 @@ namespace storage
     const Actiongraph*
     Storage::calculate_actiongraph()
     {
-	return get_impl().calculate_actiongraph();
+	return get_impl().calculate_actiongraph(false);
+    }
+
+
+    const Actiongraph*
+    Storage::calculate_actiongraph(bool incremental)
+    {
+	return get_impl().calculate_actiongraph(incremental);
     }
 
 
@@ -220,7 +234,15 @@ namespace storage
     void
     Storage::commit(const CommitOptions& commit_options, const CommitCallbacks* commit_callbacks)
     {
-	get_impl().commit(commit_options, commit_callbacks);
+	get_impl().commit(commit_options, 1, commit_callbacks);
+    }
+
+
+    void
+    Storage::commit_parallel(const CommitOptions& commit_options, unsigned int parallelism,
+			     const CommitCallbacks* commit_callbacks)
+    {
+	get_impl().commit(commit_options, parallelism, commit_callbacks);
     }
 
 }
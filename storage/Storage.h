@@ -33,6 +33,7 @@
 
 #include "storage/Filesystems/Mountable.h"
 #include "storage/CommitOptions.h"
+#include "storage/MemoryUsage.h"
 
 namespace storage
 {
@@ -43,6 +44,10 @@ namespace storage
      *
      * There is no guarantee about the thread safety of libstorage.
      *
+     * libstorage may use additional threads internally, e.g. to check
+     * large devicegraphs. The logger may be called from these threads,
+     * see \link storage::Logger \endlink.
+     *
      * \section Exceptions-and-Side-Effects Exceptions and Side Effects
      *
      * There is no guarantee that functions have no side effects if an
@@ -111,6 +116,10 @@ namespace storage
     };
 
 
+    /**
+     * The callbacks are always called from the thread calling the check,
+     * even if the devices are checked in parallel.
+     */
     class CheckCallbacks
     {
     public:
@@ -225,6 +234,13 @@ namespace storage
 	 */
 	void check(const CheckCallbacks* check_callbacks = nullptr) const;
 
+	/**
+	 * Estimates the memory used by all devicegraphs.
+	 *
+	 * @see Devicegraph::memory_usage()
+	 */
+	MemoryUsage memory_usage() const;
+
 	/**
 	 * Query the default mount-by method.
 	 */
@@ -251,6 +267,17 @@ namespace storage
 	 */
 	const Actiongraph* calculate_actiongraph();
 
+	/**
+	 * Like calculate_actiongraph() but if incremental is true the
+	 * actions of the last calculated actiongraph are reused for the
+	 * devices not affected by the changes of the staging devicegraph
+	 * since then. Intended for frequent recalculations after small
+	 * modifications.
+	 *
+	 * @throw Exception
+	 */
+	const Actiongraph* calculate_actiongraph(bool incremental);
+
 	/**
 	 * Activate devices like multipath, DM and MD RAID, LVM and LUKS. It
 	 * is not required to have probed the system to call this function. On
@@ -292,6 +319,24 @@ namespace storage
 	 */
 	void commit(const CommitOptions& commit_options, const CommitCallbacks* commit_callbacks = nullptr);
 
+	/**
+	 * Like commit(commit_options, commit_callbacks) but runs up to
+	 * parallelism actions at the same time. Actions are started as soon
+	 * as the actions they depend on are done. Actions changing the
+	 * partition table of a disk never run at the same time as other
+	 * actions on the disk. With a parallelism of one the actions run one
+	 * after the other.
+	 *
+	 * With a parallelism above one the CommitCallbacks may be called
+	 * from different threads, but never at the same time.
+	 *
+	 * The actiongraph must be valid.
+	 *
+	 * @throw Exception
+	 */
+	void commit_parallel(const CommitOptions& commit_options, unsigned int parallelism,
+			     const CommitCallbacks* commit_callbacks = nullptr);
+
 	/**
 	 * The actiongraph must be valid.
 	 *
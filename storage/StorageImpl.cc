@@ -340,21 +340,82 @@ namespace storage
     {
 	// check all devicegraphs
 
+	for (const map<string, Devicegraph>::value_type& key_value : devicegraphs)
+	    key_value.second.check(check_callbacks);
+
+	check_types(nullptr);
+    }
+
+
+    void
+    Storage::Impl::check_incremental(const CheckCallbacks* check_callbacks) const
+    {
+	// collect the touched sids before checking since checking resets
+	// them
+
+	bool all = false;
+	set<sid_t> sids;
+
+	for (const map<string, Devicegraph>::value_type& key_value : devicegraphs)
+	{
+	    const Devicegraph::Impl& devicegraph_impl = key_value.second.get_impl();
+
+	    if (devicegraph_impl.is_unchecked_all())
+		all = true;
+	    else
+		sids.insert(devicegraph_impl.get_unchecked_sids().begin(),
+			    devicegraph_impl.get_unchecked_sids().end());
+	}
+
+	for (const map<string, Devicegraph>::value_type& key_value : devicegraphs)
+	    key_value.second.get_impl().check_incremental(check_callbacks);
+
+	check_types(all ? nullptr : &sids);
+    }
+
+
+    MemoryUsage
+    Storage::Impl::memory_usage() const
+    {
+	MemoryUsage ret;
+
+	for (const map<string, Devicegraph>::value_type& key_value : devicegraphs)
+	    ret += key_value.second.memory_usage();
+
+	return ret;
+    }
+
+
+    void
+    Storage::Impl::check_types(const set<sid_t>* sids) const
+    {
 	// check that all objects with the same sid have the same type in all
-	// devicegraphs
+	// devicegraphs, either for all sids or only the given ones
 
 	map<sid_t, set<string>> all_sids_with_types;
 
 	for (const map<string, Devicegraph>::value_type& key_value : devicegraphs)
 	{
-	    const Devicegraph& devicegraph = key_value.second;
-
-	    devicegraph.check(check_callbacks);
+	    const Devicegraph::Impl& devicegraph_impl = key_value.second.get_impl();
 
-	    for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph.get_impl().vertices())
+	    if (!sids)
 	    {
-		const Device* device = devicegraph.get_impl()[vertex];
-		all_sids_with_types[device->get_sid()].insert(device->get_impl().get_classname());
+		for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph_impl.vertices())
+		{
+		    const Device* device = devicegraph_impl[vertex];
+		    all_sids_with_types[device->get_sid()].insert(device->get_impl().get_classname());
+		}
+	    }
+	    else
+	    {
+		for (sid_t sid : *sids)
+		{
+		    if (!devicegraph_impl.device_exists(sid))
+			continue;
+
+		    const Device* device = devicegraph_impl[devicegraph_impl.find_vertex(sid)];
+		    all_sids_with_types[sid].insert(device->get_impl().get_classname());
+		}
 	    }
 	}
 
@@ -386,11 +447,21 @@ namespace storage
 
 
     const Actiongraph*
-    Storage::Impl::calculate_actiongraph()
+    Storage::Impl::calculate_actiongraph(bool incremental)
     {
-	actiongraph.reset();	// free old actiongraph
+	Actiongraph* tmp;
+
+	if (incremental && actiongraph)
+	{
+	    tmp = new Actiongraph(storage, get_probed(), get_staging(), *actiongraph);
+	}
+	else
+	{
+	    actiongraph.reset();	// free old actiongraph
+
+	    tmp = new Actiongraph(storage, get_probed(), get_staging());
+	}
 
-	Actiongraph* tmp = new Actiongraph(storage, get_probed(), get_staging());
 	tmp->generate_compound_actions();
 
 	actiongraph.reset(tmp);
@@ -400,11 +471,12 @@ namespace storage
 
 
     void
-    Storage::Impl::commit(const CommitOptions& commit_options, const CommitCallbacks* commit_callbacks)
+    Storage::Impl::commit(const CommitOptions& commit_options, unsigned int parallelism,
+			  const CommitCallbacks* commit_callbacks)
     {
 	ST_CHECK_PTR(actiongraph.get());
 
-	actiongraph->get_impl().commit(commit_options, commit_callbacks);
+	actiongraph->get_impl().commit(commit_options, parallelism, commit_callbacks);
 
 	// TODO somehow update probed
     }
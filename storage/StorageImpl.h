@@ -26,6 +26,7 @@
 
 
 #include <map>
+#include <set>
 
 #include "storage/Utils/FileUtils.h"
 #include "storage/Storage.h"
@@ -38,6 +39,7 @@ namespace storage
 {
     using std::string;
     using std::map;
+    using std::set;
 
 
     class Storage::Impl
@@ -74,6 +76,15 @@ namespace storage
 
 	void check(const CheckCallbacks* check_callbacks) const;
 
+	/**
+	 * Like check() but uses Devicegraph::Impl::check_incremental() and
+	 * only compares the types of the touched devices across the
+	 * devicegraphs.
+	 */
+	void check_incremental(const CheckCallbacks* check_callbacks) const;
+
+	MemoryUsage memory_usage() const;
+
 	MountByType get_default_mount_by() const { return default_mount_by; }
 	void set_default_mount_by(MountByType default_mount_by) { Impl::default_mount_by = default_mount_by; }
 
@@ -82,7 +93,7 @@ namespace storage
 
 	string prepend_rootprefix(const string& mount_point) const;
 
-	const Actiongraph* calculate_actiongraph();
+	const Actiongraph* calculate_actiongraph(bool incremental);
 
 	void activate(const ActivateCallbacks* activate_callbacks) const;
 
@@ -90,7 +101,8 @@ namespace storage
 
 	void probe();
 
-	void commit(const CommitOptions& commit_options, const CommitCallbacks* commit_callbacks);
+	void commit(const CommitOptions& commit_options, unsigned int parallelism,
+		    const CommitCallbacks* commit_callbacks);
 
 	const TmpDir& get_tmp_dir() const { return tmp_dir; }
 
@@ -98,6 +110,8 @@ namespace storage
 
 	void probe_helper(Devicegraph* probed);
 
+	void check_types(const set<sid_t>* sids) const;
+
 	const Storage& storage;
 
 	const Environment environment;
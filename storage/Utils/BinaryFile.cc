@@ -0,0 +1,302 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#include <string.h>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <boost/algorithm/string.hpp>
+
+#include "storage/Utils/BinaryFile.h"
+#include "storage/Utils/XmlFile.h"
+#include "storage/Utils/AppUtil.h"
+#include "storage/Utils/ExceptionImpl.h"
+
+
+namespace storage
+{
+
+    namespace
+    {
+
+	const char magic[8] = { 'L', 'S', 'N', 'G', 'B', 'I', 'N', '\n' };
+
+	const string extension = ".bin";
+
+	// Marker used instead of an element name for text nodes.
+
+	const uint32_t text_marker = UINT32_MAX;
+
+    }
+
+
+    bool
+    is_binary_file(const string& filename)
+    {
+	ifstream file(filename, ios::binary);
+
+	char tmp[sizeof(magic)];
+	if (!file.read(tmp, sizeof(tmp)))
+	    return false;
+
+	return memcmp(tmp, magic, sizeof(magic)) == 0;
+    }
+
+
+    bool
+    has_binary_file_extension(const string& filename)
+    {
+	return boost::ends_with(filename, extension);
+    }
+
+
+    BinaryFileWriter::BinaryFileWriter()
+    {
+    }
+
+
+    void
+    BinaryFileWriter::write_uint32(uint32_t value)
+    {
+	for (int i = 0; i < 4; ++i)
+	    body.push_back((char)((value >> (8 * i)) & 0xff));
+    }
+
+
+    void
+    BinaryFileWriter::write_uint32_at(size_t position, uint32_t value)
+    {
+	for (int i = 0; i < 4; ++i)
+	    body[position + i] = (char)((value >> (8 * i)) & 0xff);
+    }
+
+
+    void
+    BinaryFileWriter::write_string(const string& value)
+    {
+	map<string, uint32_t>::const_iterator it = string_index.find(value);
+	if (it != string_index.end())
+	{
+	    write_uint32(it->second);
+	    return;
+	}
+
+	uint32_t id = strings.size();
+	strings.push_back(value);
+	string_index[value] = id;
+
+	write_uint32(id);
+    }
+
+
+    void
+    BinaryFileWriter::write_xml_children(const xmlNode* node, const vector<string>& skip)
+    {
+	vector<const xmlNode*> children;
+
+	for (const xmlNode* child = node->children; child; child = child->next)
+	{
+	    if (child->type == XML_TEXT_NODE)
+	    {
+		children.push_back(child);
+	    }
+	    else if (child->type == XML_ELEMENT_NODE)
+	    {
+		const char* name = (const char*) child->name;
+		if (find(skip.begin(), skip.end(), name) == skip.end())
+		    children.push_back(child);
+	    }
+	}
+
+	write_uint32(children.size());
+
+	for (const xmlNode* child : children)
+	{
+	    if (child->type == XML_TEXT_NODE)
+	    {
+		write_uint32(text_marker);
+		write_string(child->content ? (const char*) child->content : "");
+	    }
+	    else
+	    {
+		write_string((const char*) child->name);
+		write_xml_children(child);
+	    }
+	}
+    }
+
+
+    size_t
+    BinaryFileWriter::begin_record()
+    {
+	size_t position = body.size();
+	write_uint32(0);
+	return position;
+    }
+
+
+    void
+    BinaryFileWriter::end_record(size_t position)
+    {
+	write_uint32_at(position, body.size() - position - 4);
+    }
+
+
+    void
+    BinaryFileWriter::save(const string& filename) const
+    {
+	string header(magic, sizeof(magic));
+
+	auto append_uint32 = [&header](uint32_t value) {
+	    for (int i = 0; i < 4; ++i)
+		header.push_back((char)((value >> (8 * i)) & 0xff));
+	};
+
+	append_uint32(binary_file_version);
+
+	append_uint32(strings.size());
+	for (const string& tmp : strings)
+	{
+	    append_uint32(tmp.size());
+	    header.append(tmp);
+	}
+
+	ofstream file(filename, ios::binary | ios::trunc);
+	file.write(header.data(), header.size());
+	file.write(body.data(), body.size());
+	file.close();
+
+	if (!file)
+	    ST_THROW(Exception("failed to save binary file " + filename));
+    }
+
+
+    BinaryFileReader::BinaryFileReader(const string& filename)
+	: filename(filename), position(0)
+    {
+	ifstream file(filename, ios::binary);
+	if (!file)
+	    ST_THROW(Exception("failed to load binary file " + filename));
+
+	data.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+
+	check_available(sizeof(magic));
+	if (memcmp(data.data(), magic, sizeof(magic)) != 0)
+	    ST_THROW(Exception("wrong magic in binary file " + filename));
+	position += sizeof(magic);
+
+	uint32_t file_version = read_uint32();
+	if (file_version != binary_file_version)
+	    ST_THROW(Exception(sformat("unsupported version %d of binary file %s", file_version,
+				       filename.c_str())));
+
+	uint32_t num_strings = read_uint32();
+	strings.reserve(num_strings);
+
+	for (uint32_t i = 0; i < num_strings; ++i)
+	{
+	    uint32_t size = read_uint32();
+	    check_available(size);
+	    strings.emplace_back(data, position, size);
+	    position += size;
+	}
+    }
+
+
+    void
+    BinaryFileReader::check_available(size_t size) const
+    {
+	if (data.size() - position < size)
+	    ST_THROW(Exception("unexpected end of binary file " + filename));
+    }
+
+
+    uint32_t
+    BinaryFileReader::read_uint32()
+    {
+	check_available(4);
+
+	uint32_t value = 0;
+	for (int i = 0; i < 4; ++i)
+	    value |= (uint32_t)(unsigned char)(data[position + i]) << (8 * i);
+
+	position += 4;
+
+	return value;
+    }
+
+
+    const string&
+    BinaryFileReader::read_string()
+    {
+	uint32_t id = read_uint32();
+	if (id >= strings.size())
+	    ST_THROW(Exception("invalid string index in binary file " + filename));
+
+	return strings[id];
+    }
+
+
+    void
+    BinaryFileReader::read_xml_children(xmlNode* node)
+    {
+	uint32_t num_children = read_uint32();
+
+	for (uint32_t i = 0; i < num_children; ++i)
+	{
+	    uint32_t id = read_uint32();
+	    if (id == text_marker)
+	    {
+		xmlAddChild(node, xmlNewText((const xmlChar*) read_string().c_str()));
+	    }
+	    else
+	    {
+		if (id >= strings.size())
+		    ST_THROW(Exception("invalid string index in binary file " + filename));
+
+		xmlNode* child = xmlNewChild(node, strings[id].c_str());
+		read_xml_children(child);
+	    }
+	}
+    }
+
+
+    size_t
+    BinaryFileReader::begin_record()
+    {
+	uint32_t size = read_uint32();
+	check_available(size);
+
+	return position + size;
+    }
+
+
+    void
+    BinaryFileReader::end_record(size_t end)
+    {
+	if (position > end)
+	    ST_THROW(Exception("record overrun in binary file " + filename));
+
+	position = end;
+    }
+
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#ifndef STORAGE_BINARY_FILE_H
+#define STORAGE_BINARY_FILE_H
+
+
+#include <libxml/tree.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <boost/noncopyable.hpp>
+
+
+namespace storage
+{
+    using namespace std;
+
+
+    /**
+     * Compact binary file format used for devicegraph snapshots.
+     *
+     * The file consists of a magic, a version, a string table and a body.
+     * All integers are stored as little-endian 32 bit values. Strings are
+     * stored once in the string table and referenced by their index
+     * everywhere else. The body is a sequence of records, each prefixed
+     * with its length so that a reader can skip unknown records.
+     *
+     * Trees of xml elements, as produced by the save functions of
+     * devices and holders, can be stored in the body. They are read back
+     * without parsing xml text. The values of the elements are stored as
+     * strings, as in xml, and are converted by the load functions.
+     *
+     * So the format is only a compact container for the xml elements.
+     * Records are not decoded directly into the device and holder
+     * objects since that would need a second load and save function for
+     * every class. Loading builds a small xml node for every device and
+     * holder, and the sids, although stored as integers, are converted
+     * to strings for the load functions.
+     */
+    const uint32_t binary_file_version = 1;
+
+
+    /**
+     * Checks whether the file starts with the magic of the binary file
+     * format. Returns false if the file cannot be read.
+     */
+    bool is_binary_file(const string& filename);
+
+
+    /**
+     * Checks whether the filename has the extension used for the binary
+     * file format.
+     */
+    bool has_binary_file_extension(const string& filename);
+
+
+    class BinaryFileWriter : private boost::noncopyable
+    {
+
+    public:
+
+	BinaryFileWriter();
+
+	void write_uint32(uint32_t value);
+
+	void write_string(const string& value);
+
+	/**
+	 * Writes all children of node, except for element children named
+	 * in skip.
+	 */
+	void write_xml_children(const xmlNode* node, const vector<string>& skip = {});
+
+	/**
+	 * Starts a record. Returns the position needed for end_record().
+	 */
+	size_t begin_record();
+
+	void end_record(size_t position);
+
+	void save(const string& filename) const;
+
+    private:
+
+	string body;
+
+	vector<string> strings;
+	map<string, uint32_t> string_index;
+
+	void write_uint32_at(size_t position, uint32_t value);
+
+    };
+
+
+    class BinaryFileReader : private boost::noncopyable
+    {
+
+    public:
+
+	/**
+	 * Reads the file and its string table.
+	 *
+	 * @throw Exception
+	 */
+	BinaryFileReader(const string& filename);
+
+	uint32_t read_uint32();
+
+	const string& read_string();
+
+	/**
+	 * Reads children written by BinaryFileWriter::write_xml_children()
+	 * and adds them to node.
+	 */
+	void read_xml_children(xmlNode* node);
+
+	/**
+	 * Starts reading a record. Returns the position of the end of the
+	 * record.
+	 */
+	size_t begin_record();
+
+	/**
+	 * Skips the rest of the record, e.g. data of a newer version.
+	 */
+	void end_record(size_t end);
+
+    private:
+
+	const string filename;
+
+	string data;
+	size_t position;
+
+	vector<string> strings;
+
+	void check_available(size_t size) const;
+
+    };
+
+}
+
+#endif
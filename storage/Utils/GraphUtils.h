@@ -26,6 +26,9 @@
 
 #include <vector>
 #include <map>
+#include <boost/graph/depth_first_search.hpp>
+#include <boost/graph/breadth_first_search.hpp>
+#include <boost/property_map/property_map.hpp>
 
 
 namespace storage
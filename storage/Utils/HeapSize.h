@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#ifndef STORAGE_HEAP_SIZE_H
+#define STORAGE_HEAP_SIZE_H
+
+
+#include <string>
+#include <vector>
+#include <map>
+
+
+namespace storage
+{
+
+    /**
+     * Estimates of the heap memory owned by standard containers, not
+     * including the container object itself. Used for memory
+     * accounting. The per-node overhead of the allocator is ignored.
+     */
+
+
+    inline size_t
+    heap_size(const std::string& value)
+    {
+	// short strings are stored in the object itself, the capacity of an
+	// empty string is the capacity of that buffer
+
+	static const size_t local_capacity = std::string().capacity();
+
+	return value.capacity() > local_capacity ? value.capacity() + 1 : 0;
+    }
+
+
+    inline size_t
+    heap_size(const std::vector<std::string>& values)
+    {
+	size_t ret = values.capacity() * sizeof(std::string);
+
+	for (const std::string& value : values)
+	    ret += heap_size(value);
+
+	return ret;
+    }
+
+
+    inline size_t
+    heap_size(const std::map<std::string, std::string>& values)
+    {
+	// a red-black tree node has a color and three pointers
+
+	const size_t node_size = 4 * sizeof(void*) + sizeof(std::pair<const std::string, std::string>);
+
+	size_t ret = values.size() * node_size;
+
+	for (const std::pair<const std::string, std::string>& value : values)
+	    ret += heap_size(value.first) + heap_size(value.second);
+
+	return ret;
+    }
+
+}
+
+#endif
@@ -37,6 +37,10 @@ namespace storage
 
     /**
      * The Logger class.
+     *
+     * The functions may be called from threads other than the one calling
+     * libstorage, e.g. during parallel device checks, but never at the
+     * same time.
      */
     class Logger
     {
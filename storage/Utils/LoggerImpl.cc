@@ -21,6 +21,8 @@
  */
 
 
+#include <mutex>
+
 #include "storage/Utils/LoggerImpl.h"
 
 
@@ -32,12 +34,20 @@ namespace storage
     static const string& component = "libstorage";
 
 
+    // Loggers need not be thread-safe but libstorage also logs from
+    // additional threads, e.g. during parallel device checks or a parallel
+    // commit, so all calls of the logger are serialized.
+
+    static std::mutex logger_mutex;
+
+
     bool
     query_log_level(LogLevel log_level)
     {
 	Logger* logger = get_logger();
 	if (logger)
 	{
+	    std::lock_guard<std::mutex> lock(logger_mutex);
 	    return logger->test(log_level, component);
 	}
 
@@ -70,6 +80,8 @@ namespace storage
 	Logger* logger = get_logger();
 	if (logger)
 	{
+	    std::lock_guard<std::mutex> lock(logger_mutex);
+
 	    string content = stream->str();
 	    string::size_type pos1 = 0;
 	    while (true)
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#include <stdlib.h>
+#include <cstdint>
+#include <new>
+#include <mutex>
+
+#include "storage/Utils/MemoryPool.h"
+
+
+namespace storage
+{
+    using namespace std;
+
+
+    namespace
+    {
+
+	struct FreeBlock
+	{
+	    FreeBlock* next;
+	};
+
+
+	const size_t num_size_classes = MemoryPool::max_size / MemoryPool::granularity;
+
+	// Chunks are aligned to their size so that the chunk of a block can
+	// be found from the address of the block.
+
+	const size_t chunk_size = 16 * 1024;
+
+
+	/**
+	 * Header at the start of every chunk. A chunk only holds blocks of
+	 * one size class. Chunks with free blocks are in a doubly linked list
+	 * per size class.
+	 */
+	struct Chunk
+	{
+	    Chunk* prev;
+	    Chunk* next;
+
+	    FreeBlock* free_list;
+
+	    size_t num_used;
+	};
+
+
+	const size_t header_size = (sizeof(Chunk) + MemoryPool::granularity - 1) /
+	    MemoryPool::granularity * MemoryPool::granularity;
+
+
+	struct Pool
+	{
+	    mutex mtx;
+
+	    Chunk* partial_chunks[num_size_classes] = {};
+
+	    size_t num_chunks = 0;
+	};
+
+
+	Pool&
+	get_pool()
+	{
+	    // The pool is deliberately leaked: devicegraphs held by static
+	    // objects may be destroyed after a function-local static pool.
+
+	    static Pool* pool = new Pool();
+	    return *pool;
+	}
+
+
+	size_t
+	size_class(size_t size)
+	{
+	    return size == 0 ? 0 : (size - 1) / MemoryPool::granularity;
+	}
+
+
+	size_t
+	block_size(size_t sc)
+	{
+	    return (sc + 1) * MemoryPool::granularity;
+	}
+
+
+	void
+	link(Chunk*& head, Chunk* chunk)
+	{
+	    chunk->prev = nullptr;
+	    chunk->next = head;
+	    if (head)
+		head->prev = chunk;
+	    head = chunk;
+	}
+
+
+	void
+	unlink(Chunk*& head, Chunk* chunk)
+	{
+	    if (chunk->prev)
+		chunk->prev->next = chunk->next;
+	    else
+		head = chunk->next;
+
+	    if (chunk->next)
+		chunk->next->prev = chunk->prev;
+	}
+
+
+	Chunk*
+	new_chunk(Pool& pool, size_t sc)
+	{
+	    void* memory = nullptr;
+	    if (posix_memalign(&memory, chunk_size, chunk_size) != 0)
+		throw bad_alloc();
+
+	    ++pool.num_chunks;
+
+	    Chunk* chunk = static_cast<Chunk*>(memory);
+	    chunk->free_list = nullptr;
+	    chunk->num_used = 0;
+
+	    const size_t size = block_size(sc);
+	    const size_t num_blocks = (chunk_size - header_size) / size;
+
+	    char* blocks = static_cast<char*>(memory) + header_size;
+
+	    for (size_t i = num_blocks; i > 0; --i)
+	    {
+		FreeBlock* block = reinterpret_cast<FreeBlock*>(blocks + (i - 1) * size);
+		block->next = chunk->free_list;
+		chunk->free_list = block;
+	    }
+
+	    return chunk;
+	}
+
+    }
+
+
+    void*
+    MemoryPool::allocate(size_t size)
+    {
+	if (size > max_size)
+	    return ::operator new(size);
+
+	const size_t sc = size_class(size);
+
+	Pool& pool = get_pool();
+
+	lock_guard<mutex> lock(pool.mtx);
+
+	Chunk*& head = pool.partial_chunks[sc];
+
+	if (!head)
+	    link(head, new_chunk(pool, sc));
+
+	Chunk* chunk = head;
+
+	FreeBlock* block = chunk->free_list;
+	chunk->free_list = block->next;
+	++chunk->num_used;
+
+	// a full chunk is only linked again once a block is freed
+
+	if (!chunk->free_list)
+	    unlink(head, chunk);
+
+	return block;
+    }
+
+
+    void
+    MemoryPool::deallocate(void* ptr, size_t size) noexcept
+    {
+	if (!ptr)
+	    return;
+
+	if (size > max_size)
+	{
+	    ::operator delete(ptr);
+	    return;
+	}
+
+	const size_t sc = size_class(size);
+
+	Pool& pool = get_pool();
+
+	lock_guard<mutex> lock(pool.mtx);
+
+	Chunk* chunk = reinterpret_cast<Chunk*>(reinterpret_cast<uintptr_t>(ptr) & ~(chunk_size - 1));
+
+	Chunk*& head = pool.partial_chunks[sc];
+
+	if (!chunk->free_list)
+	    link(head, chunk);
+
+	FreeBlock* block = static_cast<FreeBlock*>(ptr);
+	block->next = chunk->free_list;
+	chunk->free_list = block;
+	--chunk->num_used;
+
+	// A chunk that became completely free is returned to the system
+	// unless it is the only chunk of the size class with free blocks.
+	// So allocating and freeing a single object does not allocate and
+	// free a chunk every time.
+
+	if (chunk->num_used == 0 && (chunk->prev || chunk->next))
+	{
+	    unlink(head, chunk);
+	    free(chunk);
+	    --pool.num_chunks;
+	}
+    }
+
+
+    size_t
+    MemoryPool::num_chunks()
+    {
+	Pool& pool = get_pool();
+
+	lock_guard<mutex> lock(pool.mtx);
+
+	return pool.num_chunks;
+    }
+
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#ifndef STORAGE_MEMORY_POOL_H
+#define STORAGE_MEMORY_POOL_H
+
+
+#include <cstddef>
+#include <memory>
+
+
+namespace storage
+{
+
+    /**
+     * Pool for the many small objects of a devicegraph, e.g. the Impl
+     * objects of devices and holders and the control blocks of the
+     * shared_ptrs in the graph. Memory is carved from larger chunks, each
+     * holding objects of one size class, and freed objects are reused.
+     * This reduces the number of malloc calls when loading or probing
+     * devicegraphs and the fragmentation of long running processes.
+     *
+     * A chunk whose objects are all freed, e.g. after a devicegraph was
+     * destroyed, is returned to the system. Only one completely free
+     * chunk per size class is kept for reuse.
+     *
+     * Objects larger than max_size are passed on to the global operator
+     * new and delete.
+     *
+     * The functions are thread-safe.
+     */
+    class MemoryPool
+    {
+    public:
+
+	static const size_t granularity = 16;
+	static const size_t max_size = 1024;
+
+	static void* allocate(size_t size);
+	static void deallocate(void* ptr, size_t size) noexcept;
+
+	/**
+	 * Number of chunks currently allocated. Only for testing.
+	 */
+	static size_t num_chunks();
+
+    };
+
+
+    /**
+     * Allocator for std containers and std::allocate_shared using the
+     * MemoryPool.
+     */
+    template <typename Type>
+    class PoolAllocator
+    {
+    public:
+
+	typedef Type value_type;
+
+	PoolAllocator() noexcept = default;
+
+	template <typename Other>
+	PoolAllocator(const PoolAllocator<Other>&) noexcept {}
+
+	Type* allocate(size_t n)
+	{
+	    return static_cast<Type*>(MemoryPool::allocate(n * sizeof(Type)));
+	}
+
+	void deallocate(Type* ptr, size_t n) noexcept
+	{
+	    MemoryPool::deallocate(ptr, n * sizeof(Type));
+	}
+
+    };
+
+
+    template <typename Type1, typename Type2>
+    bool operator==(const PoolAllocator<Type1>&, const PoolAllocator<Type2>&) { return true; }
+
+    template <typename Type1, typename Type2>
+    bool operator!=(const PoolAllocator<Type1>&, const PoolAllocator<Type2>&) { return false; }
+
+
+    /**
+     * Base class providing class specific operator new and delete using
+     * the MemoryPool. The destructor of derived classes must be virtual
+     * so that operator delete gets the size of the dynamic type.
+     */
+    class PoolAllocated
+    {
+    public:
+
+	static void* operator new(size_t size) { return MemoryPool::allocate(size); }
+	static void operator delete(void* ptr, size_t size) noexcept { MemoryPool::deallocate(ptr, size); }
+
+    };
+
+}
+
+#endif
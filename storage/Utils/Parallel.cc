@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#include <cstdlib>
+#include <exception>
+#include <thread>
+#include <condition_variable>
+#include <vector>
+#include <set>
+#include <map>
+#include <algorithm>
+#include <boost/lexical_cast.hpp>
+
+#include "storage/Utils/Parallel.h"
+#include "storage/Utils/ExceptionImpl.h"
+
+
+namespace storage
+{
+    using namespace std;
+
+
+    namespace
+    {
+
+	// Below this number of items starting threads costs more than it
+	// saves.
+
+	const size_t min_items_for_threads = 1000;
+
+
+	// The lock of parallel_for_dag() held by the current thread.
+
+	thread_local unique_lock<mutex>* thread_lock = nullptr;
+
+    }
+
+
+    unsigned int
+    num_threads_for(size_t n)
+    {
+	if (n < min_items_for_threads)
+	    return 1;
+
+	unsigned int ret = thread::hardware_concurrency();
+
+	const char* tenv = getenv("LIBSTORAGE_THREADS");
+	if (tenv)
+	{
+	    try
+	    {
+		ret = boost::lexical_cast<unsigned int>(tenv);
+	    }
+	    catch (const boost::bad_lexical_cast&)
+	    {
+	    }
+	}
+
+	return max(ret, 1U);
+    }
+
+
+    void
+    parallel_for_chunks(size_t n, unsigned int num_chunks,
+			const function<void(unsigned int chunk, size_t begin, size_t end)>& func)
+    {
+	num_chunks = max(num_chunks, 1U);
+
+	vector<exception_ptr> exceptions(num_chunks);
+
+	auto worker = [n, num_chunks, &func, &exceptions](unsigned int chunk) {
+	    try
+	    {
+		func(chunk, n * chunk / num_chunks, n * (chunk + 1) / num_chunks);
+	    }
+	    catch (...)
+	    {
+		exceptions[chunk] = current_exception();
+	    }
+	};
+
+	vector<thread> threads;
+	threads.reserve(num_chunks - 1);
+
+	for (unsigned int chunk = 1; chunk < num_chunks; ++chunk)
+	    threads.emplace_back(worker, chunk);
+
+	worker(0);
+
+	for (thread& t : threads)
+	    t.join();
+
+	for (const exception_ptr& exception : exceptions)
+	{
+	    if (exception)
+		rethrow_exception(exception);
+	}
+    }
+
+
+
+    void
+    parallel_for_dag(const vector<vector<size_t>>& successors, const vector<vector<size_t>>& exclusive_keys,
+		     const vector<vector<size_t>>& shared_keys, const vector<double>& priorities,
+		     unsigned int num_threads,
+		     const function<void(size_t task)>& func)
+    {
+	const size_t n = successors.size();
+
+	vector<size_t> num_predecessors(n, 0);
+	for (const vector<size_t>& tmp : successors)
+	{
+	    for (size_t successor : tmp)
+		++num_predecessors[successor];
+	}
+
+	auto priority = [&priorities](size_t task) {
+	    return priorities.empty() ? 0.0 : priorities[task];
+	};
+
+	// The ready tasks ordered by descending priority and ascending index.
+
+	set<pair<double, size_t>> ready;
+	for (size_t task = 0; task < n; ++task)
+	{
+	    if (num_predecessors[task] == 0)
+		ready.emplace(-priority(task), task);
+	}
+
+	// The keys of the running tasks, mapped to the number of running
+	// tasks having the key as shared key or to exclusive_holder.
+
+	const int exclusive_holder = -1;
+
+	map<size_t, int> busy_keys;
+
+	size_t num_running = 0;
+	size_t num_done = 0;
+
+	exception_ptr exception;
+
+	mutex m;
+	condition_variable cv;
+
+	const vector<size_t> no_keys;
+
+	auto exclusive_keys_of = [&exclusive_keys, &no_keys](size_t task) -> const vector<size_t>& {
+	    return exclusive_keys.empty() ? no_keys : exclusive_keys[task];
+	};
+
+	auto shared_keys_of = [&shared_keys, &no_keys](size_t task) -> const vector<size_t>& {
+	    return shared_keys.empty() ? no_keys : shared_keys[task];
+	};
+
+	// Returns the first ready task whose exclusive keys are all not busy
+	// and whose shared keys are all not busy as exclusive keys or n if
+	// there is none.
+
+	auto next_task = [&]() {
+	    for (const pair<double, size_t>& tmp : ready)
+	    {
+		size_t task = tmp.second;
+
+		const vector<size_t>& task_exclusive_keys = exclusive_keys_of(task);
+		if (any_of(task_exclusive_keys.begin(), task_exclusive_keys.end(), [&busy_keys](size_t key) {
+		    return busy_keys.find(key) != busy_keys.end();
+		}))
+		    continue;
+
+		const vector<size_t>& task_shared_keys = shared_keys_of(task);
+		if (any_of(task_shared_keys.begin(), task_shared_keys.end(), [&](size_t key) {
+		    map<size_t, int>::const_iterator it = busy_keys.find(key);
+		    return it != busy_keys.end() && it->second == exclusive_holder;
+		}))
+		    continue;
+
+		return task;
+	    }
+
+	    return n;
+	};
+
+	auto worker = [&]() {
+
+	    unique_lock<mutex> lock(m);
+
+	    unique_lock<mutex>* old_thread_lock = thread_lock;
+	    thread_lock = &lock;
+
+	    while (!exception && num_done != n)
+	    {
+		size_t task = next_task();
+		if (task == n)
+		{
+		    if (num_running == 0)
+		    {
+			exception = make_exception_ptr(LogicException("graph of tasks has a cycle"));
+			cv.notify_all();
+			break;
+		    }
+
+		    cv.wait(lock);
+		    continue;
+		}
+
+		ready.erase(make_pair(-priority(task), task));
+		for (size_t key : exclusive_keys_of(task))
+		    busy_keys[key] = exclusive_holder;
+		for (size_t key : shared_keys_of(task))
+		    ++busy_keys[key];
+		++num_running;
+
+		try
+		{
+		    func(task);
+		}
+		catch (...)
+		{
+		    if (!exception)
+			exception = current_exception();
+		}
+
+		--num_running;
+		for (size_t key : exclusive_keys_of(task))
+		    busy_keys.erase(key);
+		for (size_t key : shared_keys_of(task))
+		{
+		    if (--busy_keys[key] == 0)
+			busy_keys.erase(key);
+		}
+		++num_done;
+
+		for (size_t successor : successors[task])
+		{
+		    if (--num_predecessors[successor] == 0)
+			ready.emplace(-priority(successor), successor);
+		}
+
+		cv.notify_all();
+	    }
+
+	    thread_lock = old_thread_lock;
+
+	};
+
+	num_threads = max<size_t>(min<size_t>(num_threads, n), 1);
+
+	vector<thread> threads;
+	threads.reserve(num_threads - 1);
+
+	for (unsigned int i = 1; i < num_threads; ++i)
+	    threads.emplace_back(worker);
+
+	worker();
+
+	for (thread& t : threads)
+	    t.join();
+
+	if (exception)
+	    rethrow_exception(exception);
+    }
+
+
+    BlockingCall::BlockingCall()
+	: lock(thread_lock)
+    {
+	// Nested blocking calls must not release the lock again.
+
+	thread_lock = nullptr;
+
+	if (lock)
+	    lock->unlock();
+    }
+
+
+    BlockingCall::~BlockingCall()
+    {
+	if (lock)
+	    lock->lock();
+
+	thread_lock = lock;
+    }
+
+}
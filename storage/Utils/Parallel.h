@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2017 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#ifndef STORAGE_PARALLEL_H
+#define STORAGE_PARALLEL_H
+
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include <mutex>
+#include <boost/noncopyable.hpp>
+
+
+namespace storage
+{
+
+    /**
+     * Number of threads to use for parallel work on n items. One (so no
+     * additional threads) for small n. Otherwise the number of hardware
+     * threads. The environment variable LIBSTORAGE_THREADS overrides the
+     * number of hardware threads, e.g. LIBSTORAGE_THREADS=1 disables
+     * parallel work.
+     */
+    unsigned int num_threads_for(size_t n);
+
+
+    /**
+     * Splits [0, n) into num_chunks consecutive chunks and calls
+     * func(chunk, begin, end) for each chunk, each in its own thread. The
+     * calling thread handles chunk 0. Returns when all chunks are done.
+     *
+     * If func throws for several chunks the exception of the chunk with
+     * the lowest index is rethrown, so the result is the same as with
+     * serial processing of the chunks.
+     */
+    void parallel_for_chunks(size_t n, unsigned int num_chunks,
+			     const std::function<void(unsigned int chunk, size_t begin, size_t end)>& func);
+
+
+    /**
+     * Calls func(task) for the tasks [0, n) of a directed acyclic graph
+     * using up to num_threads threads, the calling thread included. The
+     * successors of task i are successors[i]. A task is started once all
+     * its predecessors are done, among the ready tasks the one with the
+     * highest priority and among those the one with the lowest index
+     * first. An empty priorities means the same priority for all tasks.
+     * So with one thread and equal priorities the tasks run in index order
+     * if that order is a topological order. Tasks sharing any of their
+     * exclusive keys, exclusive_keys[i] for task i, never run at the same
+     * time. A task never runs at the same time as a task having one of
+     * its shared keys, shared_keys[i] for task i, as exclusive key, but
+     * tasks with the same shared key can. An empty exclusive_keys or
+     * shared_keys means no such keys for all tasks.
+     *
+     * All calls of func are serialized by a lock, except for the parts
+     * inside a BlockingCall, e.g. SystemCmd waiting for a command. So func
+     * can use shared state, e.g. devicegraphs or callbacks, while the slow
+     * parts run in parallel.
+     *
+     * If func throws no further tasks are started. Once the running tasks
+     * are done the first exception is rethrown.
+     */
+    void parallel_for_dag(const std::vector<std::vector<size_t>>& successors,
+			  const std::vector<std::vector<size_t>>& exclusive_keys,
+			  const std::vector<std::vector<size_t>>& shared_keys,
+			  const std::vector<double>& priorities,
+			  unsigned int num_threads, const std::function<void(size_t task)>& func);
+
+
+    /**
+     * Releases the lock of parallel_for_dag() held by the current thread,
+     * if any, for the lifetime of the object. Must only be used around
+     * code not using shared state.
+     */
+    class BlockingCall : private boost::noncopyable
+    {
+    public:
+
+	BlockingCall();
+	~BlockingCall();
+
+    private:
+
+	std::unique_lock<std::mutex>* lock;
+
+    };
+
+}
+
+#endif
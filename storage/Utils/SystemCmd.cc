@@ -38,6 +38,7 @@
 #include "storage/Utils/SystemCmd.h"
 #include "storage/Utils/Mockup.h"
 #include "storage/Utils/OutputProcessor.h"
+#include "storage/Utils/Parallel.h"
 #include "storage/Utils/StorageDefines.h"
 
 
@@ -395,7 +396,12 @@ namespace storage
 		    }
 		    if ( !_execInBackground )
 		    {
-			doWait( true, _cmdRet );
+			{
+			    // Let other threads of a parallel commit continue
+			    // while waiting for the command.
+			    BlockingCall blocking_call;
+			    doWait( true, _cmdRet );
+			}
 			y2mil("stopwatch " << stopwatch << " for \"" << command() << "\"");
 		    }
 		    break;
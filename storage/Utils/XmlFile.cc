@@ -51,6 +51,69 @@ namespace storage
     }
 
 
+    XmlReader::XmlReader(const string& filename)
+	: filename(filename), reader(xmlReaderForFile(filename.c_str(), NULL, XML_PARSE_NOBLANKS |
+						       XML_PARSE_NONET)),
+	  skip_subtree(false)
+    {
+	if (!reader)
+	    ST_THROW(Exception("failed to load xml document " + filename));
+    }
+
+
+    XmlReader::~XmlReader()
+    {
+	xmlFreeTextReader(reader);
+    }
+
+
+    bool
+    XmlReader::next_element()
+    {
+	while (true)
+	{
+	    int ret = skip_subtree ? xmlTextReaderNext(reader) : xmlTextReaderRead(reader);
+	    skip_subtree = false;
+
+	    if (ret < 0)
+		ST_THROW(Exception("failed to parse xml document " + filename));
+
+	    if (ret == 0)
+		return false;
+
+	    if (xmlTextReaderNodeType(reader) == XML_READER_TYPE_ELEMENT)
+		return true;
+	}
+    }
+
+
+    int
+    XmlReader::get_depth() const
+    {
+	return xmlTextReaderDepth(reader);
+    }
+
+
+    const char*
+    XmlReader::get_name() const
+    {
+	return (const char*) xmlTextReaderConstName(reader);
+    }
+
+
+    const xmlNode*
+    XmlReader::expand()
+    {
+	const xmlNode* node = xmlTextReaderExpand(reader);
+	if (!node)
+	    ST_THROW(Exception("failed to parse xml document " + filename));
+
+	skip_subtree = true;
+
+	return node->children;
+    }
+
+
     xmlNode*
     xmlNewNode(const char* name)
     {
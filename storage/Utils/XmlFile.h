@@ -25,6 +25,7 @@
 
 
 #include <libxml/tree.h>
+#include <libxml/xmlreader.h>
 #include <string>
 #include <vector>
 #include <sstream>
@@ -64,6 +65,55 @@ namespace storage
     };
 
 
+    /**
+     * Streaming reader for xml files. Unlike XmlFile the document is not
+     * kept in memory, only the element expanded last.
+     */
+    class XmlReader : private boost::noncopyable
+    {
+
+    public:
+
+	XmlReader(const string& filename);
+
+	~XmlReader();
+
+	/**
+	 * Advances to the next element in document order. If the current
+	 * element was expanded its subtree is skipped. Returns false at the
+	 * end of the document.
+	 *
+	 * @throw Exception
+	 */
+	bool next_element();
+
+	/**
+	 * Depth of the current element, zero for the root element.
+	 */
+	int get_depth() const;
+
+	const char* get_name() const;
+
+	/**
+	 * Reads the subtree of the current element and returns its first
+	 * child, like getChildNode(). The nodes are only valid until the
+	 * next call of next_element().
+	 *
+	 * @throw Exception
+	 */
+	const xmlNode* expand();
+
+    private:
+
+	const string filename;
+
+	xmlTextReader* reader;
+
+	bool skip_subtree;
+
+    };
+
+
     xmlNode* xmlNewNode(const char* name);
     xmlNode* xmlNewComment(const char* content);
 
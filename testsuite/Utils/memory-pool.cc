@@ -0,0 +1,137 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "storage/Utils/MemoryPool.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(reuse)
+{
+    void* p1 = MemoryPool::allocate(100);
+    MemoryPool::deallocate(p1, 100);
+
+    // same size class
+
+    void* p2 = MemoryPool::allocate(112);
+    BOOST_CHECK_EQUAL(p1, p2);
+    MemoryPool::deallocate(p2, 112);
+}
+
+
+BOOST_AUTO_TEST_CASE(alignment_and_distinctness)
+{
+    vector<void*> ptrs;
+    set<void*> unique;
+
+    for (size_t i = 0; i < 1000; ++i)
+    {
+	size_t size = 1 + i % MemoryPool::max_size;
+	void* p = MemoryPool::allocate(size);
+	BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(p) % MemoryPool::granularity, 0);
+	ptrs.push_back(p);
+	unique.insert(p);
+    }
+
+    BOOST_CHECK_EQUAL(unique.size(), ptrs.size());
+
+    for (size_t i = 0; i < ptrs.size(); ++i)
+	MemoryPool::deallocate(ptrs[i], 1 + i % MemoryPool::max_size);
+}
+
+
+BOOST_AUTO_TEST_CASE(no_new_chunks_after_free)
+{
+    vector<void*> ptrs;
+
+    for (size_t i = 0; i < 500; ++i)
+	ptrs.push_back(MemoryPool::allocate(48));
+    for (void* p : ptrs)
+	MemoryPool::deallocate(p, 48);
+
+    size_t num_chunks = MemoryPool::num_chunks();
+
+    ptrs.clear();
+    for (size_t i = 0; i < 500; ++i)
+	ptrs.push_back(MemoryPool::allocate(48));
+    for (void* p : ptrs)
+	MemoryPool::deallocate(p, 48);
+
+    BOOST_CHECK_EQUAL(MemoryPool::num_chunks(), num_chunks);
+}
+
+
+BOOST_AUTO_TEST_CASE(free_chunks_are_released)
+{
+    const size_t num_chunks = MemoryPool::num_chunks();
+
+    vector<void*> ptrs;
+
+    for (size_t i = 0; i < 10000; ++i)
+	ptrs.push_back(MemoryPool::allocate(64));
+
+    BOOST_CHECK(MemoryPool::num_chunks() > num_chunks + 10);
+
+    for (void* p : ptrs)
+	MemoryPool::deallocate(p, 64);
+
+    // at most one completely free chunk is kept
+
+    BOOST_CHECK(MemoryPool::num_chunks() <= num_chunks + 1);
+}
+
+
+namespace
+{
+
+    struct Base : public PoolAllocated
+    {
+	virtual ~Base() {}
+    };
+
+    struct Derived : public Base
+    {
+	char data[200];
+    };
+
+}
+
+
+BOOST_AUTO_TEST_CASE(pool_allocated)
+{
+    Base* b = new Derived();
+    delete b;
+
+    // the block of the Derived is reused for an object of the same size
+
+    void* p = MemoryPool::allocate(sizeof(Derived));
+    BOOST_CHECK_EQUAL(p, static_cast<void*>(b));
+    MemoryPool::deallocate(p, sizeof(Derived));
+}
+
+
+BOOST_AUTO_TEST_CASE(shared_ptr_with_pool_allocator)
+{
+    shared_ptr<int> ptr(new int(42), default_delete<int>(), PoolAllocator<int>());
+    BOOST_CHECK_EQUAL(*ptr, 42);
+
+    shared_ptr<int> copy = ptr;
+    BOOST_CHECK_EQUAL(ptr.use_count(), 2);
+}
+
+
+BOOST_AUTO_TEST_CASE(large)
+{
+    void* p = MemoryPool::allocate(10 * MemoryPool::max_size);
+    MemoryPool::deallocate(p, 10 * MemoryPool::max_size);
+}
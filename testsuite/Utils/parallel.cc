@@ -0,0 +1,84 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "storage/Utils/Parallel.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(chunks)
+{
+    for (unsigned int num_chunks : { 1, 2, 3, 7 })
+    {
+	vector<unsigned int> visited(100, 0);
+	vector<size_t> begins(num_chunks);
+
+	parallel_for_chunks(visited.size(), num_chunks, [&visited, &begins](unsigned int chunk,
+									     size_t begin, size_t end) {
+	    begins[chunk] = begin;
+	    for (size_t i = begin; i < end; ++i)
+		++visited[i];
+	});
+
+	for (unsigned int count : visited)
+	    BOOST_CHECK_EQUAL(count, 1);
+
+	// chunks are consecutive
+
+	for (unsigned int chunk = 1; chunk < num_chunks; ++chunk)
+	    BOOST_CHECK(begins[chunk - 1] <= begins[chunk]);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(empty)
+{
+    atomic<unsigned int> items(0);
+
+    parallel_for_chunks(0, 4, [&items](unsigned int, size_t begin, size_t end) {
+	items += end - begin;
+    });
+
+    BOOST_CHECK_EQUAL(items, 0);
+}
+
+
+BOOST_AUTO_TEST_CASE(exceptions)
+{
+    // the exception of the lowest chunk is rethrown
+
+    try
+    {
+	parallel_for_chunks(100, 4, [](unsigned int chunk, size_t, size_t) {
+	    if (chunk >= 1)
+		throw runtime_error(to_string(chunk));
+	});
+
+	BOOST_FAIL("no exception thrown");
+    }
+    catch (const runtime_error& e)
+    {
+	BOOST_CHECK_EQUAL(e.what(), string("1"));
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(threads)
+{
+    BOOST_CHECK_EQUAL(num_threads_for(10), 1);
+
+    setenv("LIBSTORAGE_THREADS", "3", 1);
+    BOOST_CHECK_EQUAL(num_threads_for(10), 1);
+    BOOST_CHECK_EQUAL(num_threads_for(10000), 3);
+
+    setenv("LIBSTORAGE_THREADS", "0", 1);
+    BOOST_CHECK_EQUAL(num_threads_for(10000), 1);
+}
@@ -0,0 +1,72 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include <unistd.h>
+#include <fstream>
+
+#include "storage/Utils/XmlFile.h"
+#include "storage/Utils/Exception.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(elements)
+{
+    ofstream("xml-reader.xml") << "<?xml version=\"1.0\"?>\n"
+			       << "<!-- comment -->\n"
+			       << "<A>\n"
+			       << "  <B>\n"
+			       << "    <C>\n"
+			       << "      <x>1</x>\n"
+			       << "      <y>2</y>\n"
+			       << "    </C>\n"
+			       << "    <D/>\n"
+			       << "  </B>\n"
+			       << "  <E>3</E>\n"
+			       << "</A>\n";
+
+    XmlReader reader("xml-reader.xml");
+
+    string names;
+
+    while (reader.next_element())
+    {
+	names += string(reader.get_name()) + ":" + to_string(reader.get_depth()) + " ";
+
+	if (reader.get_name() == string("C"))
+	{
+	    // the subtree of C is skipped after expanding
+
+	    const xmlNode* node = reader.expand();
+
+	    int x = 0, y = 0;
+	    BOOST_CHECK(getChildValue(node, "x", x));
+	    BOOST_CHECK(getChildValue(node, "y", y));
+	    BOOST_CHECK_EQUAL(x, 1);
+	    BOOST_CHECK_EQUAL(y, 2);
+	}
+    }
+
+    BOOST_CHECK_EQUAL(names, "A:0 B:1 C:2 D:2 E:1 ");
+
+    unlink("xml-reader.xml");
+}
+
+
+BOOST_AUTO_TEST_CASE(malformed)
+{
+    ofstream("xml-reader.xml") << "<?xml version=\"1.0\"?>\n"
+			       << "<A>\n"
+			       << "  <B>\n"
+			       << "</A>\n";
+
+    XmlReader reader("xml-reader.xml");
+
+    BOOST_CHECK_THROW({ while (reader.next_element()); }, Exception);
+
+    unlink("xml-reader.xml");
+}
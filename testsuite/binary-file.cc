@@ -0,0 +1,102 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include <unistd.h>
+#include <fstream>
+#include <sstream>
+
+#include "storage/Devicegraph.h"
+#include "storage/Environment.h"
+#include "storage/Storage.h"
+#include "storage/Utils/BinaryFile.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+string
+read_file(const string& filename)
+{
+    ifstream file(filename);
+    ostringstream tmp;
+    tmp << file.rdbuf();
+    return tmp.str();
+}
+
+
+string
+read_xml_file_without_comments(const string& filename)
+{
+    ifstream file(filename);
+
+    string ret;
+    string line;
+    while (getline(file, line))
+	if (line.find("<!--") == string::npos)
+	    ret += line + '\n';
+
+    return ret;
+}
+
+
+BOOST_AUTO_TEST_CASE(round_trip)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    for (const char* name : { "disk", "dasd1", "multipath1", "lvm1", "luks1", "md1", "btrfs1",
+				"bcache1" })
+    {
+	BOOST_TEST_MESSAGE("devicegraph " << name);
+
+	Devicegraph* xml = storage.create_devicegraph("xml");
+	xml->load(string("probe/") + name + "-devicegraph.xml");
+
+	xml->save("binary-file.bin");
+	BOOST_CHECK(is_binary_file("binary-file.bin"));
+
+	Devicegraph* binary = storage.create_devicegraph("binary");
+	binary->load("binary-file.bin");
+
+	BOOST_CHECK(*xml == *binary);
+
+	// saving the loaded devicegraph as xml gives the same file
+
+	xml->save("binary-file-lhs.xml");
+	binary->save("binary-file-rhs.xml");
+
+	BOOST_CHECK(!is_binary_file("binary-file-lhs.xml"));
+	BOOST_CHECK_EQUAL(read_xml_file_without_comments("binary-file-lhs.xml"),
+			  read_xml_file_without_comments("binary-file-rhs.xml"));
+
+	storage.remove_devicegraph("xml");
+	storage.remove_devicegraph("binary");
+    }
+
+    unlink("binary-file.bin");
+    unlink("binary-file-lhs.xml");
+    unlink("binary-file-rhs.xml");
+}
+
+
+BOOST_AUTO_TEST_CASE(truncated)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.create_devicegraph("tmp");
+    devicegraph->load("probe/lvm1-devicegraph.xml");
+    devicegraph->save("binary-file.bin");
+
+    string data = read_file("binary-file.bin");
+    ofstream("binary-file.bin", ios::binary | ios::trunc) << data.substr(0, data.size() / 2);
+
+    BOOST_CHECK_THROW(devicegraph->load("binary-file.bin"), Exception);
+
+    unlink("binary-file.bin");
+}
@@ -0,0 +1,126 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Devices/PartitionTable.h"
+#include "storage/Filesystems/BlkFilesystem.h"
+#include "storage/Environment.h"
+#include "storage/Storage.h"
+#include "storage/Devicegraph.h"
+#include "storage/Actiongraph.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+namespace
+{
+
+    void
+    create_partition_with_filesystem(Devicegraph* devicegraph, const string& disk_name)
+    {
+	Disk* disk = Disk::find_by_name(devicegraph, disk_name);
+
+	PartitionTable* gpt = disk->create_partition_table(PtType::GPT);
+
+	Partition* partition = gpt->create_partition(disk_name + "1", Region(2048, 2 * 1024 * 1024, 512),
+						     PartitionType::PRIMARY);
+
+	partition->create_blk_filesystem(FsType::EXT4);
+    }
+
+
+    CommitCosts
+    unit_costs()
+    {
+	CommitCosts commit_costs;
+
+	commit_costs.parted = 1.0;
+	commit_costs.udevadm_settle = 0.0;
+	commit_costs.mkfs = 1.0;
+	commit_costs.mkfs_per_gib = 0.0;
+	commit_costs.other = 0.0;
+
+	return commit_costs;
+    }
+
+}
+
+
+BOOST_AUTO_TEST_CASE(empty_actiongraph)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* lhs = storage.create_devicegraph("lhs");
+    Disk::create(lhs, "/dev/sda", Region(0, 100000000, 512));
+
+    Devicegraph* rhs = storage.copy_devicegraph("lhs", "rhs");
+
+    const CommitEstimate commit_estimate = Actiongraph(storage, lhs, rhs).estimate_commit();
+
+    BOOST_CHECK_EQUAL(commit_estimate.total_work, 0.0);
+    BOOST_CHECK_EQUAL(commit_estimate.critical_path, 0.0);
+    BOOST_CHECK_EQUAL(commit_estimate.parallelism, 1.0);
+}
+
+
+BOOST_AUTO_TEST_CASE(one_disk)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* lhs = storage.create_devicegraph("lhs");
+    Disk::create(lhs, "/dev/sda", Region(0, 100000000, 512));
+
+    Devicegraph* rhs = storage.copy_devicegraph("lhs", "rhs");
+    create_partition_with_filesystem(rhs, "/dev/sda");
+
+    const Actiongraph actiongraph(storage, lhs, rhs);
+
+    // create partition table, create partition and mkfs run one after
+    // the other
+
+    const CommitEstimate commit_estimate = actiongraph.estimate_commit(unit_costs());
+
+    BOOST_CHECK_CLOSE(commit_estimate.total_work, 3.0, 1e-6);
+    BOOST_CHECK_CLOSE(commit_estimate.critical_path, 3.0, 1e-6);
+    BOOST_CHECK_CLOSE(commit_estimate.parallelism, 1.0, 1e-6);
+
+    // the cost of mkfs grows with the size of the filesystem, here 1 GiB
+
+    CommitCosts commit_costs = unit_costs();
+    commit_costs.mkfs_per_gib = 2.0;
+
+    BOOST_CHECK_CLOSE(actiongraph.estimate_commit(commit_costs).total_work, 5.0, 1e-6);
+}
+
+
+BOOST_AUTO_TEST_CASE(two_disks)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* lhs = storage.create_devicegraph("lhs");
+    Disk::create(lhs, "/dev/sda", Region(0, 100000000, 512));
+    Disk::create(lhs, "/dev/sdb", Region(0, 100000000, 512));
+
+    Devicegraph* rhs = storage.copy_devicegraph("lhs", "rhs");
+    create_partition_with_filesystem(rhs, "/dev/sda");
+    create_partition_with_filesystem(rhs, "/dev/sdb");
+
+    // the actions on the two disks are independent
+
+    const CommitEstimate commit_estimate = Actiongraph(storage, lhs, rhs).estimate_commit(unit_costs());
+
+    BOOST_CHECK_CLOSE(commit_estimate.total_work, 6.0, 1e-6);
+    BOOST_CHECK_CLOSE(commit_estimate.critical_path, 3.0, 1e-6);
+    BOOST_CHECK_CLOSE(commit_estimate.parallelism, 2.0, 1e-6);
+}
@@ -51,10 +51,24 @@ BOOST_AUTO_TEST_CASE(copy)
 
     devicegraph->check();
 
+    const unsigned long long modification_counter = devicegraph->get_modification_counter();
+
     Devicegraph* devicegraph_copy = storage.copy_devicegraph("staging", "copy");
 
     BOOST_CHECK_EQUAL(devicegraph_copy->num_devices(), 8);
     BOOST_CHECK_EQUAL(devicegraph_copy->num_holders(), 2);
 
     devicegraph_copy->check();
+
+    BOOST_CHECK(*devicegraph_copy == *devicegraph);
+
+    const Holder* holder = devicegraph_copy->find_holder(gpt->get_sid(), sda1->get_sid());
+    BOOST_CHECK(holder != devicegraph->find_holder(gpt->get_sid(), sda1->get_sid()));
+    BOOST_CHECK_EQUAL(holder->get_source(), devicegraph_copy->find_device(gpt->get_sid()));
+    BOOST_CHECK_EQUAL(holder->get_target(), devicegraph_copy->find_device(sda1->get_sid()));
+
+    // neither copying nor reading modifies the original
+
+    BOOST_CHECK_EQUAL(sda->get_children().size(), 1);
+    BOOST_CHECK_EQUAL(devicegraph->get_modification_counter(), modification_counter);
 }
@@ -0,0 +1,153 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Utils/HumanString.h"
+#include "storage/Devices/DiskImpl.h"
+#include "storage/Devices/Gpt.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Devices/LvmVgImpl.h"
+#include "storage/Filesystems/BlkFilesystem.h"
+#include "storage/Filesystems/MountPoint.h"
+#include "storage/DevicegraphImpl.h"
+#include "storage/DeviceQuery.h"
+#include "storage/Environment.h"
+#include "storage/Storage.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+class Fixture
+{
+public:
+
+    Fixture()
+	: environment(true, ProbeMode::NONE, TargetMode::DIRECT), storage(environment)
+    {
+	staging = storage.get_staging();
+
+	// disks sda to sdj with sizes of 1 GiB to 10 GiB
+
+	for (int i = 0; i < 10; ++i)
+	{
+	    string name = "/dev/sd" + string(1, 'a' + i);
+	    Disk* disk = Disk::create(staging, name, Region(0, (i + 1) * GiB / 512, 512));
+	    disk->get_impl().set_udev_ids({ "disk-" + to_string(i) });
+	    disks.push_back(disk);
+	}
+
+	Gpt* gpt = to_gpt(disks[9]->create_partition_table(PtType::GPT));
+	sdj1 = gpt->create_partition("/dev/sdj1", Region(2048, 2 * GiB / 512, 512), PartitionType::PRIMARY);
+
+	ext4 = sdj1->create_blk_filesystem(FsType::EXT4);
+	ext4->set_uuid("f6fc8ab7-9dbd-4f5e-86a1-7e8f3f48d1c5");
+
+	MountPoint* mount_point = ext4->create_mount_point("/test");
+	mount_point->set_in_etc_fstab(false);
+	ext4->create_mount_point("/other");
+
+	lvm_vg = LvmVg::create(staging, "system");
+	lvm_vg->get_impl().set_uuid("OMDOsx-2gKY-YNte-fAJu-Zm0z-ZMVi-WBQfCQ");
+    }
+
+    Environment environment;
+    Storage storage;
+
+    Devicegraph* staging;
+
+    vector<Disk*> disks;
+    Partition* sdj1;
+    BlkFilesystem* ext4;
+    LvmVg* lvm_vg;
+
+};
+
+
+BOOST_FIXTURE_TEST_CASE(size_range, Fixture)
+{
+    const Devicegraph* devicegraph = staging;
+
+    vector<const Device*> result = devicegraph->query(DeviceQuery().set_min_size(2 * GiB).set_max_size(4 * GiB));
+
+    BOOST_CHECK_EQUAL(result.size(), 4);
+    BOOST_CHECK(find(result.begin(), result.end(), disks[1]) != result.end());
+    BOOST_CHECK(find(result.begin(), result.end(), disks[3]) != result.end());
+    BOOST_CHECK(find(result.begin(), result.end(), sdj1) != result.end());
+
+    // combined with further criteria
+
+    result = devicegraph->query(DeviceQuery().set_type("Disk").set_min_size(2 * GiB).set_max_size(4 * GiB));
+    BOOST_CHECK_EQUAL(result.size(), 3);
+
+    result = devicegraph->query(DeviceQuery().set_min_size(9 * GiB).set_has_children(false));
+    BOOST_CHECK_EQUAL(result.size(), 1);
+    BOOST_CHECK_EQUAL(result.front(), disks[8]);
+
+    // the index follows changes of the size
+
+    disks[0]->set_size(20 * GiB);
+
+    result = devicegraph->query(DeviceQuery().set_min_size(15 * GiB));
+    BOOST_CHECK_EQUAL(result.size(), 1);
+    BOOST_CHECK_EQUAL(result.front(), disks[0]);
+}
+
+
+BOOST_FIXTURE_TEST_CASE(names_and_uuids, Fixture)
+{
+    const Devicegraph* devicegraph = staging;
+
+    vector<const Device*> result = devicegraph->query(DeviceQuery().set_name_prefix("/dev/sdj"));
+    BOOST_CHECK_EQUAL(result.size(), 2);
+
+    result = devicegraph->query(DeviceQuery().set_name_prefix("/dev/sd").set_type("Partition"));
+    BOOST_CHECK_EQUAL(result.size(), 1);
+    BOOST_CHECK_EQUAL(result.front(), sdj1);
+
+    result = devicegraph->query(DeviceQuery().set_uuid("OMDOsx-2gKY-YNte-fAJu-Zm0z-ZMVi-WBQfCQ"));
+    BOOST_CHECK_EQUAL(result.size(), 1);
+    BOOST_CHECK_EQUAL(result.front(), lvm_vg);
+
+    result = devicegraph->query(DeviceQuery().set_udev_id("disk-3"));
+    BOOST_CHECK_EQUAL(result.size(), 1);
+    BOOST_CHECK_EQUAL(result.front(), disks[3]);
+}
+
+
+BOOST_FIXTURE_TEST_CASE(other_criteria, Fixture)
+{
+    const Devicegraph* devicegraph = staging;
+
+    vector<const Device*> result = devicegraph->query(DeviceQuery().set_in_etc_fstab(true));
+    BOOST_CHECK_EQUAL(result.size(), 1);
+    BOOST_CHECK_EQUAL(result.front()->get_displayname(), "/other");
+
+    result = devicegraph->query(DeviceQuery().set_type("BlkDevice").set_has_children(true));
+    BOOST_CHECK_EQUAL(result.size(), 2);
+
+    result = devicegraph->query(DeviceQuery().set_type("Filesystem"));
+    BOOST_CHECK_EQUAL(result.size(), 1);
+
+    result = devicegraph->query(DeviceQuery().add_predicate([](const Device* device) {
+	return is_disk(device) && to_disk(device)->get_size() == 5 * GiB;
+    }));
+    BOOST_CHECK_EQUAL(result.size(), 1);
+    BOOST_CHECK_EQUAL(result.front(), disks[4]);
+
+    BOOST_CHECK_EQUAL(devicegraph->query(DeviceQuery()).size(), devicegraph->num_devices());
+
+    BOOST_CHECK_THROW(DeviceQuery().set_type("Unknown"), Exception);
+}
+
+
+BOOST_AUTO_TEST_CASE(all_device_types)
+{
+    // every device class that can be loaded must also be known to
+    // DeviceQuery::set_type()
+
+    for (const map<string, device_load_fnc>::value_type& value : device_load_registry)
+	BOOST_CHECK_NO_THROW(DeviceQuery().set_type(value.first));
+}
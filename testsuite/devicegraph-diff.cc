@@ -0,0 +1,87 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+#include <boost/algorithm/string.hpp>
+
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/Gpt.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Holders/User.h"
+#include "storage/Holders/Subdevice.h"
+#include "storage/Environment.h"
+#include "storage/Storage.h"
+#include "storage/DevicegraphDiffImpl.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(devicegraph_diff)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* lhs = storage.get_staging();
+
+    Disk* sda = Disk::create(lhs, "/dev/sda");
+
+    Gpt* gpt = Gpt::create(lhs);
+    User::create(lhs, sda, gpt);
+
+    Partition* sda1 = Partition::create(lhs, "/dev/sda1", Region(2048, 10240, 512), PartitionType::PRIMARY);
+    Subdevice::create(lhs, gpt, sda1);
+
+    Partition* sda2 = Partition::create(lhs, "/dev/sda2", Region(12288, 10240, 512), PartitionType::PRIMARY);
+    Subdevice::create(lhs, gpt, sda2);
+
+    Devicegraph* rhs = storage.copy_devicegraph("staging", "rhs");
+
+    BOOST_CHECK(DevicegraphDiff(lhs, rhs).empty());
+
+    // delete sda2, create sda3 and resize sda1 in rhs
+
+    Gpt* rhs_gpt = to_gpt(rhs->find_device(gpt->get_sid()));
+
+    rhs_gpt->delete_partition(to_partition(rhs->find_device(sda2->get_sid())));
+    Partition* sda3 = rhs_gpt->create_partition("/dev/sda3", Region(22528, 10240, 512), PartitionType::PRIMARY);
+
+    to_partition(rhs->find_device(sda1->get_sid()))->set_region(Region(2048, 8192, 512));
+
+    DevicegraphDiff devicegraph_diff(lhs, rhs);
+
+    BOOST_CHECK(!devicegraph_diff.empty());
+
+    BOOST_CHECK(devicegraph_diff.get_created_devices() == vector<sid_t>({ sda3->get_sid() }));
+    BOOST_CHECK(devicegraph_diff.get_deleted_devices() == vector<sid_t>({ sda2->get_sid() }));
+    BOOST_CHECK(devicegraph_diff.get_modified_devices() == vector<sid_t>({ sda1->get_sid() }));
+
+    BOOST_CHECK(devicegraph_diff.get_created_holders() ==
+		(vector<pair<sid_t, sid_t>>({ { gpt->get_sid(), sda3->get_sid() } })));
+    BOOST_CHECK(devicegraph_diff.get_deleted_holders() ==
+		(vector<pair<sid_t, sid_t>>({ { gpt->get_sid(), sda2->get_sid() } })));
+    BOOST_CHECK(devicegraph_diff.get_modified_holders().empty());
+
+    BOOST_CHECK(devicegraph_diff.get_changed_attributes(sda1->get_sid()) == vector<string>({ "region" }));
+    BOOST_CHECK(devicegraph_diff.get_changed_attributes(sda->get_sid()).empty());
+    BOOST_CHECK(devicegraph_diff.get_changed_attributes(gpt->get_sid(), sda1->get_sid()).empty());
+
+    BOOST_CHECK_THROW(devicegraph_diff.get_changed_attributes(sda2->get_sid()), DeviceNotFoundBySid);
+    BOOST_CHECK_THROW(devicegraph_diff.get_changed_attributes(gpt->get_sid(), sda2->get_sid()),
+		      HolderNotFoundBySids);
+
+    const DevicegraphDiff::Impl& impl = devicegraph_diff.get_impl();
+
+    BOOST_CHECK_EQUAL(impl.get_common_devices().size(), 3);
+    BOOST_CHECK_EQUAL(impl.get_common_holders().size(), 2);
+
+    ostringstream log;
+    impl.log(log);
+
+    BOOST_CHECK(boost::contains(log.str(), "device only in lhs"));
+    BOOST_CHECK(boost::contains(log.str(), "device only in rhs"));
+    BOOST_CHECK(boost::contains(log.str(), "device differ"));
+    BOOST_CHECK(boost::contains(log.str(), "region:"));
+}
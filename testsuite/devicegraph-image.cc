@@ -0,0 +1,127 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include <unistd.h>
+#include <fstream>
+#include <sstream>
+#include <limits>
+
+#include "storage/Devices/BlkDevice.h"
+#include "storage/Devices/LvmLv.h"
+#include "storage/Devicegraph.h"
+#include "storage/DevicegraphImage.h"
+#include "storage/Environment.h"
+#include "storage/Storage.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+vector<sid_t>
+sids(const vector<const Device*>& devices)
+{
+    vector<sid_t> ret;
+    for (const Device* device : devices)
+	ret.push_back(device->get_sid());
+    sort(ret.begin(), ret.end());
+    return ret;
+}
+
+
+vector<sid_t>
+sids(const vector<const DevicegraphImage::Vertex*>& vertices)
+{
+    vector<sid_t> ret;
+    for (const DevicegraphImage::Vertex* vertex : vertices)
+	ret.push_back(vertex->sid);
+    sort(ret.begin(), ret.end());
+    return ret;
+}
+
+
+BOOST_AUTO_TEST_CASE(queries)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* tmp = storage.create_devicegraph("tmp");
+    tmp->load("probe/lvm1-devicegraph.xml");
+
+    const Devicegraph* devicegraph = tmp;
+
+    DevicegraphImage::write(devicegraph, "devicegraph-image.img");
+
+    DevicegraphImage image("devicegraph-image.img");
+
+    BOOST_CHECK_EQUAL(image.num_vertices(), devicegraph->num_devices());
+    BOOST_CHECK_EQUAL(image.num_edges(), devicegraph->num_holders());
+
+    for (const Device* device : Device::get_all(devicegraph))
+    {
+	const DevicegraphImage::Vertex& vertex = image.find_by_sid(device->get_sid());
+
+	BOOST_CHECK_EQUAL(image.get_string(vertex.displayname), device->get_displayname());
+
+	if (is_blk_device(device))
+	{
+	    const BlkDevice* blk_device = to_blk_device(device);
+
+	    BOOST_CHECK(vertex.flags & DevicegraphImage::BLK_DEVICE);
+	    BOOST_CHECK_EQUAL(image.get_string(vertex.name), blk_device->get_name());
+	    BOOST_CHECK_EQUAL(vertex.size, blk_device->get_size());
+	    BOOST_CHECK_EQUAL(&image.find_by_name(blk_device->get_name()), &vertex);
+	}
+
+	BOOST_CHECK(sids(image.get_children(vertex)) == sids(device->get_children()));
+	BOOST_CHECK(sids(image.get_parents(vertex)) == sids(device->get_parents()));
+    }
+
+    const vector<const DevicegraphImage::Vertex*> lvm_lvs = image.get_vertices_of_class("LvmLv");
+    BOOST_CHECK_EQUAL(lvm_lvs.size(), LvmLv::get_all(devicegraph).size());
+
+    const vector<const DevicegraphImage::Vertex*> blk_devices =
+	image.get_vertices_with_flags(DevicegraphImage::BLK_DEVICE);
+    BOOST_CHECK_EQUAL(blk_devices.size(), BlkDevice::get_all(devicegraph).size());
+
+    BOOST_CHECK_EQUAL(image.get_string(image.find_by_name("/dev/system/root").classname), string("LvmLv"));
+
+    BOOST_CHECK_THROW(image.find_by_sid(1000000), DeviceNotFoundBySid);
+    BOOST_CHECK_THROW(image.find_by_name("/dev/sdz"), DeviceNotFoundByName);
+
+    BOOST_CHECK_THROW(image.get_string(1000000), Exception);
+    BOOST_CHECK_THROW(image.get_string(numeric_limits<uint32_t>::max()), Exception);
+
+    unlink("devicegraph-image.img");
+}
+
+
+BOOST_AUTO_TEST_CASE(invalid)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.create_devicegraph("tmp");
+    devicegraph->load("probe/lvm1-devicegraph.xml");
+
+    DevicegraphImage::write(devicegraph, "devicegraph-image.img");
+
+    ifstream file("devicegraph-image.img", ios::binary);
+    ostringstream tmp;
+    tmp << file.rdbuf();
+    const string data = tmp.str();
+
+    ofstream("devicegraph-image.img", ios::binary | ios::trunc) << data.substr(0, data.size() - 8);
+    BOOST_CHECK_THROW(DevicegraphImage("devicegraph-image.img"), Exception);
+
+    ofstream("devicegraph-image.img", ios::binary | ios::trunc) << "garbage";
+    BOOST_CHECK_THROW(DevicegraphImage("devicegraph-image.img"), Exception);
+
+    unlink("devicegraph-image.img");
+
+    BOOST_CHECK_THROW(DevicegraphImage("devicegraph-image.img"), Exception);
+}
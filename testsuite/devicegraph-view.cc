@@ -0,0 +1,196 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include <unistd.h>
+#include <fstream>
+#include <sstream>
+
+#include "storage/Utils/HumanString.h"
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/Gpt.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Filesystems/BlkFilesystem.h"
+#include "storage/Filesystems/MountPoint.h"
+#include "storage/Holders/Holder.h"
+#include "storage/Devicegraph.h"
+#include "storage/DevicegraphView.h"
+#include "storage/Environment.h"
+#include "storage/Storage.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+class Fixture
+{
+public:
+
+    Fixture()
+	: environment(true, ProbeMode::NONE, TargetMode::DIRECT), storage(environment)
+    {
+	staging = storage.get_staging();
+
+	sda = Disk::create(staging, "/dev/sda", Region(0, 10 * GiB / 512, 512));
+
+	Gpt* gpt = to_gpt(sda->create_partition_table(PtType::GPT));
+	sda1 = gpt->create_partition("/dev/sda1", Region(2048, 2 * GiB / 512, 512), PartitionType::PRIMARY);
+	sda2 = gpt->create_partition("/dev/sda2", Region(2048 + 2 * GiB / 512, 2 * GiB / 512, 512),
+				     PartitionType::PRIMARY);
+
+	BlkFilesystem* ext4 = sda1->create_blk_filesystem(FsType::EXT4);
+	ext4->create_mount_point("/test");
+
+	sdb = Disk::create(staging, "/dev/sdb", Region(0, 10 * GiB / 512, 512));
+	sdb->create_blk_filesystem(FsType::XFS);
+    }
+
+    Environment environment;
+    Storage storage;
+
+    Devicegraph* staging;
+
+    Disk* sda;
+    Partition* sda1;
+    Partition* sda2;
+    Disk* sdb;
+
+};
+
+
+string
+read_file(const string& filename)
+{
+    ifstream file(filename);
+    ostringstream tmp;
+    tmp << file.rdbuf();
+    return tmp.str();
+}
+
+
+BOOST_FIXTURE_TEST_CASE(subtree, Fixture)
+{
+    const DevicegraphView view(staging, { sda->get_sid() });
+
+    BOOST_CHECK_EQUAL(view.num_devices(), 6);
+    BOOST_CHECK_EQUAL(view.num_holders(), 5);
+
+    BOOST_CHECK(view.device_exists(sda1->get_sid()));
+    BOOST_CHECK(!view.device_exists(sdb->get_sid()));
+
+    BOOST_CHECK_EQUAL(view.find_device(sda2->get_sid()), sda2);
+    BOOST_CHECK_THROW(view.find_device(sdb->get_sid()), DeviceNotFoundBySid);
+
+    vector<const Device*> devices = view.get_all_devices();
+    BOOST_CHECK_EQUAL(devices.size(), 6);
+    BOOST_CHECK(is_sorted(devices.begin(), devices.end(), Device::compare_by_sid));
+
+    BOOST_CHECK_EQUAL(view.get_all_holders().size(), 5);
+
+    const Device* gpt = sda->get_partition_table();
+
+    vector<const Device*> children = view.get_children(gpt);
+    BOOST_CHECK_EQUAL(children.size(), 2);
+    BOOST_CHECK_EQUAL(children[0], sda1);
+    BOOST_CHECK_EQUAL(children[1], sda2);
+
+    BOOST_CHECK_EQUAL(view.get_parents(gpt).size(), 1);
+    BOOST_CHECK_EQUAL(view.get_descendants(sda, false).size(), 5);
+    BOOST_CHECK_EQUAL(view.get_descendants(gpt, true).size(), 5);
+
+    BOOST_CHECK_THROW(view.get_children(sdb), DeviceNotFoundBySid);
+}
+
+
+BOOST_FIXTURE_TEST_CASE(filters, Fixture)
+{
+    const DevicegraphView view1(staging, { sda->get_sid(), sdb->get_sid() },
+				[](const Device* device) { return !is_mount_point(device); }, nullptr);
+
+    BOOST_CHECK_EQUAL(view1.num_devices(), 7);
+    BOOST_CHECK_EQUAL(view1.num_holders(), 5);
+
+    // the holder from the partition table to sda2 is filtered so sda2 is
+    // not reached
+
+    const sid_t sda2_sid = sda2->get_sid();
+
+    const DevicegraphView view2(staging, { sda->get_sid() }, nullptr,
+				[sda2_sid](const Holder* holder) { return holder->get_target_sid() != sda2_sid; });
+
+    BOOST_CHECK_EQUAL(view2.num_devices(), 5);
+    BOOST_CHECK(!view2.device_exists(sda2_sid));
+    BOOST_CHECK_EQUAL(view2.get_children(sda->get_partition_table()).size(), 1);
+
+    // a root not accepted by the device filter is not part of the view
+
+    const DevicegraphView view3(staging, { sda->get_sid() },
+				[](const Device* device) { return !is_disk(device); }, nullptr);
+
+    BOOST_CHECK(view3.empty());
+}
+
+
+BOOST_FIXTURE_TEST_CASE(save_and_write_graphviz, Fixture)
+{
+    const DevicegraphView view(staging, { sda->get_sid() });
+
+    for (const char* filename : { "devicegraph-view.xml", "devicegraph-view.bin" })
+    {
+	view.save(filename);
+
+	Devicegraph* loaded = storage.create_devicegraph("loaded");
+	loaded->load(filename);
+
+	BOOST_CHECK_EQUAL(loaded->num_devices(), 6);
+	BOOST_CHECK_EQUAL(loaded->num_holders(), 5);
+	BOOST_CHECK(loaded->device_exists(sda2->get_sid()));
+	BOOST_CHECK(!loaded->device_exists(sdb->get_sid()));
+
+	storage.remove_devicegraph("loaded");
+
+	unlink(filename);
+    }
+
+    view.write_graphviz("devicegraph-view.gv");
+
+    string graphviz = read_file("devicegraph-view.gv");
+    BOOST_CHECK(graphviz.find("/dev/sda1") != string::npos);
+    BOOST_CHECK(graphviz.find("/dev/sdb") == string::npos);
+
+    unlink("devicegraph-view.gv");
+}
+
+
+BOOST_FIXTURE_TEST_CASE(changed_devicegraph, Fixture)
+{
+    const DevicegraphView view(staging, { sda->get_sid() });
+
+    Disk::create(staging, "/dev/sdc");
+
+    BOOST_CHECK_THROW(view.find_device(sda->get_sid()), Exception);
+    BOOST_CHECK_THROW(view.device_exists(sda->get_sid()), Exception);
+    BOOST_CHECK_THROW(view.empty(), Exception);
+    BOOST_CHECK_THROW(view.num_devices(), Exception);
+    BOOST_CHECK_THROW(view.num_holders(), Exception);
+    BOOST_CHECK_THROW(view.get_all_devices(), Exception);
+    BOOST_CHECK_THROW(view.get_all_holders(), Exception);
+    BOOST_CHECK_THROW(view.get_children(sda), Exception);
+    BOOST_CHECK_THROW(view.get_descendants(sda, true), Exception);
+    BOOST_CHECK_THROW(view.save("devicegraph-view.xml"), Exception);
+    BOOST_CHECK_THROW(view.write_graphviz("devicegraph-view.gv"), Exception);
+}
+
+
+BOOST_FIXTURE_TEST_CASE(stale_view_after_removal, Fixture)
+{
+    const DevicegraphView view(staging, { sda->get_sid() });
+
+    staging->remove_device(sda->get_partition_table()->get_partitions()[0]);
+
+    BOOST_CHECK_THROW(view.get_all_devices(), Exception);
+    BOOST_CHECK_THROW(view.get_all_holders(), Exception);
+    BOOST_CHECK_THROW(view.num_holders(), Exception);
+}
@@ -0,0 +1,157 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/Gpt.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Filesystems/Ext4.h"
+#include "storage/Holders/User.h"
+#include "storage/Holders/Subdevice.h"
+#include "storage/Environment.h"
+#include "storage/Storage.h"
+#include "storage/DevicegraphImpl.h"
+
+
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(equal)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* lhs = storage.get_staging();
+
+    Disk* sda = Disk::create(lhs, "/dev/sda");
+
+    Gpt* gpt = Gpt::create(lhs);
+    User::create(lhs, sda, gpt);
+
+    Partition* sda1 = Partition::create(lhs, "/dev/sda1", Region(2048, 10240, 512), PartitionType::PRIMARY);
+    Subdevice::create(lhs, gpt, sda1);
+
+    Devicegraph* rhs = storage.copy_devicegraph("staging", "rhs");
+
+    BOOST_CHECK(*lhs == *rhs);
+    BOOST_CHECK_EQUAL(lhs->get_impl().get_topology_hash(), rhs->get_impl().get_topology_hash());
+
+    // changed attribute: same topology but not equal
+
+    to_partition(rhs->find_device(sda1->get_sid()))->set_region(Region(2048, 20480, 512));
+
+    BOOST_CHECK(*lhs != *rhs);
+    BOOST_CHECK_EQUAL(lhs->get_impl().get_topology_hash(), rhs->get_impl().get_topology_hash());
+
+    to_partition(rhs->find_device(sda1->get_sid()))->set_region(Region(2048, 10240, 512));
+
+    BOOST_CHECK(*lhs == *rhs);
+
+    // additional device
+
+    Ext4* ext4 = to_ext4(sda1->create_blk_filesystem(FsType::EXT4));
+
+    BOOST_CHECK(*lhs != *rhs);
+    BOOST_CHECK(lhs->get_impl().get_topology_hash() != rhs->get_impl().get_topology_hash());
+
+    lhs->remove_device(ext4);
+
+    BOOST_CHECK(*lhs == *rhs);
+    BOOST_CHECK_EQUAL(lhs->get_impl().get_topology_hash(), rhs->get_impl().get_topology_hash());
+
+    lhs->check();
+    rhs->check();
+}
+
+
+BOOST_AUTO_TEST_CASE(generation)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    unsigned long long generation = devicegraph->get_impl().get_generation();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda");
+    BOOST_CHECK(devicegraph->get_impl().get_generation() > generation);
+
+    generation = devicegraph->get_impl().get_generation();
+
+    sda->set_size(1000 * 512);
+    BOOST_CHECK_EQUAL(devicegraph->get_impl().get_generation(), generation);
+
+    devicegraph->remove_device(sda);
+    BOOST_CHECK(devicegraph->get_impl().get_generation() > generation);
+}
+
+
+BOOST_AUTO_TEST_CASE(modification_counter)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    unsigned long long counter = devicegraph->get_modification_counter();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda");
+    BOOST_CHECK(devicegraph->get_modification_counter() > counter);
+
+    counter = devicegraph->get_modification_counter();
+
+    const Disk* tmp = sda;
+    tmp->get_size();
+    BOOST_CHECK_EQUAL(devicegraph->get_modification_counter(), counter);
+
+    sda->set_size(1000 * 512);
+    BOOST_CHECK(devicegraph->get_modification_counter() > counter);
+}
+
+
+BOOST_AUTO_TEST_CASE(repeated_compare)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* lhs = storage.get_staging();
+
+    Disk* sda = Disk::create(lhs, "/dev/sda");
+    Disk::create(lhs, "/dev/sdb");
+
+    Devicegraph* rhs = storage.copy_devicegraph("staging", "rhs");
+    Devicegraph* other = storage.copy_devicegraph("staging", "other");
+
+    BOOST_CHECK(*lhs == *rhs);
+    BOOST_CHECK(*lhs == *rhs);
+
+    // attribute changes after the last compare are detected on both sides
+
+    sda->set_size(1000 * 512);
+
+    BOOST_CHECK(*lhs != *rhs);
+    BOOST_CHECK(*lhs != *rhs);
+
+    to_disk(rhs->find_device(sda->get_sid()))->set_size(1000 * 512);
+
+    BOOST_CHECK(*lhs == *rhs);
+
+    // a compare with another devicegraph in between
+
+    BOOST_CHECK(*lhs != *other);
+
+    to_disk(rhs->find_device(sda->get_sid()))->set_size(2000 * 512);
+
+    BOOST_CHECK(*other != *lhs);
+    BOOST_CHECK(*lhs != *rhs);
+    BOOST_CHECK(*rhs != *lhs);
+
+    sda->set_size(2000 * 512);
+
+    BOOST_CHECK(*rhs == *lhs);
+}
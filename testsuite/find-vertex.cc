@@ -4,12 +4,15 @@
 
 #include <boost/test/unit_test.hpp>
 
-#include "storage/Devices/Disk.h"
-#include "storage/Devices/Partition.h"
+#include "storage/Devices/DiskImpl.h"
+#include "storage/Devices/PartitionImpl.h"
+#include "storage/Devices/PartitionTableImpl.h"
 #include "storage/Holders/Subdevice.h"
 #include "storage/Environment.h"
 #include "storage/Storage.h"
 #include "storage/Devicegraph.h"
+#include "storage/ActiongraphImpl.h"
+#include "storage/Action.h"
 
 
 using namespace storage;
@@ -39,3 +42,202 @@ BOOST_AUTO_TEST_CASE(find_vertex)
     BOOST_CHECK(!sda->exists_in_probed());
     BOOST_CHECK(sda->exists_in_staging());
 }
+
+
+BOOST_AUTO_TEST_CASE(find_vertex_after_modifications)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda");
+
+    Partition* sda1 = Partition::create(devicegraph, "/dev/sda1", Region(0, 10, 262144), PartitionType::PRIMARY);
+    Subdevice::create(devicegraph, sda, sda1);
+
+    Partition* sda2 = Partition::create(devicegraph, "/dev/sda2", Region(10, 10, 262144), PartitionType::PRIMARY);
+    Subdevice::create(devicegraph, sda, sda2);
+
+    BOOST_CHECK_EQUAL(devicegraph->find_device(sda1->get_sid()), sda1);
+    BOOST_CHECK_EQUAL(devicegraph->find_holder(sda->get_sid(), sda2->get_sid())->get_target(), sda2);
+    BOOST_CHECK_THROW(devicegraph->find_holder(sda1->get_sid(), sda2->get_sid()), HolderNotFound);
+
+    sid_t sda2_sid = sda2->get_sid();
+    devicegraph->remove_device(sda2);
+
+    BOOST_CHECK(!devicegraph->device_exists(sda2_sid));
+    BOOST_CHECK_THROW(devicegraph->find_device(sda2_sid), DeviceNotFound);
+    BOOST_CHECK_THROW(devicegraph->find_holder(sda->get_sid(), sda2_sid), HolderNotFound);
+
+    Devicegraph* copy = storage.copy_devicegraph("staging", "copy");
+
+    BOOST_CHECK(copy->device_exists(sda1->get_sid()));
+    BOOST_CHECK(copy->find_device(sda1->get_sid()) != sda1);
+    BOOST_CHECK(copy->find_holder(sda->get_sid(), sda1->get_sid()));
+
+    copy->clear();
+
+    BOOST_CHECK(!copy->device_exists(sda1->get_sid()));
+    BOOST_CHECK(devicegraph->device_exists(sda1->get_sid()));
+}
+
+
+BOOST_AUTO_TEST_CASE(find_by_name_after_rename)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda");
+
+    sda->set_name("/dev/sdb");
+
+    BOOST_CHECK_EQUAL(BlkDevice::find_by_name(devicegraph, "/dev/sdb"), sda);
+    BOOST_CHECK_THROW(BlkDevice::find_by_name(devicegraph, "/dev/sda"), DeviceNotFound);
+
+    Devicegraph* copy = storage.copy_devicegraph("staging", "copy");
+
+    BOOST_CHECK(BlkDevice::find_by_name(copy, "/dev/sdb") != sda);
+
+    devicegraph->remove_device(sda);
+
+    BOOST_CHECK_THROW(BlkDevice::find_by_name(devicegraph, "/dev/sdb"), DeviceNotFound);
+    BOOST_CHECK(BlkDevice::find_by_name(copy, "/dev/sdb"));
+}
+
+
+BOOST_AUTO_TEST_CASE(dense_vertex_index)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda");
+    Disk* sdb = Disk::create(devicegraph, "/dev/sdb");
+
+    PartitionTable* gpt = sdb->create_partition_table(PtType::GPT);
+    Partition* sdb1 = gpt->create_partition("/dev/sdb1", Region(2048, 1024, 512), PartitionType::PRIMARY);
+
+    devicegraph->remove_device(sda);
+
+    devicegraph->check();
+
+    const Devicegraph::Impl& impl = devicegraph->get_impl();
+
+    // sdb1 was moved into the gap left by sda
+
+    BOOST_CHECK_EQUAL(impl.get_vertex_index(sdb1->get_impl().get_vertex()), 0);
+    BOOST_CHECK_EQUAL(impl.get_vertex_index(sdb->get_impl().get_vertex()), 1);
+    BOOST_CHECK_EQUAL(impl.get_vertex_index(gpt->get_impl().get_vertex()), 2);
+
+    BOOST_CHECK_EQUAL(impl.descendants(sdb->get_impl().get_vertex(), false).size(), 2);
+    BOOST_CHECK_EQUAL(impl.ancestors(sdb1->get_impl().get_vertex(), false).size(), 2);
+}
+
+
+BOOST_AUTO_TEST_CASE(local_index)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* lhs = storage.create_devicegraph("lhs");
+
+    Disk* sda = Disk::create(lhs, "/dev/sda", Region(0, 1000000, 512));
+    PartitionTable* gpt = sda->create_partition_table(PtType::GPT);
+    Partition* sda1 = gpt->create_partition("/dev/sda1", Region(2048, 1024, 512), PartitionType::PRIMARY);
+
+    Devicegraph* rhs = storage.copy_devicegraph("lhs", "rhs");
+
+    rhs->remove_device(sda1->get_sid());
+
+    const Devicegraph::Impl& lhs_impl = lhs->get_impl();
+    const Devicegraph::Impl& rhs_impl = rhs->get_impl();
+
+    BOOST_CHECK_EQUAL(lhs_impl.get_local_index(sda->get_sid()), 0);
+    BOOST_CHECK_EQUAL(lhs_impl.get_local_index(gpt->get_sid()), 1);
+    BOOST_CHECK_EQUAL(lhs_impl.get_local_index(sda1->get_sid()), 2);
+    BOOST_CHECK_EQUAL(sda1->get_impl().get_local_index(), 2);
+
+    BOOST_CHECK_EQUAL(rhs_impl.get_local_index(sda1->get_sid()), Devicegraph::Impl::npos);
+
+    // devices only in lhs follow the devices in rhs
+
+    Actiongraph actiongraph(storage, lhs, rhs);
+
+    const Actiongraph::Impl& actiongraph_impl = actiongraph.get_impl();
+
+    BOOST_CHECK_EQUAL(actiongraph_impl.get_sid_index(sda->get_sid()), 0);
+    BOOST_CHECK_EQUAL(actiongraph_impl.get_sid_index(gpt->get_sid()), 1);
+    BOOST_CHECK_EQUAL(actiongraph_impl.get_sid_index(sda1->get_sid()), 2 + 2);
+    BOOST_CHECK_EQUAL(actiongraph_impl.get_sid_index(12345678), Devicegraph::Impl::npos);
+
+    BOOST_CHECK_EQUAL(actiongraph_impl.actions_with_sid(sda1->get_sid()).size(), 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(resolved_devices_of_actions)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* lhs = storage.create_devicegraph("lhs");
+
+    Disk* sda = Disk::create(lhs, "/dev/sda", Region(0, 1000000, 512));
+    PartitionTable* gpt = sda->create_partition_table(PtType::GPT);
+    Partition* sda1 = gpt->create_partition("/dev/sda1", Region(2048, 1024, 512), PartitionType::PRIMARY);
+
+    Devicegraph* rhs = storage.copy_devicegraph("lhs", "rhs");
+
+    rhs->remove_device(sda1->get_sid());
+    Partition* sda2 = to_partition_table(rhs->find_device(gpt->get_sid()))->
+	create_partition("/dev/sda2", Region(4096, 1024, 512), PartitionType::PRIMARY);
+
+    Actiongraph actiongraph(storage, lhs, rhs);
+
+    const Actiongraph::Impl& actiongraph_impl = actiongraph.get_impl();
+
+    for (Actiongraph::Impl::vertex_descriptor vertex : actiongraph_impl.vertices())
+    {
+	const Action::Base* action = actiongraph_impl[vertex];
+
+	if (action->sid == sda2->get_sid() && is_create(action))
+	{
+	    BOOST_CHECK_EQUAL(action->find_rhs_device(actiongraph_impl), sda2);
+	    BOOST_CHECK(!action->find_device(actiongraph_impl, LHS));
+	    BOOST_CHECK_EQUAL(dynamic_cast<const Action::Create*>(action)->get_device(actiongraph_impl), sda2);
+	}
+	else if (action->sid == sda1->get_sid() && is_delete(action))
+	{
+	    BOOST_CHECK_EQUAL(action->find_device(actiongraph_impl, LHS), sda1);
+	    BOOST_CHECK(!action->find_rhs_device(actiongraph_impl));
+	    BOOST_CHECK_EQUAL(dynamic_cast<const Action::Delete*>(action)->get_device(actiongraph_impl), sda1);
+	}
+    }
+
+    // removing a device from the RHS while the actiongraph is still used
+    // must not leave the action with the destroyed device
+
+    const sid_t sda2_sid = sda2->get_sid();
+
+    rhs->remove_device(sda2_sid);
+
+    for (Actiongraph::Impl::vertex_descriptor vertex : actiongraph_impl.vertices())
+    {
+	const Action::Base* action = actiongraph_impl[vertex];
+
+	if (action->sid == sda2_sid && is_create(action))
+	{
+	    BOOST_CHECK(!action->find_rhs_device(actiongraph_impl));
+	    BOOST_CHECK_THROW(dynamic_cast<const Action::Create*>(action)->get_device(actiongraph_impl),
+			      DeviceNotFound);
+	}
+    }
+}
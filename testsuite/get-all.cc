@@ -0,0 +1,70 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Utils/HumanString.h"
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/Gpt.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Devices/LvmVg.h"
+#include "storage/Devices/LvmLv.h"
+#include "storage/Filesystems/Ext4.h"
+#include "storage/Filesystems/Swap.h"
+#include "storage/Holders/User.h"
+#include "storage/Environment.h"
+#include "storage/Storage.h"
+#include "storage/Devicegraph.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(get_all)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda", 16 * GiB);
+    Gpt* gpt = to_gpt(sda->create_partition_table(PtType::GPT));
+    Partition* sda1 = gpt->create_partition("/dev/sda1", Region(2048, 1024000, 512), PartitionType::PRIMARY);
+
+    Disk* sdb = Disk::create(devicegraph, "/dev/sdb", 16 * GiB);
+
+    LvmVg* system = LvmVg::create(devicegraph, "system");
+    User::create(devicegraph, sda1, system);
+    LvmLv* root = system->create_lvm_lv("root", LvType::NORMAL, 4 * GiB);
+
+    Ext4* ext4 = to_ext4(root->create_blk_filesystem(FsType::EXT4));
+    Swap* swap = to_swap(sdb->create_blk_filesystem(FsType::SWAP));
+
+    // concrete classes
+
+    BOOST_CHECK(Disk::get_all(devicegraph) == vector<Disk*>({ sda, sdb }));
+    BOOST_CHECK(LvmLv::get_all(devicegraph) == vector<LvmLv*>({ root }));
+
+    // abstract classes keep the insertion order
+
+    BOOST_CHECK(BlkDevice::get_all(devicegraph) == vector<BlkDevice*>({ sda, sda1, sdb, root }));
+    BOOST_CHECK(Partitionable::get_all(devicegraph) == vector<Partitionable*>({ sda, sdb }));
+    BOOST_CHECK(BlkFilesystem::get_all(devicegraph) == vector<BlkFilesystem*>({ ext4, swap }));
+    BOOST_CHECK_EQUAL(Device::get_all(devicegraph).size(), devicegraph->num_devices());
+
+    // removal and copy
+
+    devicegraph->remove_device(sda1);
+    devicegraph->remove_device(ext4);
+
+    BOOST_CHECK(BlkDevice::get_all(devicegraph) == vector<BlkDevice*>({ sda, sdb, root }));
+    BOOST_CHECK(BlkFilesystem::get_all(devicegraph) == vector<BlkFilesystem*>({ swap }));
+
+    const Devicegraph* copy = storage.copy_devicegraph("staging", "copy");
+
+    BOOST_CHECK_EQUAL(BlkDevice::get_all(copy).size(), 3);
+    BOOST_CHECK_EQUAL(BlkDevice::get_all(copy)[1]->get_name(), "/dev/sdb");
+    BOOST_CHECK_EQUAL(Disk::get_all(copy).size(), 2);
+}
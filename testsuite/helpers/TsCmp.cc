@@ -312,7 +312,8 @@ namespace storage
     {
 	set<string> tmp1;
 	for (Actiongraph::Impl::vertex_descriptor vertex : commit_data.actiongraph.vertices())
-	    tmp1.insert(text(commit_data, vertex));
+	    if (!is_barrier(commit_data.actiongraph[vertex]))
+		tmp1.insert(text(commit_data, vertex));
 
 	set<string> tmp2;
 	for (const Entry& entry : entries)
@@ -344,15 +345,30 @@ namespace storage
 
 	map<string, Actiongraph::Impl::vertex_descriptor> text_to_vertex;
 	for (Actiongraph::Impl::vertex_descriptor vertex : commit_data.actiongraph.vertices())
-	    text_to_vertex[text(commit_data, vertex)] = vertex;
+	    if (!is_barrier(commit_data.actiongraph[vertex]))
+		text_to_vertex[text(commit_data, vertex)] = vertex;
 
 	for (const Entry& entry : entries)
 	{
 	    Actiongraph::Impl::vertex_descriptor vertex = text_to_vertex[entry.text];
 
+	    // the dependencies through barriers count as direct dependencies
+
 	    set<string> tmp;
-	    for (Actiongraph::Impl::vertex_descriptor child : commit_data.actiongraph.children(vertex))
-		tmp.insert(text_to_id[text(commit_data, child)]);
+	    vector<Actiongraph::Impl::vertex_descriptor> todo = { vertex };
+	    while (!todo.empty())
+	    {
+		Actiongraph::Impl::vertex_descriptor parent = todo.back();
+		todo.pop_back();
+
+		for (Actiongraph::Impl::vertex_descriptor child : commit_data.actiongraph.children(parent))
+		{
+		    if (is_barrier(commit_data.actiongraph[child]))
+			todo.push_back(child);
+		    else
+			tmp.insert(text_to_id[text(commit_data, child)]);
+		}
+	    }
 
 	    if (tmp != entry.dep_ids)
 	    {
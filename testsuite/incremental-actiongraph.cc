@@ -0,0 +1,218 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include <set>
+
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Devices/PartitionTable.h"
+#include "storage/Filesystems/BlkFilesystem.h"
+#include "storage/Filesystems/MountPoint.h"
+#include "storage/Environment.h"
+#include "storage/Storage.h"
+#include "storage/Devicegraph.h"
+#include "storage/ActiongraphImpl.h"
+#include "storage/Action.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+namespace
+{
+
+    multiset<string>
+    actions(const Actiongraph& actiongraph)
+    {
+	const Actiongraph::Impl& impl = actiongraph.get_impl();
+	const CommitData commit_data(impl, Tense::SIMPLE_PRESENT);
+
+	multiset<string> ret;
+
+	for (Actiongraph::Impl::vertex_descriptor vertex : impl.vertices())
+	    ret.insert(impl[vertex]->text(commit_data).native);
+
+	return ret;
+    }
+
+
+    multiset<pair<string, string>>
+    dependencies(const Actiongraph& actiongraph)
+    {
+	const Actiongraph::Impl& impl = actiongraph.get_impl();
+	const CommitData commit_data(impl, Tense::SIMPLE_PRESENT);
+
+	multiset<pair<string, string>> ret;
+
+	for (Actiongraph::Impl::vertex_descriptor vertex : impl.vertices())
+	    for (Actiongraph::Impl::vertex_descriptor child : impl.children(vertex))
+		ret.emplace(impl[vertex]->text(commit_data).native, impl[child]->text(commit_data).native);
+
+	return ret;
+    }
+
+
+    bool
+    contains_action(const Actiongraph& actiongraph, const Action::Base* action)
+    {
+	const vector<const Action::Base*> tmp = actiongraph.get_commit_actions();
+	return find(tmp.begin(), tmp.end(), action) != tmp.end();
+    }
+
+
+    void
+    create_partition_with_mount_point(Devicegraph* devicegraph, const string& disk_name,
+				      FsType fs_type, const string& path)
+    {
+	Disk* disk = Disk::find_by_name(devicegraph, disk_name);
+
+	PartitionTable* gpt = disk->has_partition_table() ? disk->get_partition_table() :
+	    disk->create_partition_table(PtType::GPT);
+
+	unsigned long long start = 2048 + gpt->get_partitions().size() * 1024 * 1024;
+
+	Partition* partition = gpt->create_partition(disk_name + to_string(gpt->get_partitions().size() + 1),
+						     Region(start, 1024 * 1024, 512), PartitionType::PRIMARY);
+
+	BlkFilesystem* blk_filesystem = partition->create_blk_filesystem(fs_type);
+	blk_filesystem->create_mount_point(path);
+    }
+
+}
+
+
+BOOST_AUTO_TEST_CASE(incremental_actiongraph)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* lhs = storage.create_devicegraph("lhs");
+
+    Disk::create(lhs, "/dev/sda", Region(0, 100000000, 512));
+    Disk::create(lhs, "/dev/sdb", Region(0, 100000000, 512));
+    Disk::create(lhs, "/dev/sdc", Region(0, 100000000, 512));
+
+    create_partition_with_mount_point(lhs, "/dev/sda", FsType::EXT4, "/data");
+    create_partition_with_mount_point(lhs, "/dev/sdb", FsType::EXT4, "/var");
+
+    Devicegraph* rhs = storage.copy_devicegraph("lhs", "rhs");
+
+    create_partition_with_mount_point(rhs, "/dev/sdc", FsType::XFS, "/srv");
+
+    Actiongraph previous(storage, lhs, rhs);
+
+    // replace the partition of sdb and add one to sda
+
+    Disk* sdb = Disk::find_by_name(rhs, "/dev/sdb");
+    sdb->get_partition_table()->delete_partition(Partition::find_by_name(rhs, "/dev/sdb1"));
+    create_partition_with_mount_point(rhs, "/dev/sdb", FsType::XFS, "/home");
+
+    create_partition_with_mount_point(rhs, "/dev/sda", FsType::BTRFS, "/opt");
+
+    Actiongraph incremental(storage, lhs, rhs, previous);
+
+    // the actions for sdc are not calculated again
+
+    for (const Action::Base* action : previous.get_commit_actions())
+	BOOST_CHECK(contains_action(incremental, action));
+
+    Actiongraph full(storage, lhs, rhs);
+
+    BOOST_CHECK_EQUAL(incremental.num_actions(), full.num_actions());
+    BOOST_CHECK(actions(incremental) == actions(full));
+    BOOST_CHECK(dependencies(incremental) == dependencies(full));
+}
+
+
+BOOST_AUTO_TEST_CASE(incremental_actiongraph_with_devices_only_in_lhs)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* lhs = storage.create_devicegraph("lhs");
+
+    Disk::create(lhs, "/dev/sdb", Region(0, 100000000, 512));
+    Disk::create(lhs, "/dev/sda", Region(0, 100000000, 512));
+
+    Partition* sda1 = Disk::find_by_name(lhs, "/dev/sda")->create_partition_table(PtType::GPT)->
+	create_partition("/dev/sda1", Region(2048, 1024 * 1024, 512), PartitionType::PRIMARY);
+    sda1->create_blk_filesystem(FsType::EXT4);
+
+    Devicegraph* rhs = storage.copy_devicegraph("lhs", "rhs");
+
+    Disk::find_by_name(rhs, "/dev/sda")->remove_descendants();
+
+    Actiongraph previous(storage, lhs, rhs);
+
+    // adding devices to rhs changes the sid indexes of the devices only
+    // in lhs, e.g. the deleted partition table
+
+    create_partition_with_mount_point(rhs, "/dev/sdb", FsType::XFS, "/srv");
+    create_partition_with_mount_point(rhs, "/dev/sdb", FsType::XFS, "/home");
+
+    Actiongraph incremental(storage, lhs, rhs, previous);
+
+    // the actions for sda are not calculated again
+
+    for (const Action::Base* action : previous.get_commit_actions())
+	BOOST_CHECK(contains_action(incremental, action));
+
+    Actiongraph full(storage, lhs, rhs);
+
+    BOOST_CHECK_EQUAL(incremental.num_actions(), full.num_actions());
+    BOOST_CHECK(actions(incremental) == actions(full));
+    BOOST_CHECK(dependencies(incremental) == dependencies(full));
+}
+
+
+BOOST_AUTO_TEST_CASE(incremental_actiongraph_fallback)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* lhs = storage.create_devicegraph("lhs");
+
+    Disk::create(lhs, "/dev/sda", Region(0, 100000000, 512));
+    Disk::create(lhs, "/dev/sdb", Region(0, 100000000, 512));
+
+    Devicegraph* rhs = storage.copy_devicegraph("lhs", "rhs");
+
+    create_partition_with_mount_point(rhs, "/dev/sda", FsType::EXT4, "/");
+
+    Actiongraph previous(storage, lhs, rhs);
+
+    // the mount of the root filesystem is affected so nothing is reused
+
+    create_partition_with_mount_point(rhs, "/dev/sda", FsType::EXT4, "/home");
+
+    Actiongraph incremental1(storage, lhs, rhs, previous);
+
+    for (const Action::Base* action : incremental1.get_commit_actions())
+	BOOST_CHECK(!contains_action(previous, action));
+
+    // the actions on sda are reused for a modification of sdb
+
+    create_partition_with_mount_point(rhs, "/dev/sdb", FsType::EXT4, "/srv");
+
+    Actiongraph incremental2(storage, lhs, rhs, incremental1);
+
+    for (const Action::Base* action : incremental1.get_commit_actions())
+	BOOST_CHECK(contains_action(incremental2, action));
+
+    // nothing is reused after lhs changed
+
+    Disk::find_by_name(lhs, "/dev/sdb")->set_userdata({ { "key", "value" } });
+
+    Actiongraph incremental3(storage, lhs, rhs, incremental2);
+
+    for (const Action::Base* action : incremental3.get_commit_actions())
+	BOOST_CHECK(!contains_action(incremental2, action));
+
+    BOOST_CHECK(actions(incremental3) == actions(Actiongraph(storage, lhs, rhs)));
+}
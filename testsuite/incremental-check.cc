@@ -0,0 +1,174 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Utils/HumanString.h"
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/LvmVg.h"
+#include "storage/Devices/LvmLv.h"
+#include "storage/Holders/User.h"
+#include "storage/Environment.h"
+#include "storage/Storage.h"
+#include "storage/StorageImpl.h"
+#include "storage/DevicegraphImpl.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+class CheckCallbacksRecorder : public CheckCallbacks
+{
+public:
+
+    CheckCallbacksRecorder(vector<string>& messages) : messages(messages) { messages.clear(); }
+
+    virtual void error(const string& message) const override;
+
+    vector<string>& messages;
+
+};
+
+
+void
+CheckCallbacksRecorder::error(const string& message) const
+{
+    messages.push_back(message);
+}
+
+
+BOOST_AUTO_TEST_CASE(incremental_check)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* staging = storage.get_staging();
+
+    Disk* sda = Disk::create(staging, "/dev/sda", 20 * TiB);
+
+    LvmVg* lvm_vg = LvmVg::create(staging, "test");
+    lvm_vg->add_lvm_pv(sda);
+
+    LvmLv* thin_pool = lvm_vg->create_lvm_lv("thin-pool", LvType::THIN_POOL, 16 * TiB);
+    thin_pool->set_chunk_size(64 * KiB);
+
+    vector<string> messages;
+    CheckCallbacksRecorder check_callbacks_recorder(messages);
+
+    // everything is new so the thin pool is checked
+
+    staging->get_impl().check_incremental(&check_callbacks_recorder);
+    BOOST_CHECK_EQUAL(messages.size(), 1);
+
+    // nothing changed since the last check
+
+    messages.clear();
+    staging->get_impl().check_incremental(&check_callbacks_recorder);
+    BOOST_CHECK(messages.empty());
+
+    // the full check checks everything
+
+    messages.clear();
+    staging->check(&check_callbacks_recorder);
+    BOOST_CHECK_EQUAL(messages.size(), 1);
+
+    // a new logical volume touches the volume group and so its other
+    // children are checked again
+
+    lvm_vg->create_lvm_lv("normal", LvType::NORMAL, 1 * TiB);
+
+    messages.clear();
+    storage.get_impl().check_incremental(&check_callbacks_recorder);
+    BOOST_CHECK_EQUAL(messages.size(), 1);
+
+    // a new holder closing a cycle
+
+    User::create(staging, thin_pool, sda);
+
+    BOOST_CHECK_THROW(staging->get_impl().check_incremental(nullptr), Exception);
+    BOOST_CHECK_THROW(staging->check(nullptr), Exception);
+}
+
+
+BOOST_AUTO_TEST_CASE(incremental_check_after_attribute_change)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* staging = storage.get_staging();
+
+    Disk* sda = Disk::create(staging, "/dev/sda", 20 * TiB);
+
+    LvmVg* lvm_vg = LvmVg::create(staging, "test");
+    lvm_vg->add_lvm_pv(sda);
+
+    LvmLv* lvm_lv = lvm_vg->create_lvm_lv("normal", LvType::NORMAL, 1 * TiB);
+
+    vector<string> messages;
+    CheckCallbacksRecorder check_callbacks_recorder(messages);
+
+    staging->get_impl().check_incremental(&check_callbacks_recorder);
+    BOOST_CHECK(messages.empty());
+
+    // only the size of the logical volume changes but the volume group
+    // is checked again and is now overcommitted
+
+    lvm_lv->set_size(30 * TiB);
+
+    BOOST_CHECK(!staging->get_impl().get_unchecked_sids().empty());
+
+    staging->get_impl().check_incremental(&check_callbacks_recorder);
+    BOOST_CHECK_EQUAL(messages.size(), 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(incremental_check_order)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* staging = storage.get_staging();
+
+    Disk* sdz = Disk::create(staging, "/dev/sdz", 1 * TiB);
+
+    vector<LvmLv*> lvm_lvs;
+
+    for (const string name : { "a", "b", "c", "d" })
+    {
+	Disk* disk = Disk::create(staging, "/dev/sd" + name, 1 * TiB);
+
+	LvmVg* lvm_vg = LvmVg::create(staging, name);
+	lvm_vg->add_lvm_pv(disk);
+
+	lvm_lvs.push_back(lvm_vg->create_lvm_lv("normal", LvType::NORMAL, 512 * GiB));
+    }
+
+    // removing a device moves the last device to a lower vertex index
+
+    staging->remove_device(sdz);
+
+    vector<string> messages;
+    CheckCallbacksRecorder check_callbacks_recorder(messages);
+
+    staging->get_impl().check_incremental(&check_callbacks_recorder);
+    BOOST_CHECK(messages.empty());
+
+    // all volume groups are overcommitted, the messages of the
+    // incremental check come in the same order as those of the full check
+
+    for (vector<LvmLv*>::reverse_iterator it = lvm_lvs.rbegin(); it != lvm_lvs.rend(); ++it)
+	(*it)->set_size(2 * TiB);
+
+    staging->get_impl().check_incremental(&check_callbacks_recorder);
+    BOOST_CHECK_EQUAL(messages.size(), 4);
+
+    vector<string> full_messages;
+    CheckCallbacksRecorder full_check_callbacks_recorder(full_messages);
+
+    staging->check(&full_check_callbacks_recorder);
+    BOOST_CHECK(messages == full_messages);
+}
@@ -7,10 +7,13 @@
 #include "storage/Devices/Disk.h"
 #include "storage/Devices/LvmVg.h"
 #include "storage/Devices/LvmLvImpl.h"
+#include "storage/Devices/DeviceImpl.h"
 #include "storage/Utils/HumanString.h"
 #include "storage/Devicegraph.h"
 #include "storage/Storage.h"
 #include "storage/Environment.h"
+#include "storage/ActiongraphImpl.h"
+#include "storage/Action.h"
 
 
 using namespace std;
@@ -113,6 +116,66 @@ BOOST_AUTO_TEST_CASE(lvm_vg_overcommitted)
 }
 
 
+BOOST_AUTO_TEST_CASE(lvm_lv_resize_dependencies)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* lhs = storage.create_devicegraph("lhs");
+
+    Disk* sda = Disk::create(lhs, "/dev/sda", 1 * TiB);
+
+    LvmVg* lvm_vg = LvmVg::create(lhs, "test");
+    lvm_vg->add_lvm_pv(sda);
+
+    vector<sid_t> sids;
+    for (int i = 0; i < 8; ++i)
+	sids.push_back(lvm_vg->create_lvm_lv("normal" + to_string(i), LvType::NORMAL, 10 * GiB)->get_sid());
+
+    Devicegraph* rhs = storage.copy_devicegraph("lhs", "rhs");
+
+    // shrink the first half of the logical volumes and grow the second half
+
+    for (int i = 0; i < 8; ++i)
+	to_lvm_lv(rhs->find_device(sids[i]))->set_size(i < 4 ? 5 * GiB : 20 * GiB);
+
+    Actiongraph actiongraph(storage, lhs, rhs);
+
+    const Actiongraph::Impl& impl = actiongraph.get_impl();
+
+    BOOST_CHECK_EQUAL(actiongraph.num_actions(), 8);
+
+    // the groups are linked by a barrier instead of 4 * 4 edges
+
+    size_t num_barriers = 0;
+    size_t num_edges = 0;
+
+    for (Actiongraph::Impl::vertex_descriptor vertex : impl.vertices())
+    {
+	if (is_barrier(impl[vertex]))
+	    ++num_barriers;
+
+	num_edges += boost::size(impl.children(vertex));
+    }
+
+    BOOST_CHECK_EQUAL(num_barriers, 1);
+    BOOST_CHECK_EQUAL(num_edges, 8);
+
+    // all shrink actions are before all grow actions
+
+    const vector<const Action::Base*> commit_actions = actiongraph.get_commit_actions();
+    BOOST_REQUIRE_EQUAL(commit_actions.size(), 8);
+
+    for (size_t i = 0; i < commit_actions.size(); ++i)
+    {
+	const Action::Resize* resize = dynamic_cast<const Action::Resize*>(commit_actions[i]);
+	BOOST_REQUIRE(resize);
+	BOOST_CHECK(resize->resize_mode == (i < 4 ? ResizeMode::SHRINK : ResizeMode::GROW));
+    }
+}
+
+
 class CheckCallbacksRecorder : public CheckCallbacks
 {
 public:
@@ -0,0 +1,78 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Utils/HumanString.h"
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/Gpt.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Filesystems/BlkFilesystem.h"
+#include "storage/Devicegraph.h"
+#include "storage/DeviceQuery.h"
+#include "storage/Environment.h"
+#include "storage/Storage.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(memory_usage)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* staging = storage.get_staging();
+
+    MemoryUsage empty = staging->memory_usage();
+
+    BOOST_CHECK(empty.devices.empty());
+    BOOST_CHECK(empty.holders.empty());
+
+    Disk* sda = Disk::create(staging, "/dev/sda", 16 * GiB);
+    Gpt* gpt = to_gpt(sda->create_partition_table(PtType::GPT));
+    Partition* sda1 = gpt->create_partition("/dev/sda1", Region(2048, 1000000, 512), PartitionType::PRIMARY);
+    BlkFilesystem* ext4 = sda1->create_blk_filesystem(FsType::EXT4);
+    ext4->set_uuid("1c7c3b60-1a5f-4f55-8c16-1d5a8f8c0bc3");
+
+    MemoryUsage one = staging->memory_usage();
+
+    BOOST_CHECK(one.devices["Disk"] > 0);
+    BOOST_CHECK(one.devices["Gpt"] > 0);
+    BOOST_CHECK(one.devices["Partition"] > 0);
+    BOOST_CHECK(one.devices["Ext4"] > 0);
+    BOOST_CHECK(one.holders["User"] > 0);
+    BOOST_CHECK(one.holders["Subdevice"] > 0);
+
+    BOOST_CHECK(one.graph > empty.graph);
+    BOOST_CHECK(one.strings > 0);
+    BOOST_CHECK_EQUAL(one.userdata, 0);
+
+    BOOST_CHECK_EQUAL(one.get_total(), one.get_devices_total() + one.get_holders_total() +
+		      one.graph + one.userdata + one.strings);
+
+    sda->set_userdata({ { "some-key", string(1000, 'x') } });
+
+    MemoryUsage two = staging->memory_usage();
+
+    BOOST_CHECK(two.userdata >= 1000);
+
+    // the indexes built by queries are included
+
+    staging->query(DeviceQuery().set_min_size(1 * GiB));
+
+    MemoryUsage three = staging->memory_usage();
+
+    BOOST_CHECK(three.graph > two.graph);
+
+    // the total of storage includes the probed devicegraph and copies
+
+    storage.copy_devicegraph("staging", "backup");
+
+    MemoryUsage all = storage.memory_usage();
+
+    BOOST_CHECK(all.get_total() > two.get_total());
+    BOOST_CHECK_EQUAL(all.devices["Disk"], 2 * two.devices["Disk"]);
+}
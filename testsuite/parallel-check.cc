@@ -0,0 +1,76 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include <stdlib.h>
+
+#include "storage/Utils/HumanString.h"
+#include "storage/Devices/Dasd.h"
+#include "storage/Filesystems/BlkFilesystem.h"
+#include "storage/Devicegraph.h"
+#include "storage/UsedFeatures.h"
+#include "storage/Environment.h"
+#include "storage/Storage.h"
+#include "storage/StorageImpl.h"
+#include "storage/DevicegraphImpl.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+class CheckCallbacksRecorder : public CheckCallbacks
+{
+public:
+
+    CheckCallbacksRecorder(vector<string>& messages) : messages(messages) { messages.clear(); }
+
+    virtual void error(const string& message) const override;
+
+    vector<string>& messages;
+
+};
+
+
+void
+CheckCallbacksRecorder::error(const string& message) const
+{
+    messages.push_back(message);
+}
+
+
+BOOST_AUTO_TEST_CASE(parallel_check)
+{
+    setenv("LIBSTORAGE_THREADS", "4", 1);
+
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* staging = storage.get_staging();
+
+    // DASDs used without a partition table produce a check error each
+
+    const unsigned int n = 1500;
+
+    for (unsigned int i = 0; i < n; ++i)
+    {
+	Dasd* dasd = Dasd::create(staging, "/dev/dasd" + to_string(i), 1 * GiB);
+	dasd->create_blk_filesystem(FsType::EXT4);
+    }
+
+    vector<string> messages;
+    CheckCallbacksRecorder check_callbacks_recorder(messages);
+
+    staging->check(&check_callbacks_recorder);
+
+    // messages are reported in the same order as in a serial check
+
+    BOOST_REQUIRE_EQUAL(messages.size(), n);
+
+    for (unsigned int i = 0; i < n; ++i)
+	BOOST_CHECK_EQUAL(messages[i], "DASD /dev/dasd" + to_string(i) + " used without a partition table.");
+
+    BOOST_CHECK(staging->used_features() & UF_EXT4);
+}
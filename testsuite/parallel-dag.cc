@@ -0,0 +1,204 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include <unistd.h>
+#include <algorithm>
+#include <map>
+
+#include "storage/Utils/Parallel.h"
+#include "storage/Utils/Exception.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(order_with_one_thread)
+{
+    // 0 -> 2, 1 -> 2, 2 -> 3
+
+    const vector<vector<size_t>> successors = { { 2 }, { 2 }, { 3 }, { } };
+
+    vector<size_t> done;
+
+    parallel_for_dag(successors, {}, {}, {}, 1, [&done](size_t task) { done.push_back(task); });
+
+    BOOST_CHECK(done == vector<size_t>({ 0, 1, 2, 3 }));
+}
+
+
+BOOST_AUTO_TEST_CASE(order_with_priorities)
+{
+    // 0 -> 3, 1 -> 3, 2 -> 3, the ready task with the highest priority runs first
+
+    const vector<vector<size_t>> successors = { { 3 }, { 3 }, { 3 }, { } };
+    const vector<double> priorities = { 1.0, 3.0, 1.0, 0.0 };
+
+    vector<size_t> done;
+
+    parallel_for_dag(successors, {}, {}, priorities, 1, [&done](size_t task) { done.push_back(task); });
+
+    BOOST_CHECK(done == vector<size_t>({ 1, 0, 2, 3 }));
+}
+
+
+BOOST_AUTO_TEST_CASE(dependencies_and_exclusive_keys)
+{
+    // a diamond repeated three times, the tasks have the keys 1, 2 or
+    // both
+
+    vector<vector<size_t>> successors;
+    vector<vector<size_t>> exclusive_keys;
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+	size_t base = successors.size();
+	successors.push_back({ base + 1, base + 2 });
+	successors.push_back({ base + 3 });
+	successors.push_back({ base + 3 });
+	successors.push_back({ });
+    }
+
+    for (size_t task = 0; task < successors.size(); ++task)
+    {
+	switch (task % 3)
+	{
+	    case 0: exclusive_keys.push_back({ 1 }); break;
+	    case 1: exclusive_keys.push_back({ 2 }); break;
+	    case 2: exclusive_keys.push_back({ 1, 2 }); break;
+	}
+    }
+
+    vector<bool> done(successors.size(), false);
+    map<size_t, unsigned int> running_with_key;
+    map<size_t, unsigned int> max_running_with_key;
+    bool dependencies_ok = true;
+
+    parallel_for_dag(successors, exclusive_keys, {}, {}, 4, [&](size_t task) {
+
+	for (size_t predecessor = 0; predecessor < successors.size(); ++predecessor)
+	    for (size_t successor : successors[predecessor])
+		if (successor == task && !done[predecessor])
+		    dependencies_ok = false;
+
+	for (size_t key : exclusive_keys[task])
+	    max_running_with_key[key] = max(max_running_with_key[key], ++running_with_key[key]);
+
+	{
+	    BlockingCall blocking_call;
+	    usleep(10000);
+	}
+
+	for (size_t key : exclusive_keys[task])
+	    --running_with_key[key];
+
+	done[task] = true;
+
+    });
+
+    BOOST_CHECK(dependencies_ok);
+    BOOST_CHECK_EQUAL(max_running_with_key[1], 1);
+    BOOST_CHECK_EQUAL(max_running_with_key[2], 1);
+    BOOST_CHECK(find(done.begin(), done.end(), false) == done.end());
+}
+
+
+BOOST_AUTO_TEST_CASE(shared_keys)
+{
+    // independent tasks, every fourth task has key 1 as exclusive key,
+    // the others as shared key
+
+    const vector<vector<size_t>> successors(12);
+
+    vector<vector<size_t>> exclusive_keys;
+    vector<vector<size_t>> shared_keys;
+
+    for (size_t task = 0; task < successors.size(); ++task)
+    {
+	exclusive_keys.push_back(task % 4 == 0 ? vector<size_t>({ 1 }) : vector<size_t>());
+	shared_keys.push_back(task % 4 == 0 ? vector<size_t>() : vector<size_t>({ 1 }));
+    }
+
+    unsigned int running_exclusive = 0;
+    unsigned int running_shared = 0;
+    unsigned int max_running_shared = 0;
+    bool exclusive_ok = true;
+
+    parallel_for_dag(successors, exclusive_keys, shared_keys, {}, 4, [&](size_t task) {
+
+	bool exclusive = !exclusive_keys[task].empty();
+
+	if (exclusive)
+	    ++running_exclusive;
+	else
+	    max_running_shared = max(max_running_shared, ++running_shared);
+
+	if (running_exclusive > 1 || (running_exclusive > 0 && running_shared > 0))
+	    exclusive_ok = false;
+
+	{
+	    BlockingCall blocking_call;
+	    usleep(10000);
+	}
+
+	if (exclusive)
+	    --running_exclusive;
+	else
+	    --running_shared;
+
+    });
+
+    BOOST_CHECK(exclusive_ok);
+    BOOST_CHECK_GT(max_running_shared, 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(blocking_calls_run_in_parallel)
+{
+    const vector<vector<size_t>> successors(8);
+
+    unsigned int running = 0;
+    unsigned int max_running = 0;
+
+    parallel_for_dag(successors, {}, {}, {}, 4, [&](size_t task) {
+
+	max_running = max(max_running, ++running);
+
+	{
+	    BlockingCall blocking_call;
+	    usleep(50000);
+	}
+
+	--running;
+
+    });
+
+    BOOST_CHECK_GT(max_running, 1);
+    BOOST_CHECK_LE(max_running, 4);
+}
+
+
+BOOST_AUTO_TEST_CASE(exceptions)
+{
+    // 0 -> 1 -> 2 and 3 independent
+
+    const vector<vector<size_t>> successors = { { 1 }, { 2 }, { }, { } };
+
+    vector<size_t> done;
+
+    BOOST_CHECK_THROW(parallel_for_dag(successors, {}, {}, {}, 1, [&done](size_t task) {
+	if (task == 1)
+	    throw Exception("failed");
+	done.push_back(task);
+    }), Exception);
+
+    // task 2 depends on the failed task and task 3 was not started
+
+    BOOST_CHECK(done == vector<size_t>({ 0 }));
+
+    // cycles are detected
+
+    BOOST_CHECK_THROW(parallel_for_dag({ { 1 }, { 0 } }, {}, {}, {}, 2, [](size_t task) {}), Exception);
+}
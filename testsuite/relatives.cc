@@ -17,7 +17,11 @@
 #include "storage/Holders/Subdevice.h"
 #include "storage/Environment.h"
 #include "storage/Storage.h"
-#include "storage/Devicegraph.h"
+#include "storage/Devices/DiskImpl.h"
+#include "storage/Devices/GptImpl.h"
+#include "storage/Devices/LvmVgImpl.h"
+#include "storage/Devices/LvmLvImpl.h"
+#include "storage/DevicegraphImpl.h"
 
 
 using namespace std;
@@ -113,3 +117,91 @@ BOOST_AUTO_TEST_CASE(dependencies)
     BOOST_CHECK_EQUAL(sort(sda1->get_roots(false)), sort({ sda }));
     BOOST_CHECK_EQUAL(sort(system_swap->get_roots(false)), sort({ sda, sdb }));
 }
+
+
+BOOST_AUTO_TEST_CASE(children_and_parents_of_type)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda");
+
+    Gpt* gpt = Gpt::create(devicegraph);
+    User::create(devicegraph, sda, gpt);
+
+    Partition* sda1 = Partition::create(devicegraph, "/dev/sda1", Region(0, 10, 512), PartitionType::PRIMARY);
+    Subdevice::create(devicegraph, gpt, sda1);
+
+    Partition* sda2 = Partition::create(devicegraph, "/dev/sda2", Region(10, 10, 512), PartitionType::PRIMARY);
+    Subdevice::create(devicegraph, gpt, sda2);
+
+    LvmVg* system = LvmVg::create(devicegraph, "system");
+    User::create(devicegraph, sda1, system);
+
+    const Devicegraph::Impl& devicegraph_impl = devicegraph->get_impl();
+
+    vector<Device*> partitions;
+    for (const Partition* partition : devicegraph_impl.children_of_type<const Partition>(gpt->get_impl().get_vertex()))
+	partitions.push_back(const_cast<Partition*>(partition));
+
+    BOOST_CHECK_EQUAL(sort(partitions), sort({ sda1, sda2 }));
+
+    BOOST_CHECK(boost::empty(devicegraph_impl.children_of_type<const LvmVg>(gpt->get_impl().get_vertex())));
+
+    BOOST_CHECK_EQUAL(boost::distance(devicegraph_impl.parents_of_type<const Partition>(system->get_impl().get_vertex())), 1);
+    BOOST_CHECK_EQUAL(*devicegraph_impl.parents_of_type<Partition>(system->get_impl().get_vertex()).begin(), sda1);
+
+    BOOST_CHECK_EQUAL(gpt->get_impl().num_children_of_type<const Partition>(), 2);
+}
+
+
+BOOST_AUTO_TEST_CASE(cached_relatives_after_modifications)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda");
+
+    Gpt* gpt = Gpt::create(devicegraph);
+    User::create(devicegraph, sda, gpt);
+
+    Partition* sda1 = Partition::create(devicegraph, "/dev/sda1", Region(0, 10, 512), PartitionType::PRIMARY);
+    Subdevice::create(devicegraph, gpt, sda1);
+
+    LvmVg* system = LvmVg::create(devicegraph, "system");
+    User::create(devicegraph, sda1, system);
+
+    LvmLv* system_root = system->create_lvm_lv("root", LvType::NORMAL, 4 * GiB);
+
+    const Devicegraph::Impl& devicegraph_impl = devicegraph->get_impl();
+
+    BOOST_CHECK_EQUAL(sort(sda->get_descendants(false)), sort({ gpt, sda1, system, system_root }));
+    BOOST_CHECK_EQUAL(sort(system_root->get_ancestors(false)), sort({ system, sda1, gpt, sda }));
+
+    BOOST_CHECK(devicegraph_impl.is_descendant(sda->get_impl().get_vertex(), system_root->get_impl().get_vertex(), false));
+    BOOST_CHECK(!devicegraph_impl.is_descendant(system_root->get_impl().get_vertex(), sda->get_impl().get_vertex(), false));
+    BOOST_CHECK(devicegraph_impl.is_descendant(sda->get_impl().get_vertex(), sda->get_impl().get_vertex(), true));
+    BOOST_CHECK(!devicegraph_impl.is_descendant(sda->get_impl().get_vertex(), sda->get_impl().get_vertex(), false));
+
+    // the cached relatives must be updated after modifications
+
+    LvmLv* system_swap = system->create_lvm_lv("swap", LvType::NORMAL, 1 * GiB);
+
+    BOOST_CHECK_EQUAL(sort(sda->get_descendants(false)), sort({ gpt, sda1, system, system_root, system_swap }));
+    BOOST_CHECK_EQUAL(sort(sda->get_leaves(false)), sort({ system_root, system_swap }));
+    BOOST_CHECK(devicegraph_impl.is_descendant(sda->get_impl().get_vertex(), system_swap->get_impl().get_vertex(), false));
+
+    system->remove_descendants();
+
+    BOOST_CHECK_EQUAL(sort(sda->get_descendants(false)), sort({ gpt, sda1, system }));
+    BOOST_CHECK_EQUAL(sort(sda->get_leaves(false)), sort({ system }));
+    BOOST_CHECK_EQUAL(sort(system->get_roots(false)), sort({ sda }));
+
+    devicegraph->check();
+}
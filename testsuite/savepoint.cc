@@ -0,0 +1,182 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Utils/HumanString.h"
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/Gpt.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Filesystems/BlkFilesystem.h"
+#include "storage/Devicegraph.h"
+#include "storage/Environment.h"
+#include "storage/Storage.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+class Fixture
+{
+public:
+
+    Fixture()
+	: environment(true, ProbeMode::NONE, TargetMode::DIRECT), storage(environment)
+    {
+	staging = storage.get_staging();
+
+	sda = Disk::create(staging, "/dev/sda", 16 * GiB);
+	gpt = to_gpt(sda->create_partition_table(PtType::GPT));
+
+	sda1 = gpt->create_partition("/dev/sda1", Region(2048, 1000000, 512), PartitionType::PRIMARY);
+	ext4 = sda1->create_blk_filesystem(FsType::EXT4);
+	ext4->set_label("old");
+
+	storage.copy_devicegraph("staging", "before");
+    }
+
+    bool unchanged() const
+    {
+	return *storage.get_devicegraph("before") == *staging;
+    }
+
+    Environment environment;
+    Storage storage;
+
+    Devicegraph* staging;
+
+    Disk* sda;
+    Gpt* gpt;
+    Partition* sda1;
+    BlkFilesystem* ext4;
+
+};
+
+
+BOOST_FIXTURE_TEST_CASE(rollback, Fixture)
+{
+    unsigned int savepoint = staging->begin_savepoint();
+
+    ext4->set_label("new");
+    sda1->set_size(256 * MiB);
+
+    Partition* sda2 = gpt->create_partition("/dev/sda2", Region(2000000, 1000000, 512), PartitionType::PRIMARY);
+    sda2->create_blk_filesystem(FsType::XFS);
+
+    gpt->delete_partition(sda1);
+
+    BOOST_CHECK(!unchanged());
+
+    staging->rollback_to(savepoint);
+
+    BOOST_CHECK(unchanged());
+
+    // the removed and modified devices are the same objects as before
+
+    BOOST_CHECK_EQUAL(staging->find_device(sda1->get_sid()), sda1);
+    BOOST_CHECK_EQUAL(sda1->get_size(), 1000000 * 512);
+    BOOST_CHECK_EQUAL(sda1->get_blk_filesystem(), ext4);
+    BOOST_CHECK_EQUAL(ext4->get_label(), "old");
+
+    BOOST_CHECK_EQUAL(BlkDevice::find_by_name(staging, "/dev/sda1"), sda1);
+    BOOST_CHECK_THROW(BlkDevice::find_by_name(staging, "/dev/sda2"), DeviceNotFoundByName);
+
+    BOOST_CHECK_EQUAL(gpt->get_partitions().size(), 1);
+
+    // the savepoint stays active
+
+    ext4->set_label("new");
+
+    staging->rollback_to(savepoint);
+
+    BOOST_CHECK_EQUAL(ext4->get_label(), "old");
+    BOOST_CHECK(unchanged());
+}
+
+
+BOOST_FIXTURE_TEST_CASE(rollback_removed_device_and_holder, Fixture)
+{
+    unsigned int savepoint = staging->begin_savepoint();
+
+    // removes the filesystem, and with it its holder, and the holder
+    // between the partition table and the partition
+
+    sda1->remove_descendants();
+    staging->remove_holder(staging->find_holder(gpt->get_sid(), sda1->get_sid()));
+
+    BOOST_CHECK(!unchanged());
+
+    staging->rollback_to(savepoint);
+
+    BOOST_CHECK(unchanged());
+
+    BOOST_CHECK_EQUAL(staging->find_device(ext4->get_sid()), ext4);
+    BOOST_CHECK_EQUAL(sda1->get_blk_filesystem(), ext4);
+    BOOST_CHECK_EQUAL(sda1->get_partition_table(), gpt);
+
+    staging->check();
+
+    // the restored devices and holders can be modified and rolled back
+    // again
+
+    ext4->set_label("new");
+    gpt->delete_partition(sda1);
+
+    staging->rollback_to(savepoint);
+
+    BOOST_CHECK(unchanged());
+    BOOST_CHECK_EQUAL(ext4->get_label(), "old");
+
+    staging->check();
+}
+
+
+BOOST_FIXTURE_TEST_CASE(nested_savepoints, Fixture)
+{
+    unsigned int outer = staging->begin_savepoint();
+
+    ext4->set_label("outer");
+
+    unsigned int inner = staging->begin_savepoint();
+
+    ext4->set_label("inner");
+    gpt->create_partition("/dev/sda2", Region(2000000, 1000000, 512), PartitionType::PRIMARY);
+
+    staging->rollback_to(inner);
+
+    BOOST_CHECK_EQUAL(ext4->get_label(), "outer");
+    BOOST_CHECK_EQUAL(gpt->get_partitions().size(), 1);
+
+    // after releasing the inner savepoint its changes belong to the outer
+    // savepoint
+
+    inner = staging->begin_savepoint();
+
+    ext4->set_label("inner");
+    gpt->create_partition("/dev/sda2", Region(2000000, 1000000, 512), PartitionType::PRIMARY);
+
+    staging->release(inner);
+
+    BOOST_CHECK_THROW(staging->rollback_to(inner), Exception);
+
+    staging->rollback_to(outer);
+
+    BOOST_CHECK(unchanged());
+}
+
+
+BOOST_FIXTURE_TEST_CASE(release, Fixture)
+{
+    unsigned int savepoint = staging->begin_savepoint();
+
+    ext4->set_label("new");
+    gpt->delete_partition(sda1);
+
+    staging->release(savepoint);
+
+    BOOST_CHECK_THROW(staging->rollback_to(savepoint), Exception);
+
+    BOOST_CHECK_EQUAL(gpt->get_partitions().size(), 0);
+    BOOST_CHECK(!unchanged());
+}
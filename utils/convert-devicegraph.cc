@@ -0,0 +1,66 @@
+
+#include <iostream>
+#include <boost/algorithm/string.hpp>
+
+#include "storage/Storage.h"
+#include "storage/Environment.h"
+#include "storage/Devicegraph.h"
+#include "storage/DevicegraphImage.h"
+#include "storage/Utils/Logger.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+void
+doit(const string& filename_in, const string& filename_out)
+{
+    set_logger(get_logfile_logger());
+
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    // the format of the input is detected from its content, the format
+    // of the output is selected by the extension (".bin" for binary,
+    // ".img" for a read-only image)
+
+    Devicegraph* devicegraph = storage.create_devicegraph("convert");
+    devicegraph->load(filename_in);
+
+    if (boost::ends_with(filename_out, ".img"))
+	DevicegraphImage::write(devicegraph, filename_out);
+    else
+	devicegraph->save(filename_out);
+}
+
+
+void usage() __attribute__ ((__noreturn__));
+
+void
+usage()
+{
+    cerr << "convert-devicegraph input-filename output-filename\n";
+    exit(EXIT_FAILURE);
+}
+
+
+int
+main(int argc, char **argv)
+{
+    if (argc != 3)
+	usage();
+
+    try
+    {
+	doit(argv[1], argv[2]);
+    }
+    catch (const exception& e)
+    {
+	cerr << "exception occured: " << e.what() << '\n';
+	exit(EXIT_FAILURE);
+    }
+
+    exit(EXIT_SUCCESS);
+}